@@ -11,6 +11,115 @@
 #include <common/debug.h>
 #include <common/tf_crc32.h>
 
+/* Reflected CRC-32 polynomial */
+#define CRC32_POLY_LE		0xedb88320U
+
+/*
+ * Large buffers are processed in chunks of three lanes of CRC32_LANE_SIZE
+ * bytes. The CRC of each lane is computed independently so that the CRC
+ * instructions of the three lanes can be pipelined. The lane CRCs are then
+ * merged using x^(8 * CRC32_LANE_SIZE) and x^(16 * CRC32_LANE_SIZE) mod P.
+ */
+#define CRC32_LANE_SIZE		8192U
+#define CRC32_LANE_WORDS	(CRC32_LANE_SIZE / sizeof(uint64_t))
+#define CRC32_LANE_SHIFT1	0x83852d0fU
+#define CRC32_LANE_SHIFT2	0x30362f1aU
+
+/* a(x) * b(x) mod P, with the polynomials bit-reflected. @a must not be 0 */
+static uint32_t crc32_multmodp(uint32_t a, uint32_t b)
+{
+	uint32_t m = 1U << 31, p = 0;
+
+	for (;;) {
+		if ((a & m) != 0U) {
+			p ^= b;
+			if ((a & (m - 1U)) == 0U)
+				break;
+		}
+
+		m >>= 1;
+		b = ((b & 1U) != 0U) ? (b >> 1) ^ CRC32_POLY_LE : b >> 1;
+	}
+
+	return p;
+}
+
+static uint32_t crc32_lanes(uint32_t crc, const uint64_t *p, size_t chunks)
+{
+	uint32_t crc1, crc2;
+	size_t i;
+
+	while (chunks != 0UL) {
+		crc1 = 0;
+		crc2 = 0;
+
+		for (i = 0; i < CRC32_LANE_WORDS; i++) {
+			crc = __crc32d(crc, p[i]);
+			crc1 = __crc32d(crc1, p[i + CRC32_LANE_WORDS]);
+			crc2 = __crc32d(crc2, p[i + 2 * CRC32_LANE_WORDS]);
+		}
+
+		crc = crc32_multmodp(CRC32_LANE_SHIFT2, crc) ^
+		      crc32_multmodp(CRC32_LANE_SHIFT1, crc1) ^ crc2;
+
+		p += 3 * CRC32_LANE_WORDS;
+		chunks--;
+	}
+
+	return crc;
+}
+
+/* compute CRC without pre- and post-inversion using Arm intrinsic function
+ *
+ * Up to 8-byte alignment, and for the trailing bytes the data is processed
+ * bytewise. The rest is processed in 64-bit words, interleaved in three lanes
+ * for buffers of at least 3 * CRC32_LANE_SIZE bytes.
+ *
+ * @crc: previous accumulated CRC
+ * @buf: buffer base address
+ * @size: the size of the buffer
+ *
+ * Return calculated CRC value
+ */
+uint32_t tf_crc32_no_comp(uint32_t crc, const unsigned char *buf, size_t size)
+{
+	const uint64_t *words;
+	size_t chunks, n;
+
+	assert(buf != NULL);
+
+	while ((size != 0UL) && (((uintptr_t)buf & 7UL) != 0UL)) {
+		crc = __crc32b(crc, *buf);
+		buf++;
+		size--;
+	}
+
+	words = (const uint64_t *)buf;
+
+	chunks = size / (3 * CRC32_LANE_SIZE);
+	if (chunks != 0UL) {
+		crc = crc32_lanes(crc, words, chunks);
+		words += chunks * 3 * CRC32_LANE_WORDS;
+		size -= chunks * 3 * CRC32_LANE_SIZE;
+	}
+
+	for (n = size / sizeof(uint64_t); n != 0UL; n--) {
+		crc = __crc32d(crc, *words);
+		words++;
+	}
+
+	buf = (const unsigned char *)words;
+	size &= sizeof(uint64_t) - 1U;
+
+	while (size != 0UL) {
+		crc = __crc32b(crc, *buf);
+		buf++;
+		size--;
+	}
+
+	return crc;
+}
+
 /* compute CRC using Arm intrinsic function
  *
  * This function is useful for the platforms with the CPU ARMv8.0
@@ -26,20 +135,5 @@
  */
 uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
 {
-	assert(buf != NULL);
-
-	uint32_t calc_crc = ~crc;
-	const unsigned char *local_buf = buf;
-	size_t local_size = size;
-
-	/*
-	 * calculate CRC over byte data
-	 */
-	while (local_size != 0UL) {
-		calc_crc = __crc32b(calc_crc, *local_buf);
-		local_buf++;
-		local_size--;
-	}
-
-	return ~calc_crc;
+	return ~tf_crc32_no_comp(~crc, buf, size);
 }
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -241,6 +242,16 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
  */
+static bool is_direct_read(const io_block_dev_spec_t *dev_spec,
+			   uintptr_t buffer, size_t skip, size_t left)
+{
+	size_t align = dev_spec->direct_read_align;
+
+	return (align != 0U) && (skip == 0U) &&
+	       ((buffer & (align - 1U)) == 0U) &&
+	       (left >= dev_spec->block_size);
+}
+
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
 {
@@ -296,6 +307,22 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (is_direct_read(cur->dev_spec, buffer + count, skip, left)) {
+			/*
+			 * Read whole blocks straight into the user buffer,
+			 * the remainder goes through the underlying buffer.
+			 */
+			request = left & ~(block_size - 1U);
+			nbytes = ops->read(lba, buffer + count, request);
+			if (nbytes == 0U) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
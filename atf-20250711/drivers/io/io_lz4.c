@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * IO driver decompressing an LZ4 frame while it is being read from the
+ * backend device, one block at a time. The decompressed data is written to
+ * the destination of io_read() directly.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/io/io_driver.h>
+#include <drivers/io/io_lz4.h>
+#include <drivers/io/io_storage.h>
+#include <tf_unlz4.h>
+
+/* Block header read along with the frame header, or the previous block */
+#define LZ4_FIRST_READ_LEN	(LZ4_FRAME_HDR_MAX_LEN + LZ4_BLOCK_HDR_LEN)
+
+static io_lz4_dev_spec_t lz4_dev_spec;
+static io_dev_info_t lz4_dev_info;
+
+static uintptr_t backend_handle;
+static size_t backend_remain;
+static struct lz4_frame_info frame;
+static uint32_t next_bsize;
+
+static int lz4_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
+static int lz4_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
+			 io_entity_t *entity);
+static int lz4_file_len(io_entity_t *entity, size_t *length);
+static int lz4_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+			 size_t *length_read);
+static int lz4_file_close(io_entity_t *entity);
+static int lz4_dev_close(io_dev_info_t *dev_info);
+
+static io_type_t device_type_lz4(void)
+{
+	return IO_TYPE_LZ4;
+}
+
+static const io_dev_connector_t lz4_dev_connector = {
+	.dev_open = lz4_dev_open
+};
+
+static const io_dev_funcs_t lz4_dev_funcs = {
+	.type = device_type_lz4,
+	.open = lz4_file_open,
+	.seek = NULL,
+	.size = lz4_file_len,
+	.read = lz4_file_read,
+	.write = NULL,
+	.close = lz4_file_close,
+	.dev_init = NULL,
+	.dev_close = lz4_dev_close,
+};
+
+/*
+ * io_lz4_check_frame - check whether an LZ4 frame can be streamed
+ * @hdr: start of the frame
+ * @len: length of @hdr
+ * @buffer_size: size of the buffer for compressed blocks
+ *
+ * The frame must carry the content size, which is reported as the length of
+ * the file, and its largest block must fit into the buffer along with the
+ * block checksum and the header of the next block.
+ */
+int io_lz4_check_frame(const void *hdr, size_t len, size_t buffer_size)
+{
+	struct lz4_frame_info info;
+	int ret;
+
+	ret = lz4_get_frame_info(hdr, len, &info);
+	if (ret != 0)
+		return ret;
+
+	if (!info.has_content_size || (info.content_size > SIZE_MAX))
+		return -ENOTSUP;
+
+	if (info.block_max + LZ4_CHECKSUM_LEN + LZ4_BLOCK_HDR_LEN > buffer_size)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static int lz4_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
+{
+	assert(dev_spec != 0);
+	assert(dev_info != NULL);
+
+	memcpy(&lz4_dev_spec, (void *)dev_spec, sizeof(lz4_dev_spec));
+
+	lz4_dev_info.funcs = &lz4_dev_funcs;
+	*dev_info = &lz4_dev_info;
+
+	return 0;
+}
+
+static int lz4_dev_close(io_dev_info_t *dev_info)
+{
+	io_dev_close(lz4_dev_spec.backend_dev);
+
+	lz4_dev_spec.backend_dev = (uintptr_t)NULL;
+
+	return 0;
+}
+
+static int lz4_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
+			 io_entity_t *entity)
+{
+	uint8_t *hdr = (uint8_t *)lz4_dev_spec.buffer;
+	size_t bytes_read;
+	int result;
+
+	assert(entity != NULL);
+
+	result = io_open(lz4_dev_spec.backend_dev, spec, &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open backend device (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = io_size(backend_handle, &backend_remain);
+	if ((result != 0) || (backend_remain < LZ4_FIRST_READ_LEN)) {
+		result = -ENOENT;
+		goto err;
+	}
+
+	result = io_read(backend_handle, (uintptr_t)hdr, LZ4_FIRST_READ_LEN,
+			 &bytes_read);
+	if ((result != 0) || (bytes_read != LZ4_FIRST_READ_LEN)) {
+		WARN("Failed to read LZ4 frame header (%i)\n", result);
+		result = -EIO;
+		goto err;
+	}
+
+	result = io_lz4_check_frame(hdr, LZ4_FIRST_READ_LEN,
+				    lz4_dev_spec.buffer_size);
+	if (result != 0) {
+		WARN("Unsupported LZ4 frame (%i)\n", result);
+		goto err;
+	}
+
+	(void)lz4_get_frame_info(hdr, LZ4_FIRST_READ_LEN, &frame);
+
+	/* io_lz4_check_frame() made sure the content size is present */
+	assert(frame.hdr_len == LZ4_FRAME_HDR_MAX_LEN);
+
+	next_bsize = lz4_get_le32(hdr + LZ4_FRAME_HDR_MAX_LEN);
+	backend_remain -= LZ4_FIRST_READ_LEN;
+
+	return 0;
+
+err:
+	io_close(backend_handle);
+	return result;
+}
+
+static int lz4_file_len(io_entity_t *entity, size_t *length)
+{
+	assert(entity != NULL);
+	assert(length != NULL);
+
+	*length = (size_t)frame.content_size;
+
+	return 0;
+}
+
+/*
+ * Read the next @len bytes of the frame. Each block is read along with its
+ * checksum and the header of the block following it.
+ */
+static int lz4_read_backend(uintptr_t dst, size_t len)
+{
+	size_t bytes_read;
+	int result;
+
+	if (len > backend_remain)
+		return -EIO;
+
+	result = io_read(backend_handle, dst, len, &bytes_read);
+	if ((result != 0) || (bytes_read != len))
+		return -EIO;
+
+	backend_remain -= len;
+
+	return 0;
+}
+
+static int lz4_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+			 size_t *length_read)
+{
+	const uint8_t *blk = (const uint8_t *)lz4_dev_spec.buffer, *next;
+	uint8_t *out_start = (uint8_t *)buffer, *op = out_start;
+	const uint8_t *out_end = out_start + length;
+	size_t len, trailer;
+	int result;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+
+	trailer = (frame.block_checksum ? LZ4_CHECKSUM_LEN : 0U) +
+		  LZ4_BLOCK_HDR_LEN;
+
+	/* The EndMark ends the frame, the content checksum is not used */
+	while (next_bsize != 0U) {
+		len = next_bsize & ~LZ4_BLOCK_UNCOMPRESSED;
+		if (len > frame.block_max) {
+			result = -EINVAL;
+			goto err;
+		}
+
+		if ((next_bsize & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			/* Stored blocks go to the destination directly */
+			if (len > (size_t)(out_end - op)) {
+				result = -ENOSPC;
+				goto err;
+			}
+
+			result = lz4_read_backend((uintptr_t)op, len);
+			if (result == 0)
+				result = lz4_read_backend((uintptr_t)blk,
+							  trailer);
+			if (result != 0)
+				goto err;
+
+			op += len;
+			next = blk + trailer;
+		} else {
+			result = lz4_read_backend((uintptr_t)blk,
+						  len + trailer);
+			if (result != 0)
+				goto err;
+
+			result = lz4_decode_block(blk, len, out_start, &op,
+						  out_end);
+			if (result != 0)
+				goto err;
+
+			next = blk + len + trailer;
+		}
+
+		next_bsize = lz4_get_le32(next - LZ4_BLOCK_HDR_LEN);
+	}
+
+	if ((uint64_t)(op - out_start) != frame.content_size) {
+		ERROR("lz4: content size mismatch\n");
+		return -EIO;
+	}
+
+	*length_read = op - out_start;
+
+	return 0;
+
+err:
+	ERROR("lz4: failed to decompress block (%i)\n", result);
+	return result;
+}
+
+static int lz4_file_close(io_entity_t *entity)
+{
+	io_close(backend_handle);
+
+	backend_handle = (uintptr_t)NULL;
+	entity->info = 0;
+
+	return 0;
+}
+
+/* Exported functions */
+
+/* Register the LZ4 decompression driver with the IO abstraction */
+int register_io_dev_lz4(const io_dev_connector_t **dev_con)
+{
+	int result;
+
+	assert(dev_con != NULL);
+
+	result = io_register_device(&lz4_dev_info);
+	if (result == 0)
+		*dev_con = &lz4_dev_connector;
+
+	return result;
+}
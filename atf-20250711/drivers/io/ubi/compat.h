@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <arm_acle.h>
+#include <common/tf_crc32.h>
 
 #define roundup(x, y) ({				\
 	const typeof(y) __y = y;			\
@@ -59,19 +60,7 @@ static inline int test_and_clear_bit(int nr, volatile void *addr)
 #if (ARM_ARCH_MAJOR > 7)
 static inline uint32_t ubi_crc32(uint32_t crc, const void *buf, size_t size)
 {
-	const uint8_t *local_buf = buf;
-	size_t local_size = size;
-
-	/*
-	 * calculate CRC over byte data
-	 */
-	while (local_size != 0UL) {
-		crc = __crc32b(crc, *local_buf);
-		local_buf++;
-		local_size--;
-	}
-
-	return crc;
+	return tf_crc32_no_comp(crc, buf, size);
 }
 #else
 uint32_t ubi_crc32(uint32_t crc, const void *buf, size_t size);
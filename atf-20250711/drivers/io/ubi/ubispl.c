@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <endian.h>
+#include <arch_helpers.h>
 #include <inttypes.h>
 
 #include "ubispl.h"
@@ -43,6 +44,8 @@ static int ubi_is_bad_peb(struct ubi_scan_info *ubi, uint32_t pnum)
 static int ubi_io_read(struct ubi_scan_info *ubi, void *buf, uint32_t pnum,
 		       unsigned long from, unsigned long len)
 {
+	ubi->read_count++;
+
 	return ubi->read(pnum + ubi->peb_offset, from, len, buf);
 }
 
@@ -645,6 +648,16 @@ static int ubi_attach_fastmap(struct ubi_scan_info *ubi,
 
 		reserved = be32toh(fm_eba->reserved_pebs);
 		ubi_dbg("FA: vol %u used %u res: %u", vol_id, used, reserved);
+
+		/*
+		 * Only static volumes we may load and the volume table are
+		 * of interest. Reading the VID headers of the other volumes
+		 * would cost as much as a full scan.
+		 */
+		if (vol_id != UBI_LAYOUT_VOLUME_ID &&
+		    (vol_id >= UBI_SPL_VOL_IDS || vol_type != UBI_STATIC_VOLUME))
+			continue;
+
 		for (j = 0; j < reserved; j++) {
 			int pnum = be32toh(fm_eba->pnum[j]);
 
@@ -1159,6 +1172,7 @@ static int ipl_load(struct ubi_scan_info *ubi, const uint32_t vol_id,
 void ubispl_init_scan(struct io_ubi_dev_spec *info, int fastmap)
 {
 	struct ubi_scan_info *ubi = info->ubi;
+	uint64_t start, elapsed_ms;
 	uint32_t fsize;
 
 	/*
@@ -1189,9 +1203,14 @@ void ubispl_init_scan(struct io_ubi_dev_spec *info, int fastmap)
 		(uint64_t)info->peb_offset * info->peb_size,
 		(uint64_t)(info->peb_offset + info->peb_count) * info->peb_size);
 
+	start = read_cntpct_el0();
+
 	ipl_scan(ubi);
 
-	ubi_msg("scanning is finished");
+	elapsed_ms = (read_cntpct_el0() - start) * 1000 / read_cntfrq_el0();
+
+	ubi_msg("attached by %s in %" PRIu64 " ms, %u flash reads",
+		ubi->fm ? "fastmap" : "full scan", elapsed_ms, ubi->read_count);
 	ubi_msg("PEB size: %u bytes (%u KiB), LEB size: %lu bytes",
 		info->peb_size, info->peb_size >> 10, ubi->leb_size);
 	ubi_msg("VID header offset: %u (aligned %u), data offset: %u",
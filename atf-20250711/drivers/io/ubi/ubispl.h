@@ -121,6 +121,7 @@ struct ubi_leb_cache_info {
  * @vid_offset:		Offset from the start of a PEB to the VID header
  * @leb_start:		Offset from the start of a PEB to the data area
  * @leb_size:		Size of the data area
+ * @read_count:		Number of flash reads issued (stats only)
  *
  * @fastmap_pebs:	Counter of PEBs "attached" by fastmap
  * @fastmap_anchor:	The anchor PEB of the fastmap
@@ -161,6 +162,7 @@ struct ubi_scan_info {
 	unsigned long			vid_offset;
 	unsigned long			leb_start;
 	unsigned long			leb_size;
+	unsigned int			read_count;
 
 	/* Fastmap: The upstream required fields */
 	int				fastmap_pebs;
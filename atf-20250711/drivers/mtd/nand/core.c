@@ -102,6 +102,21 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 				       bytes_read);
 
 				start_offset = 0U;
+			} else if ((nand_dev.mtd_read_pages != NULL) &&
+				   (length >= (2U * nand_dev.page_size))) {
+				unsigned int count = MIN(nb_pages - page,
+						(unsigned int)(length /
+							nand_dev.page_size));
+
+				ret = nand_dev.mtd_read_pages(&nand_dev,
+						(block * nb_pages) + page,
+						count, buffer);
+				if (ret != 0) {
+					return ret;
+				}
+
+				bytes_read = count * nand_dev.page_size;
+				page += count - 1U;
 			} else {
 				ret = nand_dev.mtd_read_page(&nand_dev,
 						(block * nb_pages) + page,
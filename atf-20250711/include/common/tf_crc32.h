@@ -13,4 +13,7 @@
 /* compute CRC using Arm intrinsic function */
 uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size);
 
+/* same without pre- and post-inversion, as used by e.g. UBI */
+uint32_t tf_crc32_no_comp(uint32_t crc, const unsigned char *buf, size_t size);
+
 #endif /* TF_CRC32_H */
@@ -19,6 +19,11 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * If not zero, whole blocks are read straight into user buffers
+	 * aligned to this value instead of being copied from 'buffer'.
+	 */
+	size_t		direct_read_align;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IO_LZ4_H
+#define IO_LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct io_dev_connector;
+
+/*
+ * struct io_lz4_dev_spec - description of an LZ4 decompression device
+ * @backend_dev:	Handle of the device holding the LZ4 frames
+ * @buffer:		Buffer for compressed blocks
+ * @buffer_size:	Size of the buffer
+ */
+typedef struct io_lz4_dev_spec {
+	uintptr_t backend_dev;
+	uintptr_t buffer;
+	size_t buffer_size;
+} io_lz4_dev_spec_t;
+
+int io_lz4_check_frame(const void *hdr, size_t len, size_t buffer_size);
+
+int register_io_dev_lz4(const struct io_dev_connector **dev_con);
+
+#endif /* IO_LZ4_H */
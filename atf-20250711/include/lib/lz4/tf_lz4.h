@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LZ4_H
+#define TF_LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LZ4_HASH_LOG			12U
+#define LZ4_HASH_SIZE			(1U << LZ4_HASH_LOG)
+
+/* Largest input of lz4_compress_block(), offsets in the table are 16-bit */
+#define LZ4_COMPRESS_MAX_IN		0x10000U
+
+int lz4_compress_block(const uint8_t *in, size_t in_len, uint8_t *out,
+		       size_t out_max, uint16_t table[LZ4_HASH_SIZE]);
+
+#endif /* TF_LZ4_H */
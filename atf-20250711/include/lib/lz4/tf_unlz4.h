@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_UNLZ4_H
+#define TF_UNLZ4_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Frame header with content size, without dictionary ID */
+#define LZ4_FRAME_HDR_MAX_LEN		15U
+
+#define LZ4_BLOCK_HDR_LEN		4U
+#define LZ4_BLOCK_UNCOMPRESSED		0x80000000U
+#define LZ4_CHECKSUM_LEN		4U
+
+struct lz4_frame_info {
+	size_t hdr_len;
+	size_t block_max;
+	uint64_t content_size;
+	bool has_content_size;
+	bool block_checksum;
+	bool content_checksum;
+};
+
+static inline uint32_t lz4_get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool lz4_is_frame(const void *buf, size_t len);
+
+int lz4_get_frame_info(const void *buf, size_t len,
+		       struct lz4_frame_info *info);
+
+int lz4_decode_block(const uint8_t *in, size_t in_len,
+		     const uint8_t *out_start, uint8_t **out,
+		     const uint8_t *out_end);
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf, size_t out_len,
+	  uintptr_t work_buf, size_t work_len);
+
+#endif /* TF_UNLZ4_H */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Single-pass greedy LZ4 block compressor
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <tf_lz4.h>
+#include <tf_unlz4.h>
+
+#define LZ4_MIN_MATCH		4U
+#define LZ4_LAST_LITERALS	5U
+#define LZ4_MF_LIMIT		12U
+#define LZ4_MAX_OFFSET		0xffffU
+#define LZ4_RUN_MASK		0xfU
+
+static uint32_t lz4_hash(uint32_t seq)
+{
+	return (seq * 2654435761U) >> (32U - LZ4_HASH_LOG);
+}
+
+/* Length field continuation bytes, after the 4 bits of the token */
+static uint8_t *lz4_put_len(uint8_t *op, const uint8_t *oend, size_t len)
+{
+	for (len -= LZ4_RUN_MASK; len >= 255U; len -= 255U) {
+		if (op >= oend)
+			return NULL;
+
+		*op++ = 255U;
+	}
+
+	if (op >= oend)
+		return NULL;
+
+	*op++ = (uint8_t)len;
+
+	return op;
+}
+
+/* Emit a sequence, a match length of 0 marks the last literals */
+static uint8_t *lz4_put_seq(uint8_t *op, const uint8_t *oend,
+			    const uint8_t *lit, size_t lit_len,
+			    size_t offset, size_t match_len)
+{
+	uint8_t *token = op++;
+	size_t ml = match_len ? match_len - LZ4_MIN_MATCH : 0U;
+
+	if (op > oend)
+		return NULL;
+
+	*token = (uint8_t)(((lit_len < LZ4_RUN_MASK) ? lit_len : LZ4_RUN_MASK)
+			   << 4);
+
+	if (lit_len >= LZ4_RUN_MASK) {
+		op = lz4_put_len(op, oend, lit_len);
+		if (op == NULL)
+			return NULL;
+	}
+
+	if (lit_len > (size_t)(oend - op))
+		return NULL;
+
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (match_len == 0U)
+		return op;
+
+	if ((size_t)(oend - op) < 2U)
+		return NULL;
+
+	*op++ = (uint8_t)offset;
+	*op++ = (uint8_t)(offset >> 8);
+
+	*token |= (uint8_t)((ml < LZ4_RUN_MASK) ? ml : LZ4_RUN_MASK);
+
+	if (ml >= LZ4_RUN_MASK)
+		op = lz4_put_len(op, oend, ml);
+
+	return op;
+}
+
+/*
+ * lz4_compress_block - compress a buffer into a raw LZ4 block
+ * @in: data to compress, up to LZ4_COMPRESS_MAX_IN bytes
+ * @in_len: length of @in
+ * @out: output buffer
+ * @out_max: size of @out
+ * @table: hash table of recent positions, contents need no initialization
+ *
+ * Only the first match found through the hash table is used, trading ratio
+ * for speed. The block can be decoded by any LZ4 decompressor.
+ *
+ * Return length of the block, -ENOSPC if it does not fit into @out_max bytes
+ */
+int lz4_compress_block(const uint8_t *in, size_t in_len, uint8_t *out,
+		       size_t out_max, uint16_t table[LZ4_HASH_SIZE])
+{
+	const uint8_t *ip = in, *anchor = in, *ref, *mflimit, *matchlimit;
+	const uint8_t *iend = in + in_len;
+	uint8_t *op = out, *oend = out + out_max;
+	uint32_t seq, h;
+	size_t len;
+
+	if (in_len > LZ4_COMPRESS_MAX_IN)
+		return -EINVAL;
+
+	if (in_len < LZ4_MF_LIMIT + 1U)
+		goto last_literals;
+
+	mflimit = iend - LZ4_MF_LIMIT;
+	matchlimit = iend - LZ4_LAST_LITERALS;
+
+	memset(table, 0, LZ4_HASH_SIZE * sizeof(table[0]));
+
+	/* Position 0 is in the table already */
+	ip++;
+
+	while (ip < mflimit) {
+		seq = lz4_get_le32(ip);
+		h = lz4_hash(seq);
+		ref = in + table[h];
+		table[h] = (uint16_t)(ip - in);
+
+		if ((ref >= ip) || ((size_t)(ip - ref) > LZ4_MAX_OFFSET) ||
+		    (lz4_get_le32(ref) != seq)) {
+			ip++;
+			continue;
+		}
+
+		for (len = LZ4_MIN_MATCH; ip + len < matchlimit; len++) {
+			if (ip[len] != ref[len])
+				break;
+		}
+
+		op = lz4_put_seq(op, oend, anchor, ip - anchor, ip - ref, len);
+		if (op == NULL)
+			return -ENOSPC;
+
+		ip += len;
+		anchor = ip;
+	}
+
+last_literals:
+	op = lz4_put_seq(op, oend, anchor, iend - anchor, 0, 0);
+	if (op == NULL)
+		return -ENOSPC;
+
+	return (int)(op - out);
+}
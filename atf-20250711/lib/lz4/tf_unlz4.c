@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Decoder of the LZ4 frame format, for images compressed by the lz4 tool
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <tf_unlz4.h>
+
+#define LZ4_FRAME_MAGIC			0x184d2204U
+
+#define LZ4_FLG_VERSION_MASK		0xc0U
+#define LZ4_FLG_VERSION			0x40U
+#define LZ4_FLG_BLOCK_CHECKSUM		0x10U
+#define LZ4_FLG_CONTENT_SIZE		0x08U
+#define LZ4_FLG_CONTENT_CHECKSUM	0x04U
+#define LZ4_FLG_DICT_ID			0x01U
+
+#define LZ4_BD_BLOCK_MAX_SHIFT		4
+#define LZ4_BD_BLOCK_MAX_MASK		0x07U
+
+/* Magic, FLG, BD and HC */
+#define LZ4_FRAME_HDR_MIN_LEN		7U
+#define LZ4_CONTENT_SIZE_LEN		8U
+
+#define LZ4_RUN_MASK			0x0fU
+#define LZ4_MIN_MATCH			4U
+
+/* Read the extension bytes of a literal or match length */
+static int lz4_get_len(const uint8_t **ip, const uint8_t *ip_end, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= ip_end)
+			return -EINVAL;
+
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 0xffU);
+
+	return 0;
+}
+
+/*
+ * lz4_decode_block - decode one compressed block
+ * @ip: compressed block
+ * @in_len: length of the compressed block
+ * @out_start: start of the decompressed data. Matches may refer to anything
+ *	       decoded since, which also covers frames with linked blocks.
+ * @outp: destination of the block. Upon exit, the end of the block.
+ * @out_end: end of the output buffer
+ */
+int lz4_decode_block(const uint8_t *ip, size_t in_len,
+		     const uint8_t *out_start, uint8_t **outp,
+		     const uint8_t *out_end)
+{
+	const uint8_t *ip_end = ip + in_len, *match;
+	uint8_t *op = *outp;
+	size_t len, offset;
+	uint8_t token;
+
+	while (ip < ip_end) {
+		token = *ip++;
+
+		/* Literals */
+		len = token >> 4;
+		if ((len == LZ4_RUN_MASK) && (lz4_get_len(&ip, ip_end, &len) != 0))
+			return -EINVAL;
+
+		if (len > (size_t)(ip_end - ip))
+			return -EINVAL;
+
+		if (len > (size_t)(out_end - op))
+			return -ENOSPC;
+
+		memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		/* The last sequence of a block has no match */
+		if (ip == ip_end)
+			break;
+
+		/* Match */
+		if ((size_t)(ip_end - ip) < 2U)
+			return -EINVAL;
+
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+
+		if ((offset == 0U) || (offset > (size_t)(op - out_start)))
+			return -EINVAL;
+
+		len = token & LZ4_RUN_MASK;
+		if ((len == LZ4_RUN_MASK) && (lz4_get_len(&ip, ip_end, &len) != 0))
+			return -EINVAL;
+
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(out_end - op))
+			return -ENOSPC;
+
+		match = op - offset;
+
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			/* Overlapping match, repeats the last @offset bytes */
+			while (len-- != 0U)
+				*op++ = *match++;
+		}
+	}
+
+	*outp = op;
+
+	return 0;
+}
+
+/*
+ * lz4_is_frame - check whether data starts with an LZ4 frame
+ * @buf: data
+ * @len: length of data
+ */
+bool lz4_is_frame(const void *buf, size_t len)
+{
+	if (len < LZ4_FRAME_HDR_MIN_LEN)
+		return false;
+
+	return lz4_get_le32(buf) == LZ4_FRAME_MAGIC;
+}
+
+/*
+ * lz4_get_frame_info - parse an LZ4 frame header
+ * @buf: data starting with the frame header
+ * @len: length of data
+ * @info: frame parameters
+ *
+ * Frames using a dictionary are not supported. The header checksum is not
+ * verified.
+ */
+int lz4_get_frame_info(const void *buf, size_t len,
+		       struct lz4_frame_info *info)
+{
+	const uint8_t *p = buf;
+	uint8_t flg, bd;
+
+	if (!lz4_is_frame(buf, len))
+		return -EINVAL;
+
+	flg = p[4];
+	bd = p[5];
+
+	if (((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+	    ((flg & LZ4_FLG_DICT_ID) != 0U))
+		return -ENOTSUP;
+
+	bd = (bd >> LZ4_BD_BLOCK_MAX_SHIFT) & LZ4_BD_BLOCK_MAX_MASK;
+	if (bd < 4U)
+		return -EINVAL;
+
+	/* 64KB, 256KB, 1MB or 4MB */
+	info->block_max = (size_t)1 << (2U * bd + 8U);
+	info->hdr_len = LZ4_FRAME_HDR_MIN_LEN;
+	info->content_size = 0;
+	info->has_content_size = (flg & LZ4_FLG_CONTENT_SIZE) != 0U;
+	info->block_checksum = (flg & LZ4_FLG_BLOCK_CHECKSUM) != 0U;
+	info->content_checksum = (flg & LZ4_FLG_CONTENT_CHECKSUM) != 0U;
+
+	if (info->has_content_size) {
+		info->hdr_len += LZ4_CONTENT_SIZE_LEN;
+		if (len < info->hdr_len)
+			return -EINVAL;
+
+		info->content_size = (uint64_t)lz4_get_le32(p + 6) |
+				     ((uint64_t)lz4_get_le32(p + 10) << 32);
+	}
+
+	return 0;
+}
+
+/*
+ * unlz4 - decompress an LZ4 frame
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused)
+ * @work_len: length of workspace (unused)
+ *
+ * Both independent and linked blocks are supported, but not dictionaries.
+ * The header, block and content checksums are skipped. The content size is
+ * checked if the frame has one.
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf, size_t out_len,
+	  uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf, *ip_end = ip + in_len;
+	uint8_t *out_start = (uint8_t *)*out_buf, *op = out_start;
+	const uint8_t *out_end = out_start + out_len;
+	struct lz4_frame_info info;
+	uint32_t bsize;
+	size_t len;
+	int ret;
+
+	ret = lz4_get_frame_info(ip, in_len, &info);
+	if (ret == -ENOTSUP) {
+		ERROR("lz4: unsupported frame descriptor 0x%02x\n", ip[4]);
+		return ret;
+	} else if (ret != 0) {
+		ERROR("lz4: invalid frame header\n");
+		return ret;
+	}
+
+	if (info.has_content_size && (info.content_size > out_len)) {
+		ERROR("lz4: output buffer too small\n");
+		return -ENOSPC;
+	}
+
+	ip += info.hdr_len;
+
+	while (true) {
+		if ((size_t)(ip_end - ip) < LZ4_BLOCK_HDR_LEN)
+			goto truncated;
+
+		bsize = lz4_get_le32(ip);
+		ip += LZ4_BLOCK_HDR_LEN;
+
+		/* EndMark */
+		if (bsize == 0U)
+			break;
+
+		len = bsize & ~LZ4_BLOCK_UNCOMPRESSED;
+		if (len > (size_t)(ip_end - ip))
+			goto truncated;
+
+		if ((bsize & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			if (len > (size_t)(out_end - op)) {
+				ret = -ENOSPC;
+				goto fail;
+			}
+
+			memcpy(op, ip, len);
+			op += len;
+		} else {
+			ret = lz4_decode_block(ip, len, out_start, &op, out_end);
+			if (ret != 0)
+				goto fail;
+		}
+
+		ip += len;
+
+		if (info.block_checksum) {
+			if ((size_t)(ip_end - ip) < LZ4_CHECKSUM_LEN)
+				goto truncated;
+
+			ip += LZ4_CHECKSUM_LEN;
+		}
+	}
+
+	if (info.content_checksum) {
+		if ((size_t)(ip_end - ip) < LZ4_CHECKSUM_LEN)
+			goto truncated;
+
+		ip += LZ4_CHECKSUM_LEN;
+	}
+
+	if (info.has_content_size &&
+	    ((uint64_t)(op - out_start) != info.content_size)) {
+		ERROR("lz4: content size mismatch\n");
+		return -EIO;
+	}
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return 0;
+
+truncated:
+	ERROR("lz4: truncated input\n");
+	return -EINVAL;
+
+fail:
+	ERROR("lz4: failed to decode block (err = %d)\n", ret);
+	return ret;
+}
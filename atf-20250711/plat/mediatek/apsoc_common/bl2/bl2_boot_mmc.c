@@ -14,6 +14,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_block.h>
 #include <drivers/mmc.h>
+#include <platform_def.h>
 #include "bl2_plat_setup.h"
 #include <mtk-sd.h>
 #ifdef DUAL_FIP
@@ -36,6 +37,7 @@ static io_block_dev_spec_t mmc_dev_uda_spec = {
 	},
 
 	.block_size = MMC_BLOCK_SIZE,
+	.direct_read_align = CACHE_WRITEBACK_GRANULE,
 };
 
 static const io_block_spec_t mmc_dev_gpt_spec = {
@@ -66,6 +68,7 @@ static io_block_dev_spec_t mmc_dev_boot0_spec = {
 	},
 
 	.block_size = MMC_BLOCK_SIZE,
+	.direct_read_align = CACHE_WRITEBACK_GRANULE,
 };
 #endif
 
@@ -83,6 +86,7 @@ static io_block_dev_spec_t mmc_dev_boot1_spec = {
 	},
 
 	.block_size = MMC_BLOCK_SIZE,
+	.direct_read_align = CACHE_WRITEBACK_GRANULE,
 };
 #endif
 
@@ -99,8 +103,6 @@ static const uintptr_t mmc_dev_fips[] = {
 	(uintptr_t)&mmc_dev_fip2_spec,
 };
 
-static io_block_spec_t mmc_dev_fip_curr_spec;
-
 #ifdef FIP_IN_BOOT0
 static uintptr_t mmc_dev_boot0_handle;
 #endif
@@ -109,7 +111,6 @@ static uintptr_t mmc_dev_boot1_handle;
 #endif
 
 static uintptr_t mmc_dev_handles[FIP_NUM];
-static uintptr_t *mmc_dev_handle_ptr;
 #endif
 
 static uintptr_t mmc_dev_uda_handle;
@@ -385,28 +386,15 @@ int mtk_dual_fip_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec)
 	if (ret)
 		return ret;
 
-	mmc_dev_fip_curr_spec = *(io_block_spec_t *)mmc_dev_fips[slot];
-	mmc_dev_handle_ptr = dev_handle;
-
-	*dev_handle = mmc_dev_handles[slot];
-	*image_spec = (uintptr_t)&mmc_dev_fip_curr_spec;
-
-	return 0;
+	return dual_fip_ram_image_setup(dev_handle, image_spec);
 }
 
 int mtk_fip_image_setup_next_slot(void)
 {
 	uint32_t slot;
-	int ret;
 
-	ret = dual_fip_next_slot(mmc_dev_handles, mmc_dev_fips, &slot);
-	if (ret)
-		return ret;
-
-	*mmc_dev_handle_ptr = mmc_dev_handles[slot];
-	mmc_dev_fip_curr_spec = *(io_block_spec_t *)mmc_dev_fips[slot];
-
-	return 0;
+	/* The FIP of the new slot is served from the same buffer */
+	return dual_fip_next_slot(mmc_dev_handles, mmc_dev_fips, &slot);
 }
 #endif
 
@@ -42,6 +42,15 @@ static int nmbm_lower_read_page(void *arg, uint64_t addr, void *buf, void *oob,
 				       (uintptr_t)buf);
 }
 
+static int nmbm_lower_read_pages(void *arg, uint64_t addr, void *buf,
+				 uint32_t count, enum nmbm_oob_mode mode)
+{
+	struct nand_device *nand_dev = get_nand_device();
+
+	return nand_dev->mtd_read_pages(nand_dev, addr / nand_dev->page_size,
+					count, (uintptr_t)buf);
+}
+
 static int nmbm_lower_is_bad_block(void *arg, uint64_t addr)
 {
 	struct nand_device *nand_dev = get_nand_device();
@@ -102,6 +111,8 @@ static int nmbm_init(void)
 	nld.oobsize = nand_dev->oob_size;
 
 	nld.read_page = nmbm_lower_read_page;
+	if (nand_dev->mtd_read_pages)
+		nld.read_pages = nmbm_lower_read_pages;
 	nld.is_bad_block = nmbm_lower_is_bad_block;
 
 	nld.logprint = nmbm_lower_log;
@@ -67,7 +67,9 @@ static io_ubi_dev_spec_t nand_ubi_dev_spec = {
 	.ubi = (struct ubi_scan_info *)SCRATCH_BUF_OFFSET,
 	.is_bad_peb = nand_ubispl_is_bad_block,
 	.read = nand_ubispl_read,
-	.fastmap = 0,
+#ifdef UBI_FASTMAP
+	.fastmap = 1,
+#endif
 };
 
 static const io_ubi_spec_t ubi_dev_fip_spec = {
@@ -86,7 +88,6 @@ static const uintptr_t ubi_dev_fips[] = {
 	(uintptr_t)&ubi_dev_fip2_spec,
 };
 
-static io_ubi_spec_t ubi_dev_fip_curr_spec;
 
 static const io_ubi_spec_t ubi_dev_bootconf1_spec = {
 	.vol_id = -1,
@@ -123,7 +124,6 @@ int mtk_fip_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec)
 {
 	const io_dev_connector_t *dev_con;
 	size_t page_size, block_size;
-	uintptr_t fip_image_spec;
 	uint64_t nand_size;
 	int ret;
 
@@ -152,8 +152,6 @@ int mtk_fip_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec)
 	if (ret)
 		return ret;
 
-	fip_image_spec = (uintptr_t)&ubi_dev_fip_spec;
-
 #ifdef DUAL_FIP
 	mtk_load_bsp_conf_ubi(ubi_dev_handle);
 
@@ -163,12 +161,11 @@ int mtk_fip_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec)
 	if (ret)
 		return ret;
 
-	ubi_dev_fip_curr_spec = *(io_ubi_spec_t *)ubi_dev_fips[slot];
-	fip_image_spec = (uintptr_t)&ubi_dev_fip_curr_spec;
+	return dual_fip_ram_image_setup(dev_handle, image_spec);
 #endif
 
 	*dev_handle = ubi_dev_handle;
-	*image_spec = fip_image_spec;
+	*image_spec = (uintptr_t)&ubi_dev_fip_spec;
 
 	return 0;
 }
@@ -178,16 +175,10 @@ int mtk_fip_image_setup_next_slot(void)
 {
 	uintptr_t dev_handles[FIP_NUM];
 	uint32_t slot;
-	int ret;
 
 	dev_handles[0] = dev_handles[1] = ubi_dev_handle;
 
-	ret = dual_fip_next_slot(dev_handles, ubi_dev_fips, &slot);
-	if (ret)
-		return ret;
-
-	ubi_dev_fip_curr_spec = *(io_ubi_spec_t *)ubi_dev_fips[slot];
-
-	return 0;
+	/* The FIP of the new slot is served from the same buffer */
+	return dual_fip_next_slot(dev_handles, ubi_dev_fips, &slot);
 }
 #endif
@@ -38,6 +38,23 @@ static int snfi_mtd_read_page(struct nand_device *nand, unsigned int page,
 	return ret;
 }
 
+static int snfi_mtd_read_pages(struct nand_device *nand, unsigned int page,
+			       unsigned int count, uintptr_t buffer)
+{
+	uint64_t addr = (uint64_t)page * nand->page_size;
+	int ret;
+
+	ret = mtk_snand_read_pages(snf, addr, (void *)buffer, count, false,
+				   NULL);
+	if (ret > 0) {
+		NOTICE("corrected %d bitflips while reading pages %u-%u\n",
+		       ret, page, page + count - 1);
+		ret = 0;
+	}
+
+	return ret;
+}
+
 int mtk_plat_nand_setup(size_t *page_size, size_t *block_size, uint64_t *size)
 {
 	struct nand_device *nand_dev = get_nand_device();
@@ -60,6 +77,7 @@ int mtk_plat_nand_setup(size_t *page_size, size_t *block_size, uint64_t *size)
 
 	nand_dev->mtd_block_is_bad = snfi_mtd_block_is_bad;
 	nand_dev->mtd_read_page = snfi_mtd_read_page;
+	nand_dev->mtd_read_pages = snfi_mtd_read_pages;
 	nand_dev->nb_planes = 1;
 	nand_dev->block_size = cinfo.blocksize;
 	nand_dev->page_size = cinfo.pagesize;
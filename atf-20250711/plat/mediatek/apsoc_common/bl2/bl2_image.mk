@@ -76,6 +76,15 @@ BL2_SOURCES		+=	drivers/mmc/mmc.c				\
 BL2_CPPFLAGS		+=	-I$(APSOC_COMMON)/drivers/mmc			\
 				-DMTK_MMC_BOOT
 BL2_CFLAGS		+=	-march=armv8-a+crc
+
+ifeq ($$(MMC_DMA),)
+MMC_DMA := 1
+endif
+
+ifeq ($$(MMC_DMA),1)
+BL2_SOURCES		+=	$(APSOC_COMMON)/drivers/mmc/mtk-sd-dma.c
+BL2_CPPFLAGS		+=	-DMTK_MMC_DMA
+endif
 endef # End of BL2_BOOT_MMC
 
 define BL2_BOOT_EMMC
@@ -133,6 +142,7 @@ BL2_SOURCES		+=	drivers/io/ubi/io_ubi.c				\
 				$(APSOC_COMMON)/bl2/bl2_boot_nand_ubi.c
 BL2_CPPFLAGS		+=	-Idrivers/io/ubi
 ifneq (${ARCH},aarch32)
+BL2_SOURCES		+=	common/tf_crc32.c
 BL2_CFLAGS		+=	-march=armv8-a+crc
 else
 BL2_SOURCES		+=	drivers/io/ubi/crc32.c
@@ -148,6 +158,12 @@ endif
 $(call BL2_BOOT_COMMON)
 
 ifeq ($$(UBI),1)
+ifeq ($$(UBI_FASTMAP),)
+UBI_FASTMAP := 1
+endif
+ifeq ($$(UBI_FASTMAP),1)
+BL2_CPPFLAGS		+=	-DUBI_FASTMAP
+endif
 ifneq ($(OVERRIDE_UBI_START_ADDR),)
 BL2_CPPFLAGS		+=	-DOVERRIDE_UBI_START_ADDR=$(OVERRIDE_UBI_START_ADDR)
 endif
@@ -37,11 +37,27 @@ endif # END OF BL2_COMPRESS
 
 # FIP compress
 ifeq ($(FIP_COMPRESS),1)
-BL31_PRE_TOOL_FILTER	:= XZ
-BL32_PRE_TOOL_FILTER	:= XZ
-BL33_PRE_TOOL_FILTER	:= XZ
+ifeq ($(FIP_COMPRESS_ALGO),lz4)
+FIP_COMPRESS_FILTER	:= LZ4
+else
+FIP_COMPRESS_FILTER	:= XZ
+endif
+
+BL31_PRE_TOOL_FILTER	:= $(FIP_COMPRESS_FILTER)
+BL32_PRE_TOOL_FILTER	:= $(FIP_COMPRESS_FILTER)
+BL33_PRE_TOOL_FILTER	:= $(FIP_COMPRESS_FILTER)
 endif
 
+# LZ4 frame with 64 KiB linked blocks and content size, checksums are not
+# used by BL2. The block size bounds the buffer BL2 decompresses blocks from.
+define LZ4_RULE
+$(1): $(2)
+	$(s)echo "  LZ4     $$@"
+	$(q)lz4 -q -f -12 -B4 -BD --content-size --no-frame-crc $$< $$@
+endef
+
+LZ4_SUFFIX		:= .lz4
+
 # Build dtb before embedding to BL2
 $(BUILD_PLAT)/bl2/dtb.o: $(BUILD_PLAT)/fdts/$(DTS_NAME).dtb
 
@@ -4,6 +4,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include <tf_unxz.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
@@ -31,6 +32,20 @@
 #include <mtk_plat_key.h>
 #endif
 
+#ifdef MTK_MMC_BOOT
+#include <drivers/mmc.h>
+#include <mtk-sd.h>
+#endif
+
+#ifdef FIP_COMPRESS_LZ4
+#include <tf_unlz4.h>
+#if !TRUSTED_BOARD_BOOT
+/* Images are authenticated in compressed form with TBB */
+#include <drivers/io/io_lz4.h>
+#define FIP_STREAM_LZ4
+#endif
+#endif
+
 struct plat_io_policy {
 	uintptr_t *dev_handle;
 	uintptr_t image_spec;
@@ -49,6 +64,12 @@ static uintptr_t gpt_dev_handle;
 static const io_dev_connector_t *enc_dev_con;
 static uintptr_t enc_dev_handle;
 #endif
+#ifdef FIP_STREAM_LZ4
+static const io_dev_connector_t *lz4_dev_con;
+static uintptr_t lz4_dev_handle;
+static bool fip_image_streaming;
+#endif
+static uint64_t image_load_start;
 
 #ifndef MTK_PLAT_NO_DEFAULT_BL2_NEXT_IMAGES
 static bl_mem_params_node_t bl2_mem_params_descs[] = {
@@ -164,6 +185,24 @@ static int check_fip(const uintptr_t spec)
 	return ret;
 }
 
+#ifdef FIP_STREAM_LZ4
+static int open_lz4_dev(void)
+{
+	io_lz4_dev_spec_t spec = {
+		.backend_dev = fip_dev_handle,
+		.buffer = FIP_DECOMP_BUF_OFFSET,
+		.buffer_size = FIP_DECOMP_BUF_SIZE,
+	};
+	int ret;
+
+	ret = io_dev_open(lz4_dev_con, (uintptr_t)&spec, &lz4_dev_handle);
+	if (ret)
+		ERROR("io_dev_open failed for LZ4 (%d)\n", ret);
+
+	return ret;
+}
+#endif
+
 static const io_uuid_spec_t bl31_uuid_spec = {
 	.uuid = UUID_EL3_RUNTIME_FIRMWARE_BL31,
 };
@@ -337,6 +376,17 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 	*image_spec = policy->image_spec;
 	*dev_handle = *policy->dev_handle;
 
+#ifdef FIP_STREAM_LZ4
+	/* The image being loaded is decompressed while read from FIP */
+	if (fip_image_streaming) {
+		ret = open_lz4_dev();
+		if (ret)
+			return ret;
+
+		*dev_handle = lz4_dev_handle;
+	}
+#endif
+
 	return 0;
 }
 
@@ -351,6 +401,70 @@ static struct image_info *get_image_info(unsigned int image_id)
 	return &desc->image_info;
 }
 
+static const char *fip_image_format(uintptr_t buf, size_t len)
+{
+	static const uint8_t xz_magic[] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+
+#ifdef FIP_COMPRESS_LZ4
+	if (lz4_is_frame((const void *)buf, len))
+		return "lz4";
+#endif
+
+	if (len >= sizeof(xz_magic) &&
+	    !memcmp((const void *)buf, xz_magic, sizeof(xz_magic)))
+		return "xz";
+
+	return "raw";
+}
+
+#ifdef FIP_COMPRESS_LZ4
+/* Images are LZ4 frames, unless they come from a FIP built with XZ */
+static int fip_decompress(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+			  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	if (lz4_is_frame((const void *)*in_buf, in_len))
+		return unlz4(in_buf, in_len, out_buf, out_len, work_buf,
+			     work_len);
+
+	return unxz(in_buf, in_len, out_buf, out_len, work_buf, work_len);
+}
+#else
+#define fip_decompress		unxz
+#endif
+
+static uint64_t ticks_to_us(uint64_t ticks)
+{
+	return ticks * 1000000 / read_cntfrq_el0();
+}
+
+#ifdef FIP_STREAM_LZ4
+/* Whether the image is an LZ4 frame which can be decompressed while read */
+static bool fip_image_streamable(unsigned int image_id)
+{
+	uintptr_t dev_handle, image_spec, image_handle;
+	uint8_t hdr[LZ4_FRAME_HDR_MAX_LEN];
+	size_t len = 0;
+	int ret;
+
+	ret = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (ret)
+		return false;
+
+	ret = io_open(dev_handle, image_spec, &image_handle);
+	if (!ret) {
+		ret = io_read(image_handle, (uintptr_t)hdr, sizeof(hdr), &len);
+		io_close(image_handle);
+	}
+
+	io_dev_close(dev_handle);
+
+	if (ret)
+		return false;
+
+	return !io_lz4_check_frame(hdr, len, FIP_DECOMP_BUF_SIZE);
+}
+#endif
+
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
 	struct image_info *image_info;
@@ -359,8 +473,17 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 	if (!image_info)
 		return -ENODEV;
 
-	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING))
+	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+		image_load_start = read_cntpct_el0();
+
+#ifdef FIP_STREAM_LZ4
+		fip_image_streaming = fip_image_streamable(image_id);
+		if (fip_image_streaming)
+			return 0;
+#endif
+
 		image_decompress_prepare(image_info);
+	}
 
 	return 0;
 }
@@ -368,16 +491,45 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
 	struct image_info *image_info = get_image_info(image_id);
+	uint64_t start, end;
+	uint32_t in_len;
+	const char *fmt;
 	int ret;
 
 	if (!image_info)
 		return -ENODEV;
 
-	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
-		ret = image_decompress(image_info);
-		if (ret)
-			return ret;
+	if (image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)
+		return 0;
+
+#ifdef FIP_STREAM_LZ4
+	if (fip_image_streaming) {
+		fip_image_streaming = false;
+
+		NOTICE("BL2: Image id %u (lz4, streamed): %u bytes, %llu us\n",
+		       image_id, image_info->image_size,
+		       (unsigned long long)ticks_to_us(read_cntpct_el0() -
+						       image_load_start));
+		return 0;
 	}
+#endif
+
+	/* The image has been loaded into the decompression buffer */
+	in_len = image_info->image_size;
+	fmt = fip_image_format(image_info->image_base, in_len);
+
+	start = read_cntpct_el0();
+
+	ret = image_decompress(image_info);
+	if (ret)
+		return ret;
+
+	end = read_cntpct_el0();
+
+	NOTICE("BL2: Image id %u (%s): %u -> %u bytes, %llu us, "
+	       "decompressed in %llu us\n", image_id, fmt, in_len, image_info->image_size,
+	       (unsigned long long)ticks_to_us(end - image_load_start),
+	       (unsigned long long)ticks_to_us(end - start));
 
 	return 0;
 }
@@ -389,8 +541,17 @@ void bl2_plat_handle_post_image_load_err(unsigned int image_id)
 	if (!image_info)
 		return;
 
-	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING))
-		image_decompress_restore(image_info);
+	if (image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)
+		return;
+
+#ifdef FIP_STREAM_LZ4
+	if (fip_image_streaming) {
+		fip_image_streaming = false;
+		return;
+	}
+#endif
+
+	image_decompress_restore(image_info);
 }
 
 struct bl_load_info *plat_get_bl_image_load_info(void)
@@ -473,6 +634,14 @@ static int bl2_fip_boot_setup(void)
 		return ret;
 	}
 
+#ifdef FIP_STREAM_LZ4
+	ret = register_io_dev_lz4(&lz4_dev_con);
+	if (ret) {
+		ERROR("register_io_dev_lz4 failed, ret: %d\n", ret);
+		return ret;
+	}
+#endif
+
 #if MTK_FIP_ENC && !defined(DECRYPTION_SUPPORT_none)
 	ret = register_io_dev_enc(&enc_dev_con);
 	if (ret)
@@ -533,7 +702,8 @@ void bl2_plat_preload_setup(void)
 		panic();
 	}
 
-	image_decompress_init(FIP_DECOMP_BUF_OFFSET, FIP_DECOMP_BUF_SIZE, unxz);
+	image_decompress_init(FIP_DECOMP_BUF_OFFSET, FIP_DECOMP_BUF_SIZE,
+			      fip_decompress);
 
 #if ENABLE_PIE
 	adjust_bl31_load_address();
@@ -551,6 +721,10 @@ void mtk_bl2_set_dram_size(size_t size)
 
 void bl2_el3_plat_prepare_exit(void)
 {
+#ifdef MTK_MMC_BOOT
+	mtk_mmc_print_stats();
+#endif
+
 #ifdef MTK_PLAT_KEY
 	disable_plat_key();
 #endif
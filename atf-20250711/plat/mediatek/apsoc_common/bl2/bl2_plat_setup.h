@@ -35,7 +35,7 @@ extern const struct initcall bl2_initcalls[];
 #define SCRATCH_BUF_OFFSET		0x40400000
 #define SCRATCH_BUF_SIZE		0x400000
 
-/* FIP XZ decompression buffer */
+/* FIP decompression buffer */
 #define FIP_DECOMP_BUF_OFFSET		0x40800000
 #define FIP_DECOMP_BUF_SIZE		0x400000
 
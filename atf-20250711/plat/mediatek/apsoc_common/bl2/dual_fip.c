@@ -7,9 +7,12 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/tf_crc32.h>
 #include <drivers/io/io_driver.h>
+#include <drivers/io/io_memmap.h>
+#include <drivers/io/io_storage.h>
 #include <tools_share/firmware_image_package.h>
 #include <plat_def_fip_uuid.h>
 #include "bl2_plat_setup.h"
@@ -22,6 +25,10 @@
 #include "sha256/sha256.h"
 #endif
 
+#ifdef SHA256_CE
+#include "sha256/sha256_ce.h"
+#endif
+
 #define FIP_TOC_ENTRY_READ_NUM			16
 #define FIP_TOC_ENTRY_MAX_NUM			(FIP_TOC_ENTRY_READ_NUM * 2)
 
@@ -47,6 +54,13 @@ static const uuid_t fip_uuids[] = {
 static const uuid_t uuid_null;
 static const uuid_t uuid_fip_chksum = UUID_MTK_FIP_CHECKSUM;
 
+/* The validated FIP is served to the FIP driver from the Dual-FIP buffer */
+static io_block_spec_t fip_ram_spec = {
+	.offset = DUAL_FIP_BUF_OFFSET,
+};
+
+static uintptr_t fip_ram_dev_handle;
+
 static inline int compare_uuid(const uuid_t *uuid1, const uuid_t *uuid2)
 {
 	return memcmp(uuid1, uuid2, sizeof(uuid_t));
@@ -65,6 +79,24 @@ static void uuid_to_str(char *s, size_t len, const uuid_t *u)
 	    (u->node[4] << 8) | u->node[5]);
 }
 
+static void report_hash_speed(size_t len, uint64_t ticks)
+{
+	const char *impl = "C";
+	uint64_t us, rate = 0;
+
+#ifdef SHA256_CE
+	if (sha256_ce_supported())
+		impl = "ARMv8 CE";
+#endif
+
+	us = ticks * 1000000 / read_cntfrq_el0();
+	if (us)
+		rate = (uint64_t)len * 1000000 / 1024 / us;
+
+	NOTICE("SHA-256 (%s): %zu KiB in %llu us, %llu KiB/s\n", impl,
+	       len / 1024, (unsigned long long)us, (unsigned long long)rate);
+}
+
 static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 			     uint32_t slot)
 {
@@ -73,7 +105,7 @@ static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 	void *fip_buf = (void *)DUAL_FIP_BUF_OFFSET;
 	char uuid_str[_UUID_STR_LEN + 1];
 	struct mtk_fip_checksum chksum;
-	uint64_t entry_end, max_end;
+	uint64_t entry_end, max_end, data_end = 0, start;
 	uint32_t i, crc, ntoc = 0;
 	uint8_t sha256sum[0x20];
 	fip_toc_entry_t entry;
@@ -85,6 +117,9 @@ static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 		return -EINVAL;
 	}
 
+	/* The buffer is about to be overwritten */
+	fip_ram_spec.length = 0;
+
 	chklen = FIP_TOC_ENTRY_READ_NUM * sizeof(entry);
 	fip_read_len = sizeof(hdr) + chklen;
 	entry_end = max_end = sizeof(hdr) + sizeof(entry);
@@ -156,6 +191,8 @@ static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 			}
 
 			chksum_offs = entry.offset_address;
+		} else if (entry_end > data_end) {
+			data_end = entry_end;
 		}
 
 		ntoc++;
@@ -202,6 +239,13 @@ static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 		goto cleanup;
 	}
 
+	/* Images are read from the buffer, they must all be checksummed */
+	if (data_end > chksum_offs) {
+		ERROR("FIP images exceed checksummed data\n");
+		ret = -EBADMSG;
+		goto cleanup;
+	}
+
 	if (entry_end > chksum_offs + sizeof(chksum))
 		WARN("Extra data after FIP checksum data\n");
 
@@ -233,13 +277,17 @@ static int load_validate_fip(uintptr_t dev_handle, uintptr_t spec,
 		return -EBADMSG;
 	}
 
+	start = read_cntpct_el0();
 	mbedtls_sha256(fip_buf, chksum.len, sha256sum, 0);
+	report_hash_speed(chksum.len, read_cntpct_el0() - start);
 
 	if (memcmp(sha256sum, chksum.sha256sum, sizeof(sha256sum))) {
 		ERROR("FIP checksum SHA256 hash mismatch\n");
 		return -EBADMSG;
 	}
 
+	fip_ram_spec.length = chksum.len;
+
 	return 0;
 
 cleanup:
@@ -308,3 +356,34 @@ int dual_fip_next_slot(const uintptr_t dev_handles[], const uintptr_t specs[],
 {
 	return get_fip_slot(dev_handles, specs, true, retslot);
 }
+
+/*
+ * The FIP has been read into the Dual-FIP buffer and validated by
+ * dual_fip_check(). Let the FIP driver read images from this copy instead of
+ * reading the boot device again. dual_fip_next_slot() reloads the buffer in
+ * place, so the returned handle and spec remain valid after switching slot.
+ */
+int dual_fip_ram_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec)
+{
+	const io_dev_connector_t *dev_con;
+	int ret;
+
+	if (!fip_ram_spec.length)
+		return -ENOENT;
+
+	if (!fip_ram_dev_handle) {
+		ret = register_io_dev_memmap(&dev_con);
+		if (ret)
+			return ret;
+
+		ret = io_dev_open(dev_con, (uintptr_t)NULL,
+				  &fip_ram_dev_handle);
+		if (ret)
+			return ret;
+	}
+
+	*dev_handle = fip_ram_dev_handle;
+	*image_spec = (uintptr_t)&fip_ram_spec;
+
+	return 0;
+}
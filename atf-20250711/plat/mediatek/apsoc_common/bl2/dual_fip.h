@@ -14,5 +14,6 @@ int dual_fip_check(const uintptr_t dev_handles[], const uintptr_t specs[],
 		   uint32_t *retslot);
 int dual_fip_next_slot(const uintptr_t dev_handles[], const uintptr_t specs[],
 		       uint32_t *retslot);
+int dual_fip_ram_image_setup(uintptr_t *dev_handle, uintptr_t *image_spec);
 
 #endif /* _MTK_DUAL_FIP_H_ */
@@ -12,6 +12,7 @@ ifeq ($(DUAL_FIP),1)
 BL2_CPPFLAGS		+=	-DDUAL_FIP
 
 BL2_SOURCES		+=	common/tf_crc32.c				\
+				drivers/io/io_memmap.c				\
 				$(APSOC_COMMON)/bl2/bsp_conf.c			\
 				$(APSOC_COMMON)/bl2/dual_fip.c
 
@@ -34,7 +35,7 @@ include make_helpers/dep.mk
 $(call GEN_DEP_RULES,bl2,bl2_image_load_v2 bsp_conf dual_fip bl2_boot_nand_ubi bl2_boot_mmc bl2_plat_setup)
 $(call MAKE_DEP,bl2,bl2_image_load_v2,DUAL_FIP)
 $(call MAKE_DEP,bl2,bsp_conf,LOG_LEVEL)
-$(call MAKE_DEP,bl2,dual_fip,LOG_LEVEL NEED_BL32 TRUSTED_BOARD_BOOT)
+$(call MAKE_DEP,bl2,dual_fip,LOG_LEVEL NEED_BL32 TRUSTED_BOARD_BOOT SHA256_CE)
 $(call MAKE_DEP,bl2,bl2_boot_nand_ubi,DUAL_FIP)
 $(call MAKE_DEP,bl2,bl2_boot_mmc,DUAL_FIP FIP_IN_BOOT0 FIP2_IN_BOOT1)
 $(call MAKE_DEP,bl2,bl2_plat_setup,DUAL_FIP)
@@ -0,0 +1,33 @@
+#
+# Copyright (c) 2025, MediaTek Inc. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+#
+# Algorithm used to compress BL31/BL32/BL33 in FIP: xz or lz4
+#
+ifeq ($(FIP_COMPRESS_ALGO),)
+FIP_COMPRESS_ALGO := xz
+endif
+
+ifeq ($(FIP_COMPRESS),1)
+ifeq ($(FIP_COMPRESS_ALGO),lz4)
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	$(LZ4_SOURCES)
+BL2_CPPFLAGS		+=	-DFIP_COMPRESS_LZ4
+
+# Images are decompressed while being read, unless they are authenticated
+ifneq ($(TRUSTED_BOARD_BOOT),1)
+BL2_SOURCES		+=	drivers/io/io_lz4.c
+endif
+else ifneq ($(FIP_COMPRESS_ALGO),xz)
+$(error Unsupported FIP_COMPRESS_ALGO '$(FIP_COMPRESS_ALGO)', must be xz or lz4)
+endif
+endif
+
+include make_helpers/dep.mk
+
+$(call GEN_DEP_RULES,bl2,bl2_plat_setup)
+$(call MAKE_DEP,bl2,bl2_plat_setup,FIP_COMPRESS FIP_COMPRESS_ALGO)
@@ -0,0 +1,32 @@
+#
+# Copyright (c) 2025, MediaTek Inc. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+#
+# SHA-256 using ARMv8 Crypto Extensions if the core implements them
+#
+ifeq ($(SHA256_CE),)
+SHA256_CE := 1
+endif
+
+ifneq ($(ARCH),aarch64)
+SHA256_CE := 0
+endif
+
+ifeq ($(SHA256_CE),1)
+$(eval $(call add_define,SHA256_CE))
+
+ifeq ($(TRUSTED_BOARD_BOOT),1)
+# Replace the SHA-256 implementation of mbedtls in all images using it
+$(eval $(call add_define,MBEDTLS_SHA256_ALT))
+
+PLAT_INCLUDES		+=	-I$(APSOC_COMMON)/bl2/sha256
+
+PLAT_BL_COMMON_SOURCES	+=	$(APSOC_COMMON)/bl2/sha256/sha256.c		\
+				$(APSOC_COMMON)/bl2/sha256/sha256_ce.S
+else ifeq ($(DUAL_FIP),1)
+BL2_SOURCES		+=	$(APSOC_COMMON)/bl2/sha256/sha256_ce.S
+endif
+endif
@@ -15,6 +15,14 @@
 
 #include <string.h>
 
+#if defined(SHA256_CE)
+#include <arch_helpers.h>
+#include "sha256_ce.h"
+
+#define ID_AA64ISAR0_SHA2_SHIFT 12
+#define ID_AA64ISAR0_SHA2_MASK  0xf
+#endif
+
 #define SHA256_BLOCK_SIZE 64
 
 void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
@@ -32,6 +40,12 @@ void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
     memset(ctx, 0, sizeof(mbedtls_sha256_context));
 }
 
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst,
+                          const mbedtls_sha256_context *src)
+{
+    *dst = *src;
+}
+
 /*
  * SHA-256 context setup
  */
@@ -204,9 +218,38 @@ static size_t mbedtls_internal_sha256_process_many_c(
     return processed;
 }
 
+#if defined(SHA256_CE)
+/*
+ * The SHA-256 instructions are optional in ARMv8.0 cores, check whether the
+ * core implements them
+ */
+bool sha256_ce_supported(void)
+{
+    static int supported = -1;
+    uint64_t isar0;
+
+    if (supported < 0) {
+        isar0 = read_id_aa64isar0_el1();
+        supported = !!((isar0 >> ID_AA64ISAR0_SHA2_SHIFT) &
+                       ID_AA64ISAR0_SHA2_MASK);
+    }
+
+    return supported;
+}
+#endif
+
 static size_t mbedtls_internal_sha256_process_many(mbedtls_sha256_context *ctx,
                                                    const uint8_t *msg, size_t len)
 {
+#if defined(SHA256_CE)
+    size_t blocks = len / SHA256_BLOCK_SIZE;
+
+    if (sha256_ce_supported()) {
+        sha256_ce_process(ctx->state, msg, blocks);
+        return blocks * SHA256_BLOCK_SIZE;
+    }
+#endif
+
     return mbedtls_internal_sha256_process_many_c(ctx, msg, len);
 }
 
@@ -214,6 +257,13 @@ static
 int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
                                     const unsigned char data[SHA256_BLOCK_SIZE])
 {
+#if defined(SHA256_CE)
+    if (sha256_ce_supported()) {
+        sha256_ce_process(ctx->state, data, 1);
+        return 0;
+    }
+#endif
+
     return mbedtls_internal_sha256_process_c(ctx, data);
 }
 
@@ -337,8 +387,11 @@ exit:
     return ret;
 }
 
+#if !defined(MBEDTLS_SHA256_ALT)
 /*
  * output = SHA-256( input buffer )
+ *
+ * With MBEDTLS_SHA256_ALT, mbedtls provides this on top of the functions above
  */
 int mbedtls_sha256(const unsigned char *input,
                    size_t ilen,
@@ -367,3 +420,4 @@ exit:
 
     return ret;
 }
+#endif /* !MBEDTLS_SHA256_ALT */
@@ -16,22 +16,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-// Regular implementation
-//
-
-/**
- * \brief          The SHA-256 context structure.
- *
- *                 The structure is used both for SHA-256 and for SHA-224
- *                 checksum calculations. The choice between these two is
- *                 made in the call to mbedtls_sha256_starts().
- */
-typedef struct mbedtls_sha256_context {
-    unsigned char buffer[64];   /*!< The data block being processed. */
-    uint32_t total[2];          /*!< The number of Bytes processed.  */
-    uint32_t state[8];          /*!< The intermediate digest state.  */
-}
-mbedtls_sha256_context;
+#include "sha256_alt.h"
 
 /**
  * \brief          This function initializes a SHA-256 context.
@@ -49,6 +34,15 @@ void mbedtls_sha256_init(mbedtls_sha256_context *ctx);
  */
 void mbedtls_sha256_free(mbedtls_sha256_context *ctx);
 
+/**
+ * \brief          This function clones the state of a SHA-256 context.
+ *
+ * \param dst      The destination context. This must be initialized.
+ * \param src      The context to clone. This must be initialized.
+ */
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst,
+                          const mbedtls_sha256_context *src);
+
 /**
  * \brief          This function starts a SHA-224 or SHA-256 checksum
  *                 calculation.
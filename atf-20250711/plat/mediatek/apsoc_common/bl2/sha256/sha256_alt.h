@@ -0,0 +1,30 @@
+/**
+ * \file sha256_alt.h
+ *
+ * \brief SHA-256 context of the implementation replacing the one of mbedtls
+ *        if MBEDTLS_SHA256_ALT is defined.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SHA256_ALT_H
+#define MBEDTLS_SHA256_ALT_H
+
+#include <stdint.h>
+
+/**
+ * \brief          The SHA-256 context structure.
+ *
+ *                 The structure is used both for SHA-256 and for SHA-224
+ *                 checksum calculations. The choice between these two is
+ *                 made in the call to mbedtls_sha256_starts().
+ */
+typedef struct mbedtls_sha256_context {
+    unsigned char buffer[64];   /*!< The data block being processed. */
+    uint32_t total[2];          /*!< The number of Bytes processed.  */
+    uint32_t state[8];          /*!< The intermediate digest state.  */
+}
+mbedtls_sha256_context;
+
+#endif /* sha256_alt.h */
@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ */
+
+#ifndef _SHA256_CE_H_
+#define _SHA256_CE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+bool sha256_ce_supported(void);
+void sha256_ce_process(uint32_t state[8], const uint8_t *data, size_t blocks);
+
+#endif /* _SHA256_CE_H_ */
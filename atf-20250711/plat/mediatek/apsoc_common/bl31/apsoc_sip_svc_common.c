@@ -239,6 +239,30 @@ static uintptr_t apsoc_sip_fw_dec_image(uint32_t smc_fid, u_register_t x1,
 	ret = fw_dec_image(x1, x2);
 	SMC_RET1(handle, ret);
 }
+
+static uintptr_t apsoc_sip_fw_dec_image_chunk(uint32_t smc_fid,
+					      u_register_t x1,
+					      u_register_t x2,
+					      u_register_t x3,
+					      u_register_t x4, void *cookie,
+					      void *handle, u_register_t flags)
+{
+	int ret = 0;
+
+	ret = fw_dec_image_chunk(x1, x2, x3);
+	SMC_RET1(handle, ret);
+}
+
+static uintptr_t apsoc_sip_fw_dec_get_features(uint32_t smc_fid,
+					       u_register_t x1,
+					       u_register_t x2,
+					       u_register_t x3,
+					       u_register_t x4, void *cookie,
+					       void *handle,
+					       u_register_t flags)
+{
+	SMC_RET1(handle, FW_DEC_FEAT_IMAGE_CHUNK);
+}
 #endif /* MTK_FW_ENC_VIA_BL31 */
 
 #ifdef MTK_FW_ENC_VIA_OPTEE
@@ -276,6 +300,10 @@ struct mtk_sip_call_record apsoc_common_sip_calls[] = {
 	MTK_SIP_CALL_RECORD(MTK_SIP_FW_DEC_SET_IV, apsoc_sip_fw_dec_set_iv),
 	MTK_SIP_CALL_RECORD(MTK_SIP_FW_DEC_SET_KEY, apsoc_sip_fw_dec_set_key),
 	MTK_SIP_CALL_RECORD(MTK_SIP_FW_DEC_IMAGE, apsoc_sip_fw_dec_image),
+	MTK_SIP_CALL_RECORD(MTK_SIP_FW_DEC_IMAGE_CHUNK,
+			    apsoc_sip_fw_dec_image_chunk),
+	MTK_SIP_CALL_RECORD(MTK_SIP_FW_DEC_GET_FEATURES,
+			    apsoc_sip_fw_dec_get_features),
 #endif
 };
 
@@ -215,6 +215,36 @@ struct mtk_sip_call_record;
  */
 #define MTK_SIP_GET_KEY				0xC2000583
 
+/*
+ * MTK_SIP_FW_DEC_IMAGE_CHUNK - Decrypt a chunk of an image for firmware
+ *                              encryption
+ *
+ * Chunks of up to 1MiB, multiple of 16 bytes, are decrypted in place in the
+ * order of the image after MTK_SIP_FW_DEC_SET_KEY and MTK_SIP_FW_DEC_SET_IV.
+ * The CBC state is kept between calls until the last chunk.
+ *
+ * parameters
+ * @x1:		chunk physical address
+ * @x2:		chunk size
+ * @x3:		flags, bit 0 set for the last chunk of the image
+ *
+ * return
+ * @r0:		status
+ */
+#define MTK_SIP_FW_DEC_IMAGE_CHUNK		0xC2000584
+
+/*
+ * MTK_SIP_FW_DEC_GET_FEATURES - Get optional firmware decryption calls
+ *                               supported by BL31
+ *
+ * BL31 without this call returns SMC_UNK, and supports none of them.
+ *
+ * return
+ * @r0:		feature bits, bit 0 set if MTK_SIP_FW_DEC_IMAGE_CHUNK is
+ *		supported
+ */
+#define MTK_SIP_FW_DEC_GET_FEATURES		0xC2000585
+
 /* ApSoC common SiP function call records */
 extern struct mtk_sip_call_record apsoc_common_sip_calls[];
 extern struct mtk_sip_call_record apsoc_common_sip_calls_from_sec[];
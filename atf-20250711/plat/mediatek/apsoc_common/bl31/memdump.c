@@ -19,12 +19,21 @@
 #include <mtk_wdt.h>
 #include <plat_mdump_def.h>
 #include <net_common.h>
+#ifdef EMERG_MEM_DUMP_LZ4
+#include <tf_lz4.h>
+#endif
 #include "bl31_common_setup.h"
 #include "memdump.h"
 
 #define PAYLOAD_OFFSET		(ETHER_HDR_SIZE + IP_HDR_SIZE + UDP_HDR_SIZE)
 #define PAYLOAD_MAX_LEN		(ETHER_MTU - PAYLOAD_OFFSET)
 
+#define ENC_DATA_MAX_LEN	(PAYLOAD_MAX_LEN - \
+				 sizeof(struct mdump_range_enc_header))
+
+/* Memory ranges are encoded page by page in packet version 2 */
+#define MDUMP_PAGE_SIZE		0x1000
+
 static const struct mdump_range *__mdump_ranges;
 static size_t __mdump_range_count;
 
@@ -34,6 +43,12 @@ static struct in_addr sipaddr = { .s_un.s_un_b = { 192, 168, 1, 1 } };
 static struct in_addr dipaddr = { .s_un.s_un_b = { 255, 255, 255, 255 } };
 static uint8_t __aligned(64) packet[ETHER_MTU];
 static uint8_t __aligned(64) payload[PAYLOAD_MAX_LEN];
+static uint8_t __aligned(64) page_buf[MDUMP_PAGE_SIZE];
+static uint8_t *tx_frame;
+
+#ifdef EMERG_MEM_DUMP_LZ4
+static uint16_t lz4_table[LZ4_HASH_SIZE];
+#endif
 
 static uint32_t assoc_id;
 static bool rnd_sip = true;
@@ -43,20 +58,49 @@ static uint32_t nego_ver = MDUMP_PACKET_VERSION;
 /* Private exported functions from psci_system_off.c */
 void __dead2 psci_system_reset(void);
 
-static void net_send_packet(uint32_t len)
+/* Get the UDP payload of the frame in the next TX DMA buffer */
+static uint8_t *net_tx_payload(void)
 {
-	int ret;
+	do {
+		tx_frame = mtk_eth_tx_buf();
+	} while (!tx_frame);
 
-	net_set_ether(packet, dstaddr, macaddr, PROT_IP);
+	return tx_frame + PAYLOAD_OFFSET;
+}
 
-	memcpy(packet + PAYLOAD_OFFSET, payload, len);
+/* Send the frame of net_tx_payload() with @len bytes of payload */
+static void net_tx_send(uint32_t len)
+{
+	net_set_ether(tx_frame, dstaddr, macaddr, PROT_IP);
 
-	net_set_udp_header(packet + ETHER_HDR_SIZE, dipaddr, sipaddr,
+	net_set_udp_header(tx_frame + ETHER_HDR_SIZE, dipaddr, sipaddr,
 			   MDUMP_DST_PORT, MDUMP_SRC_PORT, len);
 
-	do {
-		ret = mtk_eth_send(packet, PAYLOAD_OFFSET + len);
-	} while (ret == -EPERM);
+	mtk_eth_tx_buf_send(PAYLOAD_OFFSET + len);
+}
+
+static void net_send_packet(uint32_t len)
+{
+	memcpy(net_tx_payload(), payload, len);
+	net_tx_send(len);
+}
+
+/*
+ * Read the dumped memory, which may be mapped non-cacheable, with 64-bit
+ * accesses if possible
+ */
+static void mdump_read_mem(void *dst, const void *src, size_t len)
+{
+	const uint64_t *s = src;
+	uint64_t *d = dst;
+
+	if (((uintptr_t)dst | (uintptr_t)src | len) & (sizeof(uint64_t) - 1)) {
+		memcpy(dst, src, len);
+		return;
+	}
+
+	for (len /= sizeof(uint64_t); len; len--)
+		*d++ = *s++;
 }
 
 static void arp_receive(void *pkt, uint32_t len)
@@ -242,8 +286,8 @@ static void send_mdump_control_header(void)
 		if (ch->ranges[i].end == DRAM_END)
 			ch->ranges[i].end = DRAM_START + mtk_bl31_get_dram_size();
 
-		ch->ranges[i].addr = htole32(ch->ranges[i].addr);
-		ch->ranges[i].end = htole32(ch->ranges[i].end);
+		ch->ranges[i].addr = htole64(ch->ranges[i].addr);
+		ch->ranges[i].end = htole64(ch->ranges[i].end);
 	}
 
 	ch->bh.checksum = tf_crc32(0, payload, len);
@@ -268,7 +312,7 @@ static void send_mdump_mem_packet(uint32_t index, uintptr_t paddr,
 	rh->size = htole32(len);
 	rh->offset = htole64(paddr);
 
-	memcpy(rh->data, ptr, len);
+	mdump_read_mem(rh->data, ptr, len);
 
 	rh->bh.checksum = tf_crc32(0, payload, pktlen);
 	rh->bh.checksum = htole32(rh->bh.checksum);
@@ -276,6 +320,171 @@ static void send_mdump_mem_packet(uint32_t index, uintptr_t paddr,
 	net_send_packet(pktlen);
 }
 
+/*
+ * Fill in the header of the encoded range packet whose data was written to
+ * the TX buffer after it, and send it
+ */
+static void send_mdump_enc_packet(uint32_t index, uintptr_t paddr,
+				  uint64_t size, uint16_t encoding,
+				  uint32_t data_size)
+{
+	struct mdump_range_enc_header rh;
+	uint8_t *pl = tx_frame + PAYLOAD_OFFSET;
+	uint32_t crc;
+
+	rh.bh.magic = htole32(MDUMP_MAGIC_RANGE_ENC);
+	rh.bh.checksum = 0;
+	rh.bh.version = htole32(nego_ver);
+	rh.bh.assoc_id = htole32(assoc_id);
+	rh.index = htole32(index);
+	rh.encoding = htole16(encoding);
+	rh.data_size = htole16(data_size);
+	rh.offset = htole64(paddr);
+	rh.size = htole64(size);
+
+	crc = tf_crc32(0, (uint8_t *)&rh, sizeof(rh));
+	crc = tf_crc32(crc, pl + sizeof(rh), data_size);
+	rh.bh.checksum = htole32(crc);
+
+	/* The payload is not 8-byte aligned in the frame */
+	memcpy(pl, &rh, sizeof(rh));
+
+	net_tx_send(sizeof(rh) + data_size);
+}
+
+/* Data area of the encoded range packet in the next TX buffer */
+static uint8_t *mdump_enc_data(void)
+{
+	return net_tx_payload() + sizeof(struct mdump_range_enc_header);
+}
+
+static void send_mdump_fill(uint32_t index, uintptr_t paddr, uint64_t size,
+			    uint64_t val)
+{
+	uint8_t *data;
+
+	if (!size)
+		return;
+
+	data = mdump_enc_data();
+	val = htole64(val);
+	memcpy(data, &val, sizeof(val));
+
+	send_mdump_enc_packet(index, paddr, size, MDUMP_ENC_FILL, sizeof(val));
+}
+
+/* Check whether the page in page_buf is filled with one 64-bit value */
+static bool mdump_page_uniform(size_t len, uint64_t *val)
+{
+	const uint64_t *p = (const uint64_t *)page_buf;
+	size_t i;
+
+	if (len & (sizeof(uint64_t) - 1))
+		return false;
+
+	for (i = 1; i < len / sizeof(uint64_t); i++) {
+		if (p[i] != p[0])
+			return false;
+	}
+
+	*val = p[0];
+
+	return true;
+}
+
+/* Send the page in page_buf compressed if possible, raw otherwise */
+static void send_mdump_page(uint32_t index, uintptr_t paddr, size_t len)
+{
+	uint32_t chksz;
+	uint8_t *data;
+	size_t off;
+#ifdef EMERG_MEM_DUMP_LZ4
+	int ret;
+
+	data = mdump_enc_data();
+
+	ret = lz4_compress_block(page_buf, len, data, ENC_DATA_MAX_LEN,
+				 lz4_table);
+	if (ret > 0 && (size_t)ret < len) {
+		send_mdump_enc_packet(index, paddr, len, MDUMP_ENC_LZ4, ret);
+		return;
+	}
+#endif
+
+	for (off = 0; off < len; off += chksz) {
+		chksz = ENC_DATA_MAX_LEN;
+		if (chksz > len - off)
+			chksz = len - off;
+
+		data = mdump_enc_data();
+		memcpy(data, page_buf + off, chksz);
+
+		send_mdump_enc_packet(index, paddr + off, chksz, MDUMP_ENC_RAW,
+				      chksz);
+	}
+}
+
+/*
+ * Send a memory range page by page with packet version 2. Runs of pages
+ * filled with the same value, mostly zero, are sent as a single packet.
+ */
+static void send_mdump_mem_range_enc(uint32_t index, uintptr_t paddr,
+				     uintptr_t vaddr, size_t len,
+				     bool show_progress)
+{
+	uint32_t percentage = 0, last_percentage = 0;
+	uintptr_t fill_addr = paddr;
+	uint64_t fill_size = 0, fill_val = 0, val;
+	size_t len_sent = 0, blksz;
+
+	while (len_sent < len) {
+		blksz = MDUMP_PAGE_SIZE -
+			((paddr + len_sent) & (MDUMP_PAGE_SIZE - 1));
+		if (blksz > len - len_sent)
+			blksz = len - len_sent;
+
+		mdump_read_mem(page_buf, (const void *)(vaddr + len_sent),
+			       blksz);
+
+		if (mdump_page_uniform(blksz, &val)) {
+			if (!fill_size || val != fill_val) {
+				send_mdump_fill(index, fill_addr, fill_size,
+						fill_val);
+				fill_addr = paddr + len_sent;
+				fill_size = 0;
+				fill_val = val;
+			}
+
+			fill_size += blksz;
+		} else {
+			send_mdump_fill(index, fill_addr, fill_size, fill_val);
+			fill_size = 0;
+
+			send_mdump_page(index, paddr + len_sent, blksz);
+		}
+
+		len_sent += blksz;
+
+		percentage = (uint64_t)len_sent * 100ULL / len;
+		if (show_progress && percentage > last_percentage) {
+			last_percentage = percentage;
+#if LOG_LEVEL >= LOG_LEVEL_NOTICE
+			printf("\r");
+#endif
+			NOTICE("MDUMP: %u%% completed.", percentage);
+		}
+
+		process_other_packets();
+	}
+
+	send_mdump_fill(index, fill_addr, fill_size, fill_val);
+
+#if LOG_LEVEL >= LOG_LEVEL_NOTICE
+	if (show_progress)
+		printf("\n");
+#endif
+}
+
 static void send_mdump_mem_range(uint32_t index, uintptr_t paddr,
 				 uintptr_t vaddr, size_t len,
 				 bool show_progress)
@@ -284,6 +493,12 @@ static void send_mdump_mem_range(uint32_t index, uintptr_t paddr,
 	const void *ptr = (const void *)vaddr;
 	size_t len_sent = 0;
 
+	if (nego_ver >= 2) {
+		send_mdump_mem_range_enc(index, paddr, vaddr, len,
+					 show_progress);
+		return;
+	}
+
 	while (len_sent < len) {
 		chksz = sizeof(payload) - sizeof(struct mdump_range_header);
 		chksz &= ~(sizeof(uint32_t) - 1);
@@ -694,7 +909,7 @@ static int mdump_control_check(void)
 		if (le32toh(resp.type) != MDUMP_RESP_CONTROL_ACK)
 			continue;
 
-		peer_ver = resp.bh.version;
+		peer_ver = le32toh(resp.bh.version);
 
 		break;
 	}
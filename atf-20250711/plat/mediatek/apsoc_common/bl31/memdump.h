@@ -56,6 +56,26 @@ struct mdump_range_header {
 	uint8_t data[];	/* Make sure this is 8-byte aligned */
 };
 
+/*
+ * Range data of packet version 2. @size bytes of memory at @offset are
+ * described by @data_size bytes of data, depending on @encoding.
+ */
+struct mdump_range_enc_header {
+	struct mdump_basic_header bh;
+	uint32_t index;
+	uint16_t encoding;
+	uint16_t data_size;
+	uint64_t offset;
+	uint64_t size;
+	uint8_t data[];
+};
+
+enum mdump_range_encoding {
+	MDUMP_ENC_RAW,		/* Memory content */
+	MDUMP_ENC_FILL,		/* 64-bit value the memory is filled with */
+	MDUMP_ENC_LZ4,		/* LZ4 block of the memory content */
+};
+
 struct mdump_range_end_header {
 	struct mdump_basic_header bh;
 	uint32_t index;
@@ -162,8 +182,10 @@ struct mdump_response_header {
 #define MDUMP_MAGIC_CORE_DATA			0x4443444d	/* MDCD */
 #define MDUMP_MAGIC_END				0x4445444d	/* MDED */
 #define MDUMP_MAGIC_RESPONSE			0x5052444d	/* MDRP */
+#define MDUMP_MAGIC_RANGE_ENC			0x5a52444d	/* MDRZ */
 
-#define MDUMP_PACKET_VERSION			1
+/* Version 2 sends memory ranges as encoded range data (MDRZ) */
+#define MDUMP_PACKET_VERSION			2
 
 #define MDUMP_SRC_PORT				12700
 #define MDUMP_DST_PORT				12700
@@ -24,6 +24,11 @@ BL31_CPPFLAGS		+=	-DEMERG_MEM_DUMP				\
 				-DEMERG_MEM_DUMP_AUTONEG_TIMEOUT=$(EMERG_MEM_DUMP_AUTONEG_TIMEOUT)
 BL31_CFLAGS		+=	-march=armv8-a+crc
 
+ifeq ($(EMERG_MEM_DUMP_LZ4),1)
+BL31_SOURCES		+=	lib/lz4/tf_lz4.c
+BL31_CPPFLAGS		+=	-Iinclude/lib/lz4 -DEMERG_MEM_DUMP_LZ4
+endif
+
 ifeq ($(MTK_ETH_USE_I2P5G_PHY),1)
 BL31_SOURCES		+=	$(APSOC_COMMON)/drivers/eth/phy.c		\
 				$(APSOC_COMMON)/drivers/eth/mtk-i2p5ge.c
@@ -36,7 +41,7 @@ endif
 include make_helpers/dep.mk
 
 $(call GEN_DEP_RULES,bl31,memdump mtk_eth mtk-i2p5ge)
-$(call MAKE_DEP,bl31,memdump,EMERG_MEM_DUMP EMERG_MEM_DUMP_AUTONEG_TIMEOUT)
+$(call MAKE_DEP,bl31,memdump,EMERG_MEM_DUMP EMERG_MEM_DUMP_AUTONEG_TIMEOUT EMERG_MEM_DUMP_LZ4)
 $(call MAKE_DEP,bl31,mtk_eth,MTK_ETH_USE_I2P5G_PHY MTK_ETH_AUTONEG_TIMEOUT)
 $(call MAKE_DEP,bl31,mtk-i2p5ge,MTK_ETH_I2P5G_PHY_FW_LOAD MTK_ETH_AUTONEG_TIMEOUT)
 
@@ -944,22 +944,37 @@ void mtk_eth_write_hwaddr(const uint8_t *addr)
 	mtk_gdma_write(priv, GMAC_ID, GDMA_MAC_LSB_REG, macaddr_lsb);
 }
 
-int mtk_eth_send(const void *packet, uint32_t length)
+/*
+ * Get the buffer of the next TX descriptor, for a packet to be built in place
+ * and sent by mtk_eth_tx_buf_send(). Returns NULL while the TX ring is full.
+ */
+void *mtk_eth_tx_buf(void)
 {
 	struct mtk_eth_priv *priv = &_eth_priv;
 	u32 idx = priv->tx_cpu_owner_idx0;
 	struct mtk_tx_dma_v2 *txd;
-	void *pkt_base;
 
 	txd = priv->tx_ring_noc + idx * TXD_SIZE;
 
 	if (!(txd->txd2 & PDMA_TXD2_DDONE)) {
 		VERBOSE("mtk-eth: TX DMA descriptor ring is full\n");
-		return -EPERM;
+		return NULL;
 	}
 
+	return (void *)((uintptr_t)txd->txd1 - priv->pkt_pool_pa + priv->pkt_pool_va);
+}
+
+/* Send the packet built in the buffer returned by mtk_eth_tx_buf() */
+void mtk_eth_tx_buf_send(uint32_t length)
+{
+	struct mtk_eth_priv *priv = &_eth_priv;
+	u32 idx = priv->tx_cpu_owner_idx0;
+	struct mtk_tx_dma_v2 *txd;
+	void *pkt_base;
+
+	txd = priv->tx_ring_noc + idx * TXD_SIZE;
 	pkt_base = (void *)((uintptr_t)txd->txd1 - priv->pkt_pool_pa + priv->pkt_pool_va);
-	memcpy(pkt_base, packet, length);
+
 	clean_dcache_range((uintptr_t)pkt_base,
 			   roundup(length, ARCH_DMA_MINALIGN));
 
@@ -971,6 +986,18 @@ int mtk_eth_send(const void *packet, uint32_t length)
 
 	priv->tx_cpu_owner_idx0 = (priv->tx_cpu_owner_idx0 + 1) % NUM_TX_DESC;
 	mtk_pdma_write(priv, TX_CTX_IDX_REG(0), priv->tx_cpu_owner_idx0);
+}
+
+int mtk_eth_send(const void *packet, uint32_t length)
+{
+	void *pkt_base;
+
+	pkt_base = mtk_eth_tx_buf();
+	if (!pkt_base)
+		return -EPERM;
+
+	memcpy(pkt_base, packet, length);
+	mtk_eth_tx_buf_send(length);
 
 	return 0;
 }
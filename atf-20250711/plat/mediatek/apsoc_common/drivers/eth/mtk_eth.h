@@ -58,6 +58,8 @@ int mtk_eth_start(void);
 void mtk_eth_stop(void);
 void mtk_eth_write_hwaddr(const uint8_t *addr);
 int mtk_eth_send(const void *packet, uint32_t length);
+void *mtk_eth_tx_buf(void);
+void mtk_eth_tx_buf_send(uint32_t length);
 int mtk_eth_recv(void **packetp);
 int mtk_eth_free_pkt(void *packet);
 
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * MSDC DMA descriptor helpers. Only descriptors and register values are
+ * computed here, the controller itself is programmed by mtk-sd.c.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "mtk-sd-dma.h"
+
+#define LO32(x)		((uint32_t)(x))
+#define HI32(x)		((uint32_t)((uint64_t)(x) >> 32))
+
+uint8_t msdc_dma_checksum(const void *buf, uint32_t len)
+{
+	const uint8_t *p = buf;
+	uint8_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		sum += p[i];
+
+	return 0xff - sum;
+}
+
+bool msdc_dma_capable(uint64_t addr, size_t size, uint32_t align)
+{
+	if (!size)
+		return false;
+
+	/*
+	 * The buffer must occupy whole cache lines. Otherwise invalidating it
+	 * would discard data sharing its first or last cache line.
+	 */
+	if ((addr % align) || (size % align))
+		return false;
+
+	return addr + size <= MSDC_DMA_ADDR_LIMIT;
+}
+
+void msdc_dma_init_desc(struct msdc_dma *dma, struct msdc_gpd *gpd,
+			uint64_t gpd_addr, struct msdc_bd *bd,
+			uint64_t bd_addr, uint32_t max_bd)
+{
+	uint64_t next;
+	uint32_t i;
+
+	memset(gpd, 0, 2 * sizeof(*gpd));
+	memset(bd, 0, max_bd * sizeof(*bd));
+
+	dma->gpd = gpd;
+	dma->bd = bd;
+	dma->gpd_addr = gpd_addr;
+	dma->bd_addr = bd_addr;
+	dma->max_bd = max_bd;
+
+	/* gpd[0] points to the BD table and is chained to the null gpd[1] */
+	next = gpd_addr + sizeof(*gpd);
+
+	gpd->gpd_info = GPDMA_DESC_BDP;
+	gpd->gpd_info |= (HI32(next) << GPDMA_DESC_NEXT_H4_S) &
+			 GPDMA_DESC_NEXT_H4_M;
+	gpd->gpd_info |= (HI32(bd_addr) << GPDMA_DESC_PTR_H4_S) &
+			 GPDMA_DESC_PTR_H4_M;
+	gpd->next = LO32(next);
+	gpd->ptr = LO32(bd_addr);
+
+	for (i = 0; i + 1 < max_bd; i++) {
+		next = bd_addr + (i + 1) * sizeof(*bd);
+
+		bd[i].next = LO32(next);
+		bd[i].bd_info = (HI32(next) << BDMA_DESC_NEXT_H4_S) &
+				BDMA_DESC_NEXT_H4_M;
+	}
+}
+
+int msdc_dma_build_desc(struct msdc_dma *dma, uint64_t addr, size_t size,
+			struct msdc_dma_regs *regs)
+{
+	struct msdc_gpd *gpd = &dma->gpd[0];
+	struct msdc_bd *bd;
+	uint32_t chksz;
+	size_t nbd, i;
+
+	if (!size || addr + size > MSDC_DMA_ADDR_LIMIT)
+		return -EINVAL;
+
+	nbd = (size + MSDC_BD_MAX_LEN - 1) / MSDC_BD_MAX_LEN;
+	if (nbd > dma->max_bd)
+		return -E2BIG;
+
+	for (i = 0; i < nbd; i++) {
+		bd = &dma->bd[i];
+		chksz = size < MSDC_BD_MAX_LEN ? size : MSDC_BD_MAX_LEN;
+
+		bd->bd_info &= ~(BDMA_DESC_EOL | BDMA_DESC_CHECKSUM_M |
+				 BDMA_DESC_BLKPAD | BDMA_DESC_DWPAD |
+				 BDMA_DESC_PTR_H4_M);
+		bd->bd_info |= (HI32(addr) << BDMA_DESC_PTR_H4_S) &
+			       BDMA_DESC_PTR_H4_M;
+		bd->ptr = LO32(addr);
+		bd->bd_data_len = chksz & BDMA_DESC_BUFLEN_M;
+
+		if (i == nbd - 1)
+			bd->bd_info |= BDMA_DESC_EOL;
+
+		bd->bd_info |= msdc_dma_checksum(bd, MSDC_DESC_CHECKSUM_LEN) <<
+			       BDMA_DESC_CHECKSUM_S;
+
+		addr += chksz;
+		size -= chksz;
+	}
+
+	/* Hand the GPD over to the hardware */
+	gpd->gpd_info |= GPDMA_DESC_HWO;
+	gpd->gpd_info &= ~GPDMA_DESC_CHECKSUM_M;
+	gpd->gpd_info |= msdc_dma_checksum(gpd, MSDC_DESC_CHECKSUM_LEN) <<
+			 GPDMA_DESC_CHECKSUM_S;
+
+	regs->sa_high4bit = HI32(dma->gpd_addr) & MSDC_DMA_ADDR_HIGH4BIT_M;
+	regs->sa = LO32(dma->gpd_addr);
+	regs->ctrl = MSDC_DMA_CTRL_MODE |
+		     (MSDC_BURST_64B << MSDC_DMA_CTRL_BURSTSZ_S);
+	regs->cfg = MSDC_DMA_CFG_DECSEN;
+	regs->length = 0;
+
+	return 0;
+}
+
+int msdc_dma_build_basic(uint64_t addr, size_t size,
+			 struct msdc_dma_regs *regs)
+{
+	if (!size || size > MSDC_DMA_BASIC_MAX_LEN ||
+	    addr + size > MSDC_DMA_ADDR_LIMIT)
+		return -EINVAL;
+
+	regs->sa_high4bit = HI32(addr) & MSDC_DMA_ADDR_HIGH4BIT_M;
+	regs->sa = LO32(addr);
+	regs->ctrl = MSDC_DMA_CTRL_LASTBUF |
+		     (MSDC_BURST_64B << MSDC_DMA_CTRL_BURSTSZ_S);
+	regs->cfg = 0;
+	regs->length = (uint32_t)size;
+
+	return 0;
+}
+
+/*
+ * Pick the transfer mode for a buffer: descriptor DMA if the BD table is
+ * large enough, basic DMA for longer transfers and PIO for buffers the DMA
+ * engine can not be used with.
+ */
+enum msdc_xfer_mode msdc_dma_setup(struct msdc_dma *dma, uint64_t addr,
+				   size_t size, uint32_t align,
+				   struct msdc_dma_regs *regs)
+{
+	if (!msdc_dma_capable(addr, size, align))
+		return MSDC_XFER_PIO;
+
+	if (dma && dma->max_bd && !msdc_dma_build_desc(dma, addr, size, regs))
+		return MSDC_XFER_DMA_DESC;
+
+	if (!msdc_dma_build_basic(addr, size, regs))
+		return MSDC_XFER_DMA_BASIC;
+
+	return MSDC_XFER_PIO;
+}
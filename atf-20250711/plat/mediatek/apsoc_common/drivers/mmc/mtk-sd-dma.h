@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * MSDC DMA descriptor helpers. This header and mtk-sd-dma.c do not depend on
+ * any TF-A header so that they can also be built on the host for testing.
+ */
+
+#ifndef __MTK_SD_DMA_H__
+#define __MTK_SD_DMA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* MSDC_DMA_CTRL */
+#define MSDC_DMA_CTRL_START		0x1
+#define MSDC_DMA_CTRL_STOP		0x2
+#define MSDC_DMA_CTRL_RESUME		0x4
+#define MSDC_DMA_CTRL_MODE		0x100
+#define MSDC_DMA_CTRL_LASTBUF		0x400
+#define MSDC_DMA_CTRL_BURSTSZ_M		0x7000
+#define MSDC_DMA_CTRL_BURSTSZ_S		12
+
+/* MSDC_DMA_CFG */
+#define MSDC_DMA_CFG_STS		0x1
+#define MSDC_DMA_CFG_DECSEN		0x2
+
+/* DMA_SA_HIGH4BIT */
+#define MSDC_DMA_ADDR_HIGH4BIT_M	0xf
+
+#define MSDC_BURST_64B			6
+
+/* General Purpose Descriptor */
+#define GPDMA_DESC_HWO			0x1
+#define GPDMA_DESC_BDP			0x2
+#define GPDMA_DESC_CHECKSUM_M		0xff00
+#define GPDMA_DESC_CHECKSUM_S		8
+#define GPDMA_DESC_NEXT_H4_M		0xf000000
+#define GPDMA_DESC_NEXT_H4_S		24
+#define GPDMA_DESC_PTR_H4_M		0xf0000000
+#define GPDMA_DESC_PTR_H4_S		28
+
+/* Buffer Descriptor */
+#define BDMA_DESC_EOL			0x1
+#define BDMA_DESC_CHECKSUM_M		0xff00
+#define BDMA_DESC_CHECKSUM_S		8
+#define BDMA_DESC_BLKPAD		0x20000
+#define BDMA_DESC_DWPAD			0x40000
+#define BDMA_DESC_NEXT_H4_M		0xf000000
+#define BDMA_DESC_NEXT_H4_S		24
+#define BDMA_DESC_PTR_H4_M		0xf0000000
+#define BDMA_DESC_PTR_H4_S		28
+#define BDMA_DESC_BUFLEN_M		0xffff
+
+/* Bytes covered by the checksum of both descriptor types */
+#define MSDC_DESC_CHECKSUM_LEN		16
+
+/* Largest block-aligned length a single BD can carry */
+#define MSDC_BD_MAX_LEN			0xf000
+
+/* Highest bus address reachable through the 4 extra address bits */
+#define MSDC_DMA_ADDR_LIMIT		(1ULL << 36)
+
+/* Basic DMA takes the whole length in the 32-bit DMA_LENGTH register */
+#define MSDC_DMA_BASIC_MAX_LEN		0xffffff00U
+
+enum msdc_xfer_mode {
+	MSDC_XFER_PIO,
+	MSDC_XFER_DMA_BASIC,
+	MSDC_XFER_DMA_DESC,
+};
+
+struct msdc_gpd {
+	uint32_t gpd_info;
+	uint32_t next;
+	uint32_t ptr;
+	uint32_t gpd_data_len;
+	uint32_t arg;
+	uint32_t blknum;
+	uint32_t cmd;
+};
+
+struct msdc_bd {
+	uint32_t bd_info;
+	uint32_t next;
+	uint32_t ptr;
+	uint32_t bd_data_len;
+};
+
+/*
+ * Descriptor memory: gpd[0] is the active descriptor and gpd[1] the null
+ * descriptor terminating the chain, bd[] holds the buffer descriptors the
+ * transfer is split into.
+ */
+struct msdc_dma {
+	struct msdc_gpd *gpd;
+	struct msdc_bd *bd;
+	uint64_t gpd_addr;
+	uint64_t bd_addr;
+	uint32_t max_bd;
+};
+
+/* Register values to be programmed for one DMA transfer */
+struct msdc_dma_regs {
+	uint32_t sa_high4bit;
+	uint32_t sa;
+	uint32_t ctrl;
+	uint32_t cfg;
+	uint32_t length;
+};
+
+uint8_t msdc_dma_checksum(const void *buf, uint32_t len);
+bool msdc_dma_capable(uint64_t addr, size_t size, uint32_t align);
+void msdc_dma_init_desc(struct msdc_dma *dma, struct msdc_gpd *gpd,
+			uint64_t gpd_addr, struct msdc_bd *bd,
+			uint64_t bd_addr, uint32_t max_bd);
+int msdc_dma_build_desc(struct msdc_dma *dma, uint64_t addr, size_t size,
+			struct msdc_dma_regs *regs);
+int msdc_dma_build_basic(uint64_t addr, size_t size,
+			 struct msdc_dma_regs *regs);
+enum msdc_xfer_mode msdc_dma_setup(struct msdc_dma *dma, uint64_t addr,
+				   size_t size, uint32_t align,
+				   struct msdc_dma_regs *regs);
+
+#endif /* __MTK_SD_DMA_H__ */
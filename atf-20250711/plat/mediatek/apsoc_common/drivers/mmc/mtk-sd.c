@@ -8,11 +8,17 @@
 #include <drivers/mmc.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <arch_helpers.h>
 #include <lib/mmio.h>
 #include <common/debug.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <platform_def.h>
 
 #include "mtk-sd.h"
+#ifdef MTK_MMC_DMA
+#include "mtk-sd-dma.h"
+#endif
 
 /* MSDC_CFG */
 #define MSDC_CFG_HS400_CK_MODE_EXT	BIT(22)
@@ -153,6 +159,9 @@
 
 #define MSDC_FIFO_SIZE			128
 
+/* Number of BDs, transfers needing more use basic DMA */
+#define MSDC_DMA_MAX_BD			32
+
 #define PAD_DELAY_MAX			32
 
 /* Some SD/MMC commands used by msdc_cmd_prepare_raw_cmd() */
@@ -291,6 +300,19 @@ static size_t xfer_size;
 static uint32_t xfer_blocks;
 static uint32_t xfer_blocksz;
 
+#ifdef MTK_MMC_DMA
+static struct msdc_gpd msdc_gpd[2] __aligned(CACHE_WRITEBACK_GRANULE);
+static struct msdc_bd msdc_bd[MSDC_DMA_MAX_BD] __aligned(CACHE_WRITEBACK_GRANULE);
+static struct msdc_dma msdc_dma;
+
+static enum msdc_xfer_mode xfer_mode;
+#endif
+
+/* Read statistics for the throughput report */
+static uint64_t stat_read_ticks;
+static uint64_t stat_read_bytes;
+static uint64_t stat_dma_bytes;
+
 static struct mmc_device_info mtk_mmc_device_info = {
 	.mmc_dev_type = MMC_IS_SD,
 	.ocr_voltage = OCR_3_2_3_3 | OCR_3_3_3_4,
@@ -649,6 +671,95 @@ static int msdc_ops_set_ios(unsigned int clock, unsigned int bus_width)
 	return 0;
 }
 
+#ifdef MTK_MMC_DMA
+static void msdc_dma_prepare(struct msdc_host *host, uintptr_t buf,
+			     size_t size, int write)
+{
+	struct msdc_dma_regs regs;
+
+	xfer_mode = MSDC_XFER_PIO;
+
+	/* Data is only written by PIO, which is rare in BL2 */
+	if (!write)
+		xfer_mode = msdc_dma_setup(&msdc_dma, buf, size,
+					   CACHE_WRITEBACK_GRANULE, &regs);
+
+	if (xfer_mode == MSDC_XFER_PIO) {
+		mmio_setbits_32((uintptr_t)&host->base->msdc_cfg, MSDC_CFG_PIO);
+		return;
+	}
+
+	if (xfer_mode == MSDC_XFER_DMA_DESC) {
+		flush_dcache_range((uintptr_t)msdc_gpd, sizeof(msdc_gpd));
+		flush_dcache_range((uintptr_t)msdc_bd, sizeof(msdc_bd));
+	}
+
+	inv_dcache_range(buf, size);
+
+	mmio_write_32((uintptr_t)&host->base->dma_sa_high4bit,
+		      regs.sa_high4bit);
+	mmio_write_32((uintptr_t)&host->base->dma_sa, regs.sa);
+	if (xfer_mode == MSDC_XFER_DMA_BASIC)
+		mmio_write_32((uintptr_t)&host->base->dma_length, regs.length);
+
+	mmio_clrsetbits_32((uintptr_t)&host->base->dma_cfg,
+			   MSDC_DMA_CFG_DECSEN, regs.cfg);
+	mmio_clrsetbits_32((uintptr_t)&host->base->dma_ctrl,
+			   MSDC_DMA_CTRL_MODE | MSDC_DMA_CTRL_LASTBUF |
+			   MSDC_DMA_CTRL_BURSTSZ_M, regs.ctrl);
+
+	mmio_clrbits_32((uintptr_t)&host->base->msdc_cfg, MSDC_CFG_PIO);
+}
+
+static int msdc_dma_read(struct msdc_host *host, uintptr_t buf, size_t size)
+{
+	uint32_t cmd_idx, cmd_arg;
+	uint32_t status, reg;
+	int ret = 0;
+
+	cmd_idx = mmio_read_32((uintptr_t)&host->base->sdc_cmd) & 0x3f;
+	cmd_arg = mmio_read_32((uintptr_t)&host->base->sdc_arg);
+
+	mmio_write_32((uintptr_t)&host->base->msdc_int, DATA_INTS_MASK);
+	mmio_setbits_32((uintptr_t)&host->base->dma_ctrl, MSDC_DMA_CTRL_START);
+
+	readl_poll_timeout(&host->base->msdc_int, status,
+			   status & DATA_INTS_MASK, 0);
+	mmio_write_32((uintptr_t)&host->base->msdc_int,
+		      status & DATA_INTS_MASK);
+
+	if (status & MSDC_INT_DATCRCERR) {
+		ERROR("MSDC: CRC error occured while reading data with cmd=%d, arg=0x%x\n",
+			cmd_idx, cmd_arg);
+		ret = -EIO;
+	} else if (status & MSDC_INT_DATTMO) {
+		ERROR("MSDC: timeout occured while reading data with cmd=%d, arg=0x%x\n",
+			cmd_idx, cmd_arg);
+		ret = -ETIMEDOUT;
+	}
+
+	mmio_setbits_32((uintptr_t)&host->base->dma_ctrl, MSDC_DMA_CTRL_STOP);
+	readl_poll_timeout(&host->base->dma_ctrl, reg,
+			   !(reg & MSDC_DMA_CTRL_STOP), 0);
+	readl_poll_timeout(&host->base->dma_cfg, reg,
+			   !(reg & MSDC_DMA_CFG_STS), 0);
+
+	/* Drop lines speculatively fetched while the transfer was running */
+	inv_dcache_range(buf, size);
+
+	if (ret) {
+		msdc_reset_hw(host);
+		msdc_fifo_clr(host);
+		return ret;
+	}
+
+	xfer_size -= size;
+	stat_dma_bytes += size;
+
+	return 0;
+}
+#endif
+
 static int mtk_mmc_prepare(int lba, uintptr_t buf, size_t size, int write)
 {
 	xfer_size = size;
@@ -665,6 +776,10 @@ static int mtk_mmc_prepare(int lba, uintptr_t buf, size_t size, int write)
 	xfer_blocks = (size + xfer_blocksz - 1) / xfer_blocksz;
 	new_xfer = true;
 
+#ifdef MTK_MMC_DMA
+	msdc_dma_prepare(&_host, buf, size, write);
+#endif
+
 	return 0;
 }
 
@@ -713,7 +828,7 @@ static void msdc_fifo_write(struct msdc_host *host, const uint8_t *buf,
 	}
 }
 
-static int mtk_mmc_read(int lba, uintptr_t buf, size_t size)
+static int msdc_read(int lba, uintptr_t buf, size_t size)
 {
 	struct msdc_host *host = &_host;
 
@@ -729,6 +844,11 @@ static int mtk_mmc_read(int lba, uintptr_t buf, size_t size)
 		return -EINVAL;
 	}
 
+#ifdef MTK_MMC_DMA
+	if (xfer_mode != MSDC_XFER_PIO)
+		return msdc_dma_read(host, buf, size);
+#endif
+
 	cmd_idx = mmio_read_32((uintptr_t)&host->base->sdc_cmd) & 0x3f;
 	cmd_arg = mmio_read_32((uintptr_t)&host->base->sdc_arg);
 
@@ -774,6 +894,20 @@ static int mtk_mmc_read(int lba, uintptr_t buf, size_t size)
 	return ret;
 }
 
+static int mtk_mmc_read(int lba, uintptr_t buf, size_t size)
+{
+	uint64_t start = read_cntpct_el0();
+	int ret;
+
+	ret = msdc_read(lba, buf, size);
+	if (!ret) {
+		stat_read_ticks += read_cntpct_el0() - start;
+		stat_read_bytes += size;
+	}
+
+	return ret;
+}
+
 static int mtk_mmc_write(int lba, uintptr_t buf, size_t size)
 {
 	struct msdc_host *host = &_host;
@@ -846,9 +980,14 @@ static void msdc_init_hw(void)
 	/* Configure to MMC/SD mode, clock free running */
 	mmio_setbits_32((uintptr_t)&host->base->msdc_cfg, MSDC_CFG_MODE);
 
-	/* Use PIO mode */
+	/* Use PIO mode until a read selects DMA */
 	mmio_setbits_32((uintptr_t)&host->base->msdc_cfg, MSDC_CFG_PIO);
 
+#ifdef MTK_MMC_DMA
+	msdc_dma_init_desc(&msdc_dma, msdc_gpd, (uintptr_t)msdc_gpd,
+			   msdc_bd, (uintptr_t)msdc_bd, MSDC_DMA_MAX_BD);
+#endif
+
 	/* Reset */
 	msdc_reset_hw(host);
 
@@ -1010,3 +1149,20 @@ enum mmc_device_type mtk_mmc_device_type(void)
 {
 	return mtk_mmc_device_info.mmc_dev_type;
 }
+
+void mtk_mmc_print_stats(void)
+{
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t us;
+
+	if (!stat_read_bytes || !freq)
+		return;
+
+	us = stat_read_ticks * 1000000 / freq;
+	if (!us)
+		us = 1;
+
+	VERBOSE("MSDC: read %" PRIu64 " bytes in %" PRIu64 " us (%" PRIu64 " KiB/s), %" PRIu64 " bytes by DMA\n",
+		stat_read_bytes, us, stat_read_bytes * 1000000 / 1024 / us,
+		stat_dma_bytes);
+}
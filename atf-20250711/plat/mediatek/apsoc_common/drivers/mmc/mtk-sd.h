@@ -22,5 +22,6 @@ void mtk_mmc_init(uintptr_t reg_base, uintptr_t top_reg_base,
 uint64_t mtk_mmc_device_size(void);
 uint32_t mtk_mmc_block_count(void);
 enum mmc_device_type mtk_mmc_device_type(void);
+void mtk_mmc_print_stats(void);
 
 #endif
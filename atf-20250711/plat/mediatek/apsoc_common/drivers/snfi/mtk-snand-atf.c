@@ -45,6 +45,34 @@ int mtk_snand_read_range(struct mtk_snand *snf, uint64_t addr, uint64_t maxaddr,
 
 		col = addr & snf->writesize_mask;
 
+		/* Whole pages up to the end of the block are read at once */
+		if (!col && sizeremain >= 2 * snf->writesize &&
+		    maxaddr - addr >= 2 * snf->writesize) {
+			chunksize = snf->erasesize - (addr & snf->erasesize_mask);
+			if (chunksize > sizeremain)
+				chunksize = sizeremain;
+
+			if (addr + chunksize > maxaddr)
+				chunksize = maxaddr - addr;
+
+			chunksize &= ~snf->writesize_mask;
+
+			ret = mtk_snand_read_pages(snf, addr, buf,
+					chunksize >> snf->writesize_shift,
+					false, NULL);
+			if (ret < 0) {
+				if (retlen)
+					*retlen = len - sizeremain;
+
+				return ret;
+			}
+
+			addr += chunksize;
+			buf += chunksize;
+			sizeremain -= chunksize;
+			continue;
+		}
+
 		chunksize = snf->writesize - col;
 		if (chunksize > sizeremain)
 			chunksize = sizeremain;
@@ -86,6 +86,9 @@ struct snand_mem_org {
 
 typedef int (*snand_select_die_t)(struct mtk_snand *snf, uint32_t dieidx);
 
+/* Supports READ CACHE SEQUENTIAL/RANDOM/END (31h/30h/3Fh) */
+#define SNAND_F_READ_CACHE_SEQ		BIT(0)
+
 enum snand_drv {
 	SNAND_DRV_NO_CHANGE = 0,
 	SNAND_DRV_8mA = 8,
@@ -100,6 +103,7 @@ struct snand_flash_info {
 	const struct snand_io_cap *cap_pl;
 	snand_select_die_t select_die;
 	enum snand_drv drv;
+	uint32_t flags;
 };
 
 #define SNAND_INFO(_model, _id, _memorg, _cap_rd, _cap_pl, ...) \
@@ -161,6 +165,7 @@ struct mtk_snand {
 
 	uint32_t num_dies;
 	snand_select_die_t select_die;
+	bool read_cache_seq;
 
 	uint8_t opcode_rfc;
 	uint8_t opcode_pl;
@@ -204,12 +209,39 @@ int mtk_snand_ecc_decoder_start(struct mtk_snand *snf);
 void mtk_snand_ecc_decoder_stop(struct mtk_snand *snf);
 int mtk_ecc_wait_decoder_done(struct mtk_snand *snf);
 int mtk_ecc_check_decode_error(struct mtk_snand *snf);
-int mtk_ecc_fixup_empty_sector(struct mtk_snand *snf, uint32_t sect);
+int mtk_ecc_fixup_empty_sector(struct mtk_snand *snf, uint8_t *data,
+			       uint32_t sect);
+
+/* NFI_STRADDR holds a 32-bit bus address */
+#define SNFI_DMA_ADDR_LIMIT		0x100000000ULL
+
+bool mtk_snand_dma_capable(uint64_t addr, size_t len);
+uint8_t *mtk_snand_rx_buf(struct mtk_snand *snf, void *buf, bool raw);
+void mtk_snand_bm_swap(struct mtk_snand *snf, uint8_t *data);
 
 int mtk_snand_mac_io(struct mtk_snand *snf, const uint8_t *out, uint32_t outlen,
 		     uint8_t *in, uint32_t inlen);
 int mtk_snand_set_feature(struct mtk_snand *snf, uint32_t addr, uint32_t val);
 
+/*
+ * Primitives used by mtk_snand_seq_read() to read pages out of the chip.
+ * read_cache() transfers the page currently held in the cache of the chip
+ * to the idx-th page of the destination and returns the number of bitflips
+ * corrected, or -EBADMSG for uncorrectable bitflips.
+ */
+struct mtk_snand_seq_ops {
+	int (*page_op)(void *priv, uint32_t page, uint8_t cmd);
+	int (*cmd)(void *priv, uint8_t cmd);
+	int (*wait_ready)(void *priv);
+	int (*read_cache)(void *priv, uint32_t page, uint32_t idx);
+};
+
+int mtk_snand_seq_read(const struct mtk_snand_seq_ops *ops, void *priv,
+		       uint32_t page, uint32_t count, bool cache_read);
+int mtk_snand_seq_read_list(const struct mtk_snand_seq_ops *ops, void *priv,
+			    const uint32_t *pages, uint32_t count,
+			    bool cache_read);
+
 int mtk_snand_log(struct mtk_snand_plat_dev *pdev,
 		  enum mtk_snand_log_category cat, const char *fmt, ...);
 
@@ -249,8 +281,11 @@ static inline int mtk_snand_ffs64(uint64_t x)
 #define SNAND_CMD_READ_FROM_CACHE_DUAL	0xbb
 #define SNAND_CMD_READID		0x9f
 #define SNAND_CMD_READ_FROM_CACHE_X4	0x6b
+#define SNAND_CMD_READ_CACHE_END	0x3f
 #define SNAND_CMD_READ_FROM_CACHE_X2	0x3b
 #define SNAND_CMD_PROGRAM_LOAD_X4	0x32
+#define SNAND_CMD_READ_CACHE_SEQ	0x31
+#define SNAND_CMD_READ_CACHE_RANDOM	0x30
 #define SNAND_CMD_SET_FEATURE		0x1f
 #define SNAND_CMD_READ_TO_CACHE		0x13
 #define SNAND_CMD_PROGRAM_EXECUTE	0x10
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0 OR BSD-3-Clause
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * DMA destination selection of page reads
+ */
+
+#include "mtk-snand-def.h"
+
+bool mtk_snand_dma_capable(uint64_t addr, size_t len)
+{
+	if (!len)
+		return false;
+
+	/*
+	 * The buffer must occupy whole cache lines. Otherwise invalidating it
+	 * would discard data sharing its first or last cache line.
+	 */
+	if ((addr % ARCH_DMA_MINALIGN) || (len % ARCH_DMA_MINALIGN))
+		return false;
+
+	return addr + len <= SNFI_DMA_ADDR_LIMIT;
+}
+
+/*
+ * mtk_snand_rx_buf - Select the DMA destination of a page read
+ * @snf: instance
+ * @buf: caller buffer of the main data, may be NULL
+ * @raw: read without ECC
+ *
+ * With ECC the NFI formats the page by itself. Only the main data is
+ * transferred by DMA and the FDM is read from registers into the spare area
+ * of the page cache. A suitable caller buffer can then receive the data
+ * directly. Raw pages have the spare area interleaved with the data and
+ * always go through the page cache.
+ *
+ * Return the buffer receiving the main data
+ */
+uint8_t *mtk_snand_rx_buf(struct mtk_snand *snf, void *buf, bool raw)
+{
+	if (raw || !buf)
+		return snf->page_cache;
+
+	if (!mtk_snand_dma_capable((uintptr_t)buf, snf->writesize))
+		return snf->page_cache;
+
+	return buf;
+}
+
+/*
+ * Swap the bad block marker position of the main data in @data with the
+ * first FDM byte of the last sector, which is always kept in the page cache
+ */
+void mtk_snand_bm_swap(struct mtk_snand *snf, uint8_t *data)
+{
+	uint32_t buf_bbm_pos, fdm_bbm_pos;
+	uint8_t tmp;
+
+	if (!snf->nfi_soc->bbm_swap || snf->ecc_steps == 1)
+		return;
+
+	buf_bbm_pos = snf->writesize -
+		      (snf->ecc_steps - 1) * snf->spare_per_sector;
+	fdm_bbm_pos = snf->writesize +
+		      (snf->ecc_steps - 1) * snf->nfi_soc->fdm_size;
+
+	tmp = snf->page_cache[fdm_bbm_pos];
+	snf->page_cache[fdm_bbm_pos] = data[buf_bbm_pos];
+	data[buf_bbm_pos] = tmp;
+}
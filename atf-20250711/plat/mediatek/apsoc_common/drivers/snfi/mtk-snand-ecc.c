@@ -371,7 +371,8 @@ static void mtk_ecc_reset_parity(void *buf, uint32_t bits)
 		((uint8_t *)buf)[len] |= GENMASK(bits - 1, 0);
 }
 
-int mtk_ecc_fixup_empty_sector(struct mtk_snand *snf, uint32_t sect)
+int mtk_ecc_fixup_empty_sector(struct mtk_snand *snf, uint8_t *data,
+			       uint32_t sect)
 {
 	uint32_t ecc_bytes = snf->spare_per_sector - snf->nfi_soc->fdm_size;
 	uint8_t *oob = snf->page_cache + snf->writesize;
@@ -381,7 +382,7 @@ int mtk_ecc_fixup_empty_sector(struct mtk_snand *snf, uint32_t sect)
 	parity_bits = fls(snf->nfi_soc->sector_size * 8);
 	ecc_bits = snf->ecc_strength * parity_bits;
 
-	data_ptr = snf->page_cache + sect * snf->nfi_soc->sector_size;
+	data_ptr = data + sect * snf->nfi_soc->sector_size;
 	fdm_ptr = oob + sect * snf->nfi_soc->fdm_size;
 	ecc_ptr = oob + snf->ecc_steps * snf->nfi_soc->fdm_size +
 		  sect * ecc_bytes;
@@ -103,6 +103,8 @@ static inline bool timer_is_timeout(mtk_snand_time_t start_tick,
 }
 
 /* Memory helpers */
+#define ARCH_DMA_MINALIGN		64
+
 void *mtk_snand_mem_alloc(size_t size);
 
 static inline void *generic_mem_alloc(struct mtk_snand_plat_dev *pdev,
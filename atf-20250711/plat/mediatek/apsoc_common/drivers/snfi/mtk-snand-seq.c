@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0 OR BSD-3-Clause
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Command sequencing of multi-page reads
+ */
+
+#include "mtk-snand-def.h"
+
+static int mtk_snand_seq_do_read(const struct mtk_snand_seq_ops *ops,
+				 void *priv, uint32_t page,
+				 const uint32_t *pages, uint32_t count,
+				 bool cache_read)
+{
+	int ret, max_bitflips = 0;
+	bool ecc_failed = false;
+	uint32_t i, curr;
+
+	if (!count)
+		return 0;
+
+	if (count == 1)
+		cache_read = false;
+
+	if (cache_read) {
+		ret = ops->page_op(priv, pages ? pages[0] : page,
+				   SNAND_CMD_READ_TO_CACHE);
+		if (ret)
+			return ret;
+
+		ret = ops->wait_ready(priv);
+		if (ret)
+			return ret;
+	}
+
+	for (i = 0; i < count; i++) {
+		curr = pages ? pages[i] : page + i;
+
+		if (!cache_read)
+			ret = ops->page_op(priv, curr, SNAND_CMD_READ_TO_CACHE);
+		else if (i < count - 1 && pages)
+			ret = ops->page_op(priv, pages[i + 1],
+					   SNAND_CMD_READ_CACHE_RANDOM);
+		else if (i < count - 1)
+			ret = ops->cmd(priv, SNAND_CMD_READ_CACHE_SEQ);
+		else
+			ret = ops->cmd(priv, SNAND_CMD_READ_CACHE_END);
+
+		if (ret)
+			goto abort;
+
+		ret = ops->wait_ready(priv);
+		if (ret)
+			goto abort;
+
+		ret = ops->read_cache(priv, curr, i);
+		if (ret == -EBADMSG) {
+			ecc_failed = true;
+			continue;
+		}
+
+		if (ret < 0)
+			goto abort;
+
+		if (ret > max_bitflips)
+			max_bitflips = ret;
+	}
+
+	return ecc_failed ? -EBADMSG : max_bitflips;
+
+abort:
+	/* The chip may still be loading the next page, leave cache read */
+	if (cache_read && i < count - 1) {
+		ops->cmd(priv, SNAND_CMD_READ_CACHE_END);
+		ops->wait_ready(priv);
+	}
+
+	return ret;
+}
+
+/*
+ * mtk_snand_seq_read - Read consecutive pages of one block
+ * @ops: primitives to access the chip
+ * @priv: argument passed to @ops
+ * @page: first page to read
+ * @count: number of pages to read
+ * @cache_read: use READ CACHE SEQUENTIAL
+ *
+ * With @cache_read, the array read (tR) of the next page runs while the
+ * current page is being transferred out of the cache:
+ *
+ *   13h(P0) 31h read(P0) 31h read(P1) ... 3Fh read(Pn-1)
+ *
+ * Otherwise every page is loaded by its own READ TO CACHE command.
+ *
+ * Reading continues after pages with uncorrectable bitflips. Any other
+ * error aborts the sequence.
+ *
+ * Return max bitflips corrected, -EBADMSG if any page has uncorrectable
+ * bitflips, other negative values for other errors
+ */
+int mtk_snand_seq_read(const struct mtk_snand_seq_ops *ops, void *priv,
+		       uint32_t page, uint32_t count, bool cache_read)
+{
+	return mtk_snand_seq_do_read(ops, priv, page, NULL, count, cache_read);
+}
+
+/*
+ * mtk_snand_seq_read_list - Read arbitrary pages of one die
+ * @ops: primitives to access the chip
+ * @priv: argument passed to @ops
+ * @pages: pages to read
+ * @count: number of pages to read
+ * @cache_read: use READ CACHE RANDOM
+ *
+ * Same as mtk_snand_seq_read(), except that the next page is given by
+ * READ CACHE RANDOM, so it can be anywhere in the die:
+ *
+ *   13h(P0) 30h(P1) read(P0) 30h(P2) read(P1) ... 3Fh read(Pn-1)
+ *
+ * Return max bitflips corrected, -EBADMSG if any page has uncorrectable
+ * bitflips, other negative values for other errors
+ */
+int mtk_snand_seq_read_list(const struct mtk_snand_seq_ops *ops, void *priv,
+			    const uint32_t *pages, uint32_t count,
+			    bool cache_read)
+{
+	return mtk_snand_seq_do_read(ops, priv, 0, pages, count, cache_read);
+}
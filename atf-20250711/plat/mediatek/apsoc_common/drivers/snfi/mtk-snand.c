@@ -307,21 +307,6 @@ static void mtk_snand_bm_swap_raw(struct mtk_snand *snf)
 		   &snf->page_cache[snf->writesize]);
 }
 
-static void mtk_snand_bm_swap(struct mtk_snand *snf)
-{
-	uint32_t buf_bbm_pos, fdm_bbm_pos;
-
-	if (!snf->nfi_soc->bbm_swap || snf->ecc_steps == 1)
-		return;
-
-	buf_bbm_pos = snf->writesize -
-		      (snf->ecc_steps - 1) * snf->spare_per_sector;
-	fdm_bbm_pos = snf->writesize +
-		      (snf->ecc_steps - 1) * snf->nfi_soc->fdm_size;
-	do_bm_swap(&snf->page_cache[fdm_bbm_pos],
-		   &snf->page_cache[buf_bbm_pos]);
-}
-
 static void mtk_snand_fdm_bm_swap_raw(struct mtk_snand *snf)
 {
 	uint32_t fdm_bbm_pos1, fdm_bbm_pos2;
@@ -723,7 +708,8 @@ static int mtk_snand_read_ecc_parity(struct mtk_snand *snf, uint32_t page,
 	return mtk_snand_mac_io(snf, op, sizeof(op), oob + offs, ecc_bytes);
 }
 
-static int mtk_snand_check_ecc_result(struct mtk_snand *snf, uint32_t page)
+static int mtk_snand_check_ecc_result(struct mtk_snand *snf, uint32_t page,
+				      uint8_t *data)
 {
 	uint8_t *oob = snf->page_cache + snf->writesize;
 	int i, rc, ret = 0, max_bitflips = 0;
@@ -739,7 +725,7 @@ static int mtk_snand_check_ecc_result(struct mtk_snand *snf, uint32_t page)
 		if (rc)
 			return rc;
 
-		rc = mtk_ecc_fixup_empty_sector(snf, i);
+		rc = mtk_ecc_fixup_empty_sector(snf, data, i);
 		if (rc < 0) {
 			ret = -EBADMSG;
 
@@ -763,7 +749,8 @@ static int mtk_snand_check_ecc_result(struct mtk_snand *snf, uint32_t page)
 	return ret ? ret : max_bitflips;
 }
 
-static int mtk_snand_read_cache(struct mtk_snand *snf, uint32_t page, bool raw)
+static int mtk_snand_read_cache(struct mtk_snand *snf, uint32_t page,
+				uint8_t *data, bool raw)
 {
 	uint32_t coladdr, rwbytes, mode, len, val;
 	uintptr_t dma_addr;
@@ -800,9 +787,16 @@ static int mtk_snand_read_cache(struct mtk_snand *snf, uint32_t page, bool raw)
 
 	nfi_write32(snf, NFI_CON, (snf->ecc_steps << CON_SEC_NUM_S));
 
-	/* Prepare for DMA read */
-	len = snf->writesize + snf->oobsize;
-	ret = dma_mem_map(snf->pdev, snf->page_cache, &dma_addr, len, false);
+	/*
+	 * Prepare for DMA read. With auto format only the main data is
+	 * transferred, so a caller buffer needs to hold just one page.
+	 */
+	if (data == snf->page_cache)
+		len = snf->writesize + snf->oobsize;
+	else
+		len = snf->writesize;
+
+	ret = dma_mem_map(snf->pdev, data, &dma_addr, len, false);
 	if (ret) {
 		snand_log_nfi(snf->pdev,
 			      "DMA map from device failed with %d\n", ret);
@@ -864,7 +858,7 @@ static int mtk_snand_read_cache(struct mtk_snand *snf, uint32_t page, bool raw)
 		mtk_ecc_check_decode_error(snf);
 		mtk_snand_ecc_decoder_stop(snf);
 
-		ret = mtk_snand_check_ecc_result(snf, page);
+		ret = mtk_snand_check_ecc_result(snf, page, data);
 	}
 
 cleanup:
@@ -915,30 +909,16 @@ static void mtk_snand_from_raw_page(struct mtk_snand *snf, void *buf, void *oob)
 	}
 }
 
-static int mtk_snand_do_read_page(struct mtk_snand *snf, uint64_t addr,
-				  void *buf, void *oob, bool raw, bool format)
+static int mtk_snand_read_cache_calib(struct mtk_snand *snf, uint32_t page,
+				      uint8_t *data, bool raw)
 {
-	uint64_t die_addr;
-	uint32_t page, dly_ctrl3;
+	uint32_t dly_ctrl3;
 	int ret, retry_cnt = 0;
 
-	die_addr = mtk_snand_select_die_address(snf, addr);
-	page = die_addr >> snf->writesize_shift;
-
 	dly_ctrl3 = nfi_read32(snf, SNF_DLY_CTL3);
 
-	ret = mtk_snand_page_op(snf, page, SNAND_CMD_READ_TO_CACHE);
-	if (ret)
-		return ret;
-
-	ret = mtk_snand_poll_status(snf, SNFI_POLL_INTERVAL);
-	if (ret < 0) {
-		snand_log_chip(snf->pdev, "Read to cache command timed out\n");
-		return ret;
-	}
-
 retry:
-	ret = mtk_snand_read_cache(snf, page, raw);
+	ret = mtk_snand_read_cache(snf, page, data, raw);
 	if (ret < 0 && ret != -EBADMSG)
 		return ret;
 
@@ -961,6 +941,12 @@ retry:
 		}
 	}
 
+	return ret;
+}
+
+static void mtk_snand_copy_page(struct mtk_snand *snf, uint8_t *data,
+				void *buf, void *oob, bool raw, bool format)
+{
 	if (raw) {
 		if (format) {
 			mtk_snand_bm_swap_raw(snf);
@@ -977,11 +963,11 @@ retry:
 			}
 		}
 	} else {
-		mtk_snand_bm_swap(snf);
+		mtk_snand_bm_swap(snf, data);
 		mtk_snand_fdm_bm_swap(snf);
 
-		if (buf)
-			memcpy(buf, snf->page_cache, snf->writesize);
+		if (buf && buf != data)
+			memcpy(buf, data, snf->writesize);
 
 		if (oob) {
 			memset(oob, 0xff, snf->oobsize);
@@ -989,6 +975,36 @@ retry:
 			       snf->ecc_steps * snf->nfi_soc->fdm_size);
 		}
 	}
+}
+
+static int mtk_snand_do_read_page(struct mtk_snand *snf, uint64_t addr,
+				  void *buf, void *oob, bool raw, bool format)
+{
+	uint64_t die_addr;
+	uint8_t *data;
+	uint32_t page;
+	int ret;
+
+	die_addr = mtk_snand_select_die_address(snf, addr);
+	page = die_addr >> snf->writesize_shift;
+
+	ret = mtk_snand_page_op(snf, page, SNAND_CMD_READ_TO_CACHE);
+	if (ret)
+		return ret;
+
+	ret = mtk_snand_poll_status(snf, SNFI_POLL_INTERVAL);
+	if (ret < 0) {
+		snand_log_chip(snf->pdev, "Read to cache command timed out\n");
+		return ret;
+	}
+
+	data = mtk_snand_rx_buf(snf, buf, raw);
+
+	ret = mtk_snand_read_cache_calib(snf, page, data, raw);
+	if (ret < 0 && ret != -EBADMSG)
+		return ret;
+
+	mtk_snand_copy_page(snf, data, buf, oob, raw, format);
 
 	return ret;
 }
@@ -1005,6 +1021,141 @@ int mtk_snand_read_page(struct mtk_snand *snf, uint64_t addr, void *buf,
 	return mtk_snand_do_read_page(snf, addr, buf, oob, raw, true);
 }
 
+struct mtk_snand_seq_ctx {
+	struct mtk_snand *snf;
+	struct mtk_snand_read_stats *stats;
+	uint8_t *buf;
+	bool raw;
+};
+
+static int mtk_snand_seq_page_op(void *priv, uint32_t page, uint8_t cmd)
+{
+	struct mtk_snand_seq_ctx *ctx = priv;
+
+	return mtk_snand_page_op(ctx->snf, page, cmd);
+}
+
+static int mtk_snand_seq_cmd(void *priv, uint8_t cmd)
+{
+	struct mtk_snand_seq_ctx *ctx = priv;
+
+	return mtk_snand_mac_io(ctx->snf, &cmd, 1, NULL, 0);
+}
+
+static int mtk_snand_seq_wait_ready(void *priv)
+{
+	struct mtk_snand_seq_ctx *ctx = priv;
+	int ret;
+
+	ret = mtk_snand_poll_status(ctx->snf, SNFI_POLL_INTERVAL);
+	if (ret < 0) {
+		snand_log_chip(ctx->snf->pdev,
+			       "Read to cache command timed out\n");
+		return ret;
+	}
+
+	return 0;
+}
+
+static int mtk_snand_seq_read_cache(void *priv, uint32_t page, uint32_t idx)
+{
+	struct mtk_snand_seq_ctx *ctx = priv;
+	struct mtk_snand *snf = ctx->snf;
+	uint8_t *buf, *data;
+	int ret;
+
+	buf = ctx->buf + (idx << snf->writesize_shift);
+	data = mtk_snand_rx_buf(snf, buf, ctx->raw);
+
+	ret = mtk_snand_read_cache_calib(snf, page, data, ctx->raw);
+	if (ret < 0 && ret != -EBADMSG)
+		return ret;
+
+	mtk_snand_copy_page(snf, data, buf, NULL, ctx->raw, true);
+
+	if (ctx->stats) {
+		if (ret == -EBADMSG)
+			ctx->stats->failed++;
+		else
+			ctx->stats->corrected += ret;
+	}
+
+	return ret;
+}
+
+static const struct mtk_snand_seq_ops mtk_snand_seq_ops = {
+	.page_op = mtk_snand_seq_page_op,
+	.cmd = mtk_snand_seq_cmd,
+	.wait_ready = mtk_snand_seq_wait_ready,
+	.read_cache = mtk_snand_seq_read_cache,
+};
+
+/*
+ * mtk_snand_read_pages - Read main data of consecutive pages
+ * @snf: instance
+ * @addr: page-aligned start address
+ * @buf: buffer of @count pages
+ * @count: number of pages to read
+ * @raw: read without ECC
+ * @stats: optional ECC statistics to be accumulated
+ *
+ * Chips supporting cache read load the next page while the current one is
+ * being transferred. Reading does not stop at pages with uncorrectable
+ * bitflips.
+ *
+ * Return max bitflips corrected, -EBADMSG if any page has uncorrectable
+ * bitflips, other negative values for other errors
+ */
+int mtk_snand_read_pages(struct mtk_snand *snf, uint64_t addr, void *buf,
+			 uint32_t count, bool raw,
+			 struct mtk_snand_read_stats *stats)
+{
+	struct mtk_snand_seq_ctx ctx;
+	uint32_t page, ppb, n;
+	uint64_t die_addr;
+	bool ecc_failed = false;
+	int ret, max_bitflips = 0;
+
+	if (!snf || !buf || !count)
+		return -EINVAL;
+
+	if ((addr & snf->writesize_mask) || addr >= snf->size ||
+	    count > (snf->size - addr) >> snf->writesize_shift)
+		return -EINVAL;
+
+	ctx.snf = snf;
+	ctx.stats = stats;
+	ctx.buf = buf;
+	ctx.raw = raw;
+
+	ppb = 1 << (snf->erasesize_shift - snf->writesize_shift);
+
+	while (count) {
+		die_addr = mtk_snand_select_die_address(snf, addr);
+		page = die_addr >> snf->writesize_shift;
+
+		/* A cache read sequence never crosses a block boundary */
+		n = ppb - (page & (ppb - 1));
+		if (n > count)
+			n = count;
+
+		ret = mtk_snand_seq_read(&mtk_snand_seq_ops, &ctx, page, n,
+					 snf->read_cache_seq);
+		if (ret == -EBADMSG)
+			ecc_failed = true;
+		else if (ret < 0)
+			return ret;
+		else if (ret > max_bitflips)
+			max_bitflips = ret;
+
+		addr += (uint64_t)n << snf->writesize_shift;
+		ctx.buf += (size_t)n << snf->writesize_shift;
+		count -= n;
+	}
+
+	return ecc_failed ? -EBADMSG : max_bitflips;
+}
+
 static void mtk_snand_write_fdm(struct mtk_snand *snf, const uint8_t *buf)
 {
 	uint32_t vall, valm, fdm_size = snf->nfi_soc->fdm_size;
@@ -1251,7 +1402,7 @@ static int mtk_snand_do_write_page(struct mtk_snand *snf, uint64_t addr,
 		}
 
 		mtk_snand_fdm_bm_swap(snf);
-		mtk_snand_bm_swap(snf);
+		mtk_snand_bm_swap(snf, snf->page_cache);
 	}
 
 	ret = mtk_snand_write_enable(snf);
@@ -1743,6 +1894,7 @@ static int mtk_snand_setup(struct mtk_snand *snf,
 	snf->die_shift = mtk_snand_ffs64(snf->die_size) - 1;
 
 	snf->select_die = snand_info->select_die;
+	snf->read_cache_seq = !!(snand_info->flags & SNAND_F_READ_CACHE_SEQ);
 
 	/* Determine opcodes for read from cache/program load */
 	snfi_caps = SPI_IO_1_1_1 | SPI_IO_1_1_2 | SPI_IO_1_2_2;
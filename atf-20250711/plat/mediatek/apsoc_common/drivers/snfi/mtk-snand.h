@@ -46,6 +46,11 @@ struct mtk_snand_chip_info {
 	uint32_t ecc_bytes;
 };
 
+struct mtk_snand_read_stats {
+	uint32_t corrected;	/* Bitflips corrected */
+	uint32_t failed;	/* Pages with uncorrectable bitflips */
+};
+
 struct mtk_snand;
 struct snand_flash_info;
 
@@ -56,6 +61,9 @@ int mtk_snand_cleanup(struct mtk_snand *snf);
 int mtk_snand_chip_reset(struct mtk_snand *snf);
 int mtk_snand_read_page(struct mtk_snand *snf, uint64_t addr, void *buf,
 			void *oob, bool raw);
+int mtk_snand_read_pages(struct mtk_snand *snf, uint64_t addr, void *buf,
+			 uint32_t count, bool raw,
+			 struct mtk_snand_read_stats *stats);
 int mtk_snand_write_page(struct mtk_snand *snf, uint64_t addr, const void *buf,
 			 const void *oob, bool raw);
 int mtk_snand_erase_block(struct mtk_snand *snf, uint64_t addr);
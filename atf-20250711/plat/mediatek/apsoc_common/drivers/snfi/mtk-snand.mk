@@ -8,4 +8,6 @@ MTK_SNAND_SOURCES	:=	$(APSOC_COMMON)/drivers/snfi/mtk-snand.c	\
 				$(APSOC_COMMON)/drivers/snfi/mtk-snand-ecc.c	\
 				$(APSOC_COMMON)/drivers/snfi/mtk-snand-ids.c	\
 				$(APSOC_COMMON)/drivers/snfi/mtk-snand-os.c	\
+				$(APSOC_COMMON)/drivers/snfi/mtk-snand-seq.c	\
+				$(APSOC_COMMON)/drivers/snfi/mtk-snand-dma.c	\
 				$(APSOC_COMMON)/drivers/snfi/mtk-snand-atf.c
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * AES-256 key schedule for the ARMv8 Crypto Extensions CBC decryption
+ */
+
+#include <string.h>
+#include <arch_helpers.h>
+
+#include "aes_ce.h"
+
+#define ID_AA64ISAR0_AES_SHIFT	4
+#define ID_AA64ISAR0_AES_MASK	0xf
+
+static const uint8_t aes_sbox[256] = {
+	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
+	0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+	0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+	0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+	0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc,
+	0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+	0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a,
+	0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+	0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+	0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+	0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b,
+	0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+	0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85,
+	0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+	0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+	0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+	0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17,
+	0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+	0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+	0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+	0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+	0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+	0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9,
+	0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+	0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6,
+	0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+	0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+	0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+	0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94,
+	0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+	0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
+	0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+/*
+ * The AES instructions are optional in ARMv8.0 cores, check whether the
+ * core implements them
+ */
+bool aes_ce_supported(void)
+{
+	static int supported = -1;
+	uint64_t isar0;
+
+	if (supported < 0) {
+		isar0 = read_id_aa64isar0_el1();
+		supported = !!((isar0 >> ID_AA64ISAR0_AES_SHIFT) &
+			       ID_AA64ISAR0_AES_MASK);
+	}
+
+	return supported;
+}
+
+static uint8_t aes_xtime(uint8_t x)
+{
+	return (x << 1) ^ ((x & 0x80) ? 0x1b : 0);
+}
+
+static uint8_t aes_mul(uint8_t x, uint8_t y)
+{
+	uint8_t r = 0;
+
+	while (y) {
+		if (y & 1)
+			r ^= x;
+
+		x = aes_xtime(x);
+		y >>= 1;
+	}
+
+	return r;
+}
+
+/* InvMixColumns, as done by AESIMC */
+static void aes_inv_mix_columns(uint8_t out[AES_BLOCK_SIZE],
+				const uint8_t in[AES_BLOCK_SIZE])
+{
+	const uint8_t *c;
+	uint32_t i;
+
+	for (i = 0; i < AES_BLOCK_SIZE; i += 4) {
+		c = in + i;
+
+		out[i] = aes_mul(c[0], 14) ^ aes_mul(c[1], 11) ^
+			 aes_mul(c[2], 13) ^ aes_mul(c[3], 9);
+		out[i + 1] = aes_mul(c[0], 9) ^ aes_mul(c[1], 14) ^
+			     aes_mul(c[2], 11) ^ aes_mul(c[3], 13);
+		out[i + 2] = aes_mul(c[0], 13) ^ aes_mul(c[1], 9) ^
+			     aes_mul(c[2], 14) ^ aes_mul(c[3], 11);
+		out[i + 3] = aes_mul(c[0], 11) ^ aes_mul(c[1], 13) ^
+			     aes_mul(c[2], 9) ^ aes_mul(c[3], 14);
+	}
+}
+
+/*
+ * Build the round keys of the equivalent inverse cipher: the encryption round
+ * keys in reverse order, with InvMixColumns applied to all but the first and
+ * the last one.
+ *
+ * The key schedule is computed without the vector registers, which still
+ * hold the state of the caller.
+ */
+void aes256_ce_expand_dec_key(struct aes256_ce_dec_key *dk,
+			      const uint8_t key[AES256_KEY_SIZE])
+{
+	uint8_t ek[AES256_ROUNDS + 1][AES_BLOCK_SIZE];
+	uint8_t *w = &ek[0][0], t[4], rcon = 1;
+	uint32_t i, j;
+
+	memcpy(w, key, AES256_KEY_SIZE);
+
+	for (i = AES256_KEY_SIZE; i < sizeof(ek); i += 4) {
+		memcpy(t, w + i - 4, sizeof(t));
+
+		if (!(i % AES256_KEY_SIZE)) {
+			/* RotWord, SubWord and Rcon */
+			uint8_t t0 = t[0];
+
+			t[0] = aes_sbox[t[1]] ^ rcon;
+			t[1] = aes_sbox[t[2]];
+			t[2] = aes_sbox[t[3]];
+			t[3] = aes_sbox[t0];
+			rcon = aes_xtime(rcon);
+		} else if (i % AES256_KEY_SIZE == AES_BLOCK_SIZE) {
+			for (j = 0; j < sizeof(t); j++)
+				t[j] = aes_sbox[t[j]];
+		}
+
+		for (j = 0; j < sizeof(t); j++)
+			w[i + j] = w[i + j - AES256_KEY_SIZE] ^ t[j];
+	}
+
+	memcpy(dk->rk[0], ek[AES256_ROUNDS], AES_BLOCK_SIZE);
+
+	for (i = 1; i < AES256_ROUNDS; i++)
+		aes_inv_mix_columns(dk->rk[i], ek[AES256_ROUNDS - i]);
+
+	memcpy(dk->rk[AES256_ROUNDS], ek[0], AES_BLOCK_SIZE);
+
+	memset(ek, 0, sizeof(ek));
+}
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ */
+
+#ifndef _AES_CE_H_
+#define _AES_CE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AES_BLOCK_SIZE		16
+#define AES256_KEY_SIZE		32
+#define AES256_ROUNDS		14
+
+/* Decryption round keys in the order used by AESD */
+struct aes256_ce_dec_key {
+	uint8_t rk[AES256_ROUNDS + 1][AES_BLOCK_SIZE];
+};
+
+bool aes_ce_supported(void);
+void aes256_ce_expand_dec_key(struct aes256_ce_dec_key *dk,
+			      const uint8_t key[AES256_KEY_SIZE]);
+void aes256_ce_cbc_decrypt(uint8_t *out, const uint8_t *in,
+			   const struct aes256_ce_dec_key *dk, size_t blocks,
+			   uint8_t iv[AES_BLOCK_SIZE]);
+
+#endif /* _AES_CE_H_ */
@@ -3,6 +3,8 @@
  * Copyright (c) 2024, MediaTek Inc. All rights reserved.
  */
 
+#include <stdbool.h>
+
 #include <common/debug.h>
 #include <lib/spinlock.h>
 #include <mbedtls_helper.h>
@@ -11,6 +13,9 @@
 #include <key_info.h>
 #include <salt.h>
 #include "fw_dec.h"
+#ifdef FW_DEC_AES_CE
+#include "aes_ce.h"
+#endif
 
 static spinlock_t fw_dec_lock;
 
@@ -85,6 +90,21 @@ static uint8_t iv[IV_SIZE];
 static uint8_t iv_flag;
 static uint8_t key_flag;
 
+#ifdef FW_DEC_AES_CE
+static struct aes256_ce_dec_key fw_dec_key;
+#endif
+
+static void clear_dec_state(void)
+{
+	memset(iv, 0, IV_SIZE);
+	memset(fw_key, 0, FW_KEY_SIZE);
+#ifdef FW_DEC_AES_CE
+	memset(&fw_dec_key, 0, sizeof(fw_dec_key));
+#endif
+	iv_flag = 0;
+	key_flag = 0;
+}
+
 int fw_dec_set_key(uint32_t key_idx)
 {
 	int ret = 0;
@@ -95,6 +115,11 @@ int fw_dec_set_key(uint32_t key_idx)
 	if (ret)
 		goto out;
 
+#ifdef FW_DEC_AES_CE
+	if (aes_ce_supported())
+		aes256_ce_expand_dec_key(&fw_dec_key, fw_key);
+#endif
+
 	key_flag = 1;
 
 out:
@@ -135,11 +160,28 @@ int fw_dec_set_iv(uintptr_t iv_paddr, uint32_t iv_size)
 	return ret;
 }
 
+/*
+ * Decrypt @cipher_size bytes, which is a multiple of the AES block size.
+ * The IV is replaced by the last ciphertext block, so that the next call
+ * continues the CBC chain.
+ */
 static int do_decrypt(uint8_t *cipher, uint32_t cipher_size,
 		      uint8_t *plain, uint32_t plain_size)
 {
+	uint8_t next_iv[IV_SIZE];
 	int ret = 0;
 
+#ifdef FW_DEC_AES_CE
+	if (aes_ce_supported()) {
+		aes256_ce_cbc_decrypt(plain, cipher, &fw_dec_key,
+				      cipher_size / AES_BLOCK_SIZE, iv);
+		return 0;
+	}
+#endif
+
+	/* plain may be the same buffer as cipher */
+	memcpy(next_iv, cipher + cipher_size - IV_SIZE, IV_SIZE);
+
 	bl31_mbedtls_init();
 
 	ret = aes_cbc_crypt(cipher, cipher_size,
@@ -153,18 +195,22 @@ static int do_decrypt(uint8_t *cipher, uint32_t cipher_size,
 	}
 
 	bl31_mbedtls_deinit();
+
+	memcpy(iv, next_iv, IV_SIZE);
+
 	return ret;
 }
 
-int fw_dec_image(uintptr_t image_paddr, uint32_t image_size)
+/*
+ * Decrypt a buffer in place with the key and IV set before. The key and the
+ * IV are dropped after the @last buffer of an image, or on failure.
+ */
+static int dec_buffer(uintptr_t image_paddr, uint32_t image_size, bool last)
 {
 	uintptr_t cipher_vaddr, plain_vaddr;
 	int ret = 0;
 	int stat;
 
-	if (!image_paddr || !image_size)
-		return -FW_DEC_INVALID_PARAM_ERR;
-
 	ret = set_shared_memory(image_paddr, image_size, &cipher_vaddr,
 				MT_MEMORY | MT_RW | MT_NS);
 	if (ret) {
@@ -187,10 +233,8 @@ int fw_dec_image(uintptr_t image_paddr, uint32_t image_size)
 			 (uint8_t *)plain_vaddr, image_size);
 
 out:
-	memset(iv, 0, IV_SIZE);
-	memset(fw_key, 0, FW_KEY_SIZE);
-	iv_flag = 0;
-	key_flag = 0;
+	if (ret || last)
+		clear_dec_state();
 
 	spin_unlock(&fw_dec_lock);
 
@@ -201,6 +245,31 @@ out:
 	}
 	return ret;
 }
+
+int fw_dec_image(uintptr_t image_paddr, uint32_t image_size)
+{
+	if (!image_paddr || !image_size || (image_size % IV_SIZE))
+		return -FW_DEC_INVALID_PARAM_ERR;
+
+	return dec_buffer(image_paddr, image_size, true);
+}
+
+/*
+ * Decrypt one chunk of an image. Chunks are passed in order, the CBC state is
+ * kept in between, so that the caller can decrypt the image while it is
+ * still being read, and BL31 does not hold the core for the whole image.
+ */
+int fw_dec_image_chunk(uintptr_t chunk_paddr, uint32_t chunk_size,
+		       uint32_t flags)
+{
+	if (!chunk_paddr || !chunk_size || (chunk_size % IV_SIZE) ||
+	    chunk_size > FW_DEC_CHUNK_MAX_SIZE ||
+	    (flags & ~FW_DEC_CHUNK_LAST))
+		return -FW_DEC_INVALID_PARAM_ERR;
+
+	return dec_buffer(chunk_paddr, chunk_size,
+			  !!(flags & FW_DEC_CHUNK_LAST));
+}
 #endif /* MTK_FW_ENC_VIA_BL31 */
 
 #ifdef MTK_FW_ENC_VIA_OPTEE
@@ -11,12 +11,23 @@
 #define FW_DEC_PARAM_NOT_SET_ERR	3
 #define FW_DEC_IMAGE_DEC_ERR		4
 
+/* Largest chunk accepted by fw_dec_image_chunk() */
+#define FW_DEC_CHUNK_MAX_SIZE		0x100000
+
+/* fw_dec_image_chunk() flags */
+#define FW_DEC_CHUNK_LAST		(1U << 0)
+
+/* Features reported by MTK_SIP_FW_DEC_GET_FEATURES */
+#define FW_DEC_FEAT_IMAGE_CHUNK		(1U << 0)
+
 void fw_dec_init(void);
 
 #ifdef MTK_FW_ENC_VIA_BL31
 int fw_dec_set_iv(uintptr_t iv_paddr, uint32_t iv_size);
 int fw_dec_set_key(uint32_t key_idx);
 int fw_dec_image(uintptr_t image_paddr, uint32_t image_size);
+int fw_dec_image_chunk(uintptr_t chunk_paddr, uint32_t chunk_size,
+		       uint32_t flags);
 #endif /* MTK_FW_ENC_VIA_BL31 */
 
 #ifdef MTK_FW_ENC_VIA_OPTEE
@@ -11,6 +11,22 @@ BL31_CPPFLAGS		+=	-I$(APSOC_COMMON)/img_dec/fw/ \
 
 ifeq ($(FW_ENC_VIA_BL31),1)
 BL31_CPPFLAGS		+=	-DMTK_FW_ENC_VIA_BL31
+
+# AES using ARMv8 Crypto Extensions if the core implements them
+ifeq ($(FW_DEC_AES_CE),)
+FW_DEC_AES_CE		:=	1
+endif
+
+ifneq ($(ARCH),aarch64)
+FW_DEC_AES_CE		:=	0
+endif
+
+ifeq ($(FW_DEC_AES_CE),1)
+BL31_SOURCES		+=	$(APSOC_COMMON)/img_dec/fw/aes_ce.c \
+				$(APSOC_COMMON)/img_dec/fw/aes_ce_core.S
+
+BL31_CPPFLAGS		+=	-DFW_DEC_AES_CE
+endif
 endif
 
 ifeq ($(FW_ENC_VIA_OPTEE),1)
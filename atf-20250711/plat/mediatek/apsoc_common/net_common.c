@@ -117,7 +117,7 @@ void net_set_udp_header(void *pkt, struct in_addr dest, struct in_addr src,
 	struct udp_hdr *udp = pkt + IP_HDR_SIZE;
 
 	if (len & 1)
-		((uint8_t *)pkt)[UDP_HDR_SIZE + len] = 0;
+		((uint8_t *)pkt)[IP_HDR_SIZE + UDP_HDR_SIZE + len] = 0;
 
 	net_set_ip_header(pkt, dest, src, IP_HDR_SIZE + UDP_HDR_SIZE + len,
 			  IPPROTO_UDP);
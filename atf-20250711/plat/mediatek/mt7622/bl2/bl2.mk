@@ -42,6 +42,12 @@ include $(MTK_PLAT_SOC)/drivers/dram/dram.mk
 # Trusted board boot
 include $(APSOC_COMMON)/bl2/tbbr.mk
 
+# SHA-256
+include $(APSOC_COMMON)/bl2/sha256.mk
+
+# FIP compression
+include $(APSOC_COMMON)/bl2/fip_compress.mk
+
 # Anti-rollback
 include $(MTK_PLAT_SOC)/bl2/ar.mk
 
@@ -74,7 +74,7 @@
 /* BL2_BASE is defined in platform.mk */
 #define BL2_LIMIT		(0x240000)
 
-#define MAX_IO_DEVICES		U(3)
+#define MAX_IO_DEVICES		U(4)
 #define MAX_IO_HANDLES		U(4)
 #define MAX_IO_BLOCK_DEVICES	1
 
@@ -53,6 +53,12 @@ include $(APSOC_COMMON)/bl2/dual_fip.mk
 # Trusted board boot
 include $(APSOC_COMMON)/bl2/tbbr.mk
 
+# SHA-256
+include $(APSOC_COMMON)/bl2/sha256.mk
+
+# FIP compression
+include $(APSOC_COMMON)/bl2/fip_compress.mk
+
 # Anti-rollback
 include $(APSOC_COMMON)/bl2/ar.mk
 
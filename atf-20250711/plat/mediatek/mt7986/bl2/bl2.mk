@@ -58,6 +58,12 @@ endif
 # Trusted board boot
 include $(APSOC_COMMON)/bl2/tbbr.mk
 
+# SHA-256
+include $(APSOC_COMMON)/bl2/sha256.mk
+
+# FIP compression
+include $(APSOC_COMMON)/bl2/fip_compress.mk
+
 # Anti-rollback
 include $(APSOC_COMMON)/bl2/ar.mk
 
@@ -77,7 +77,7 @@
 /* BL2_BASE is defined in platform.mk */
 #define BL2_LIMIT		(0x280000)
 
-#define MAX_IO_DEVICES		U(4)
+#define MAX_IO_DEVICES		U(6)
 #define MAX_IO_HANDLES		U(4)
 #define MAX_IO_BLOCK_DEVICES	4
 
@@ -70,7 +70,7 @@
  */
 #define BL2_LIMIT			(BL2_BASE + 0x80000 - 0x1000)
 
-#define MAX_IO_DEVICES			U(4)
+#define MAX_IO_DEVICES			U(6)
 #define MAX_IO_HANDLES			U(4)
 #define MAX_IO_BLOCK_DEVICES		4
 
@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * Host replacement of the TF-A log macros used by the LZ4 decoder
+ */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+
+#define ERROR(...)	fprintf(stderr, __VA_ARGS__)
+#define WARN(...)	fprintf(stderr, __VA_ARGS__)
+
+#endif /* DEBUG_H */
@@ -0,0 +1,756 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * Receiver of the BL31 emergency memory dump. The memory ranges are written
+ * directly into an ELF core file, with the CPU context of the panic as the
+ * NT_PRSTATUS note, so that the dump can be loaded into gdb or crash.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <arpa/inet.h>
+#include <elf.h>
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <tf_unlz4.h>
+
+#include "memdump.h"
+
+#define MDUMP_MAX_RANGES	96
+#define MDUMP_MAX_PKT_LEN	2048
+#define MDUMP_LZ4_MAX_OUT	0x10000
+#define MDUMP_FILL_BUF_LEN	0x10000
+#define MDUMP_FILE_ALIGN	0x1000
+
+/* Time to keep answering re-sent end headers after the session ended */
+#define MDUMP_LINGER_SEC	2
+
+/* Note of the raw context and core data, for tools aware of this dump */
+#define MDUMP_NOTE_NAME		"MTK-MDUMP"
+#define MDUMP_NOTE_CONTEXT	1
+#define MDUMP_NOTE_CORE_DATA	2
+
+/* struct elf_prstatus of aarch64 */
+#define PRSTATUS_SIZE		392
+#define PRSTATUS_PID_OFFSET	32
+#define PRSTATUS_REG_OFFSET	112
+
+#define SPSR_M_MASK		0xf
+
+struct extent {
+	uint64_t start;
+	uint64_t end;
+};
+
+struct recv_range {
+	uint64_t addr;
+	uint64_t end;
+	uint64_t file_off;
+	struct extent *ext;
+	size_t next;
+	size_t cap;
+	bool done;
+};
+
+struct mdump_session {
+	int sock;
+	int fd;
+	const char *output;
+
+	bool started;
+	bool ended;
+	uint32_t assoc_id;
+	uint32_t platform;
+
+	uint32_t nranges;
+	struct recv_range ranges[MDUMP_MAX_RANGES];
+	uint64_t file_size;
+
+	bool has_context;
+	struct mdump_context_header context;
+
+	bool has_core_data;
+	uint64_t core_data_pa;
+};
+
+static uint32_t crc_table[256];
+
+static void crc32_init(void)
+{
+	uint32_t i, j, c;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+
+		for (j = 0; j < 8; j++)
+			c = (c & 1) ? (c >> 1) ^ 0xedb88320 : c >> 1;
+
+		crc_table[i] = c;
+	}
+}
+
+/* Same as tf_crc32() */
+static uint32_t crc32(uint32_t crc, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+
+	crc = ~crc;
+
+	while (len--)
+		crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+static bool pkt_crc_ok(void *pkt, size_t len)
+{
+	struct mdump_basic_header *bh = pkt;
+	uint32_t crc = le32toh(bh->checksum);
+
+	bh->checksum = 0;
+
+	return crc32(0, pkt, len) == crc;
+}
+
+/* Add [start, end) to the sorted and merged list of received extents */
+static int range_add_extent(struct recv_range *r, uint64_t start, uint64_t end)
+{
+	struct extent *e;
+	size_t i, j;
+
+	for (i = 0; i < r->next && r->ext[i].end < start; i++)
+		;
+
+	if (i < r->next && r->ext[i].start <= end) {
+		e = &r->ext[i];
+
+		if (start < e->start)
+			e->start = start;
+
+		if (end > e->end)
+			e->end = end;
+
+		/* Merge the following extents now covered */
+		for (j = i + 1; j < r->next && r->ext[j].start <= e->end; j++) {
+			if (r->ext[j].end > e->end)
+				e->end = r->ext[j].end;
+		}
+
+		memmove(&r->ext[i + 1], &r->ext[j],
+			(r->next - j) * sizeof(*r->ext));
+		r->next -= j - i - 1;
+
+		return 0;
+	}
+
+	if (r->next == r->cap) {
+		e = realloc(r->ext, (r->cap + 64) * sizeof(*r->ext));
+		if (!e)
+			return -ENOMEM;
+
+		r->ext = e;
+		r->cap += 64;
+	}
+
+	memmove(&r->ext[i + 1], &r->ext[i], (r->next - i) * sizeof(*r->ext));
+	r->ext[i].start = start;
+	r->ext[i].end = end;
+	r->next++;
+
+	return 0;
+}
+
+/* Find the first part of the range not received yet */
+static bool range_find_hole(const struct recv_range *r, struct extent *hole)
+{
+	uint64_t pos = r->addr;
+	size_t i;
+
+	for (i = 0; i < r->next; i++) {
+		if (r->ext[i].start > pos)
+			break;
+
+		pos = r->ext[i].end;
+	}
+
+	if (pos >= r->end)
+		return false;
+
+	hole->start = pos;
+	hole->end = i < r->next ? r->ext[i].start : r->end;
+
+	return true;
+}
+
+static void session_reset(struct mdump_session *s)
+{
+	uint32_t i;
+
+	for (i = 0; i < s->nranges; i++)
+		free(s->ranges[i].ext);
+
+	memset(s->ranges, 0, sizeof(s->ranges));
+	s->nranges = 0;
+	s->started = false;
+	s->ended = false;
+	s->has_context = false;
+	s->has_core_data = false;
+}
+
+static size_t note_size(size_t namesz, size_t descsz)
+{
+	return sizeof(Elf64_Nhdr) + ((namesz + 3) & ~3) + ((descsz + 3) & ~3);
+}
+
+static size_t notes_size(void)
+{
+	return note_size(sizeof("CORE"), PRSTATUS_SIZE) +
+	       note_size(sizeof(MDUMP_NOTE_NAME),
+			 sizeof(struct mdump_context_header) -
+			 sizeof(struct mdump_basic_header)) +
+	       note_size(sizeof(MDUMP_NOTE_NAME), sizeof(uint64_t));
+}
+
+static uint8_t *put_note(uint8_t *p, const char *name, uint32_t type,
+			 const void *desc, size_t descsz)
+{
+	Elf64_Nhdr nhdr = {
+		.n_namesz = strlen(name) + 1,
+		.n_descsz = descsz,
+		.n_type = type,
+	};
+
+	memcpy(p, &nhdr, sizeof(nhdr));
+	p += sizeof(nhdr);
+
+	memcpy(p, name, nhdr.n_namesz);
+	p += (nhdr.n_namesz + 3) & ~3;
+
+	memcpy(p, desc, descsz);
+	p += (descsz + 3) & ~3;
+
+	return p;
+}
+
+/* Stack pointer of the exception level selected by SPSR.M */
+static uint64_t context_sp(const struct mdump_context_header *ch)
+{
+	switch (le64toh(ch->pstate.cpsr) & SPSR_M_MASK) {
+	case 0x5:	/* EL1h */
+		return le64toh(ch->pstate.sp_el1);
+	case 0x9:	/* EL2h */
+		return le64toh(ch->pstate.sp_el2);
+	default:
+		return le64toh(ch->pstate.sp_el0);
+	}
+}
+
+static void build_prstatus(const struct mdump_session *s,
+			   uint8_t prstatus[PRSTATUS_SIZE])
+{
+	const struct mdump_context_header *ch = &s->context;
+	uint64_t regs[34];
+	uint32_t pid = 1;
+	int i;
+
+	memset(prstatus, 0, PRSTATUS_SIZE);
+	memcpy(prstatus + PRSTATUS_PID_OFFSET, &pid, sizeof(pid));
+
+	if (!s->has_context)
+		return;
+
+	for (i = 0; i < 31; i++)
+		regs[i] = le64toh(ch->gpr[i]);
+
+	regs[31] = context_sp(ch);
+	regs[32] = le64toh(ch->pstate.pc);
+	regs[33] = le64toh(ch->pstate.cpsr);
+
+	memcpy(prstatus + PRSTATUS_REG_OFFSET, regs, sizeof(regs));
+}
+
+static int write_elf_headers(struct mdump_session *s)
+{
+	size_t phnum = s->nranges + 1, hdr_len, notes_off, len;
+	uint8_t prstatus[PRSTATUS_SIZE], *buf, *p;
+	Elf64_Phdr *phdr;
+	Elf64_Ehdr *ehdr;
+	uint32_t i;
+	int ret = 0;
+
+	notes_off = sizeof(*ehdr) + phnum * sizeof(*phdr);
+	hdr_len = notes_off + notes_size();
+
+	buf = calloc(1, hdr_len);
+	if (!buf)
+		return -ENOMEM;
+
+	ehdr = (Elf64_Ehdr *)buf;
+	memcpy(ehdr->e_ident, ELFMAG, SELFMAG);
+	ehdr->e_ident[EI_CLASS] = ELFCLASS64;
+	ehdr->e_ident[EI_DATA] = ELFDATA2LSB;
+	ehdr->e_ident[EI_VERSION] = EV_CURRENT;
+	ehdr->e_ident[EI_OSABI] = ELFOSABI_NONE;
+	ehdr->e_type = ET_CORE;
+	ehdr->e_machine = EM_AARCH64;
+	ehdr->e_version = EV_CURRENT;
+	ehdr->e_phoff = sizeof(*ehdr);
+	ehdr->e_ehsize = sizeof(*ehdr);
+	ehdr->e_phentsize = sizeof(*phdr);
+	ehdr->e_phnum = phnum;
+
+	phdr = (Elf64_Phdr *)(buf + sizeof(*ehdr));
+	phdr->p_type = PT_NOTE;
+	phdr->p_offset = notes_off;
+	phdr->p_filesz = notes_size();
+	phdr->p_align = 4;
+
+	for (i = 0; i < s->nranges; i++) {
+		phdr++;
+		phdr->p_type = PT_LOAD;
+		phdr->p_flags = PF_R | PF_W | PF_X;
+		phdr->p_offset = s->ranges[i].file_off;
+		phdr->p_vaddr = s->ranges[i].addr;
+		phdr->p_paddr = s->ranges[i].addr;
+		phdr->p_filesz = s->ranges[i].end - s->ranges[i].addr;
+		phdr->p_memsz = phdr->p_filesz;
+		phdr->p_align = MDUMP_FILE_ALIGN;
+	}
+
+	build_prstatus(s, prstatus);
+
+	p = put_note(buf + notes_off, "CORE", NT_PRSTATUS, prstatus,
+		     sizeof(prstatus));
+	p = put_note(p, MDUMP_NOTE_NAME, MDUMP_NOTE_CONTEXT, &s->context.gpr,
+		     sizeof(s->context) - sizeof(s->context.bh));
+	put_note(p, MDUMP_NOTE_NAME, MDUMP_NOTE_CORE_DATA, &s->core_data_pa,
+		 sizeof(s->core_data_pa));
+
+	len = pwrite(s->fd, buf, hdr_len, 0);
+	if (len != hdr_len)
+		ret = -errno;
+
+	/* Pages filled with zero at the end of the dump were never written */
+	if (!ret && ftruncate(s->fd, s->file_size))
+		ret = -errno;
+
+	free(buf);
+
+	return ret;
+}
+
+static int send_response(struct mdump_session *s, const struct sockaddr_in *to,
+			 uint32_t version, uint32_t type, uint32_t index,
+			 const struct extent *r)
+{
+	struct mdump_response_header rh;
+
+	memset(&rh, 0, sizeof(rh));
+
+	rh.bh.magic = htole32(MDUMP_MAGIC_RESPONSE);
+	rh.bh.version = htole32(version);
+	rh.bh.assoc_id = htole32(s->assoc_id);
+	rh.type = htole32(type);
+	rh.range.index = htole32(index);
+
+	if (r) {
+		rh.range.r.addr = htole64(r->start);
+		rh.range.r.end = htole64(r->end);
+	}
+
+	rh.bh.checksum = htole32(crc32(0, &rh, sizeof(rh)));
+
+	if (sendto(s->sock, &rh, sizeof(rh), 0, (const struct sockaddr *)to,
+		   sizeof(*to)) < 0)
+		return -errno;
+
+	return 0;
+}
+
+static int handle_control(struct mdump_session *s,
+			  const struct mdump_control_header *ch, size_t len)
+{
+	uint64_t off;
+	uint32_t i, nranges = le32toh(ch->num_ranges);
+
+	if (nranges > MDUMP_MAX_RANGES ||
+	    len < sizeof(*ch) + nranges * sizeof(ch->ranges[0]))
+		return -EINVAL;
+
+	if (s->started && s->assoc_id == le32toh(ch->bh.assoc_id))
+		return 0;
+
+	session_reset(s);
+
+	if (ftruncate(s->fd, 0))
+		return -errno;
+
+	s->assoc_id = le32toh(ch->bh.assoc_id);
+	s->platform = le32toh(ch->platform);
+	s->nranges = nranges;
+
+	off = sizeof(Elf64_Ehdr) + (nranges + 1) * sizeof(Elf64_Phdr) +
+	      notes_size();
+
+	for (i = 0; i < nranges; i++) {
+		s->ranges[i].addr = le64toh(ch->ranges[i].addr);
+		s->ranges[i].end = le64toh(ch->ranges[i].end);
+
+		if (s->ranges[i].end < s->ranges[i].addr)
+			s->ranges[i].end = s->ranges[i].addr;
+
+		off = (off + MDUMP_FILE_ALIGN - 1) & ~(uint64_t)(MDUMP_FILE_ALIGN - 1);
+		s->ranges[i].file_off = off;
+		off += s->ranges[i].end - s->ranges[i].addr;
+
+		printf("Range %u: 0x%" PRIx64 " - 0x%" PRIx64 "\n", i,
+		       s->ranges[i].addr, s->ranges[i].end);
+	}
+
+	s->file_size = off;
+	s->started = true;
+
+	printf("Session 0x%08x started, platform 0x%x, version %u\n",
+	       s->assoc_id, s->platform, le32toh(ch->bh.version));
+
+	return 0;
+}
+
+/* Write @len bytes at @addr of the range, clipped to the range */
+static int range_write(struct mdump_session *s, uint32_t index, uint64_t addr,
+		       const void *data, uint64_t len, bool fill,
+		       uint64_t fill_val)
+{
+	static uint64_t fill_buf[MDUMP_FILL_BUF_LEN / sizeof(uint64_t)];
+	struct recv_range *r;
+	uint64_t end, chunk, i;
+	ssize_t ret;
+
+	if (index >= s->nranges)
+		return -EINVAL;
+
+	r = &s->ranges[index];
+	end = addr + len;
+
+	/* Device ranges are sent in whole 32-bit words */
+	if (addr < r->addr) {
+		if (!fill)
+			data = (const uint8_t *)data + (r->addr - addr);
+
+		addr = r->addr;
+	}
+
+	if (end > r->end)
+		end = r->end;
+
+	if (addr >= end)
+		return 0;
+
+	if (fill) {
+		/* Zero-filled pages are left as holes of the sparse file */
+		if (fill_val) {
+			for (i = 0; i < MDUMP_FILL_BUF_LEN / sizeof(uint64_t); i++)
+				fill_buf[i] = fill_val;
+
+			for (i = addr; i < end; i += chunk) {
+				chunk = end - i;
+				if (chunk > MDUMP_FILL_BUF_LEN)
+					chunk = MDUMP_FILL_BUF_LEN;
+
+				ret = pwrite(s->fd, fill_buf, chunk,
+					     r->file_off + i - r->addr);
+				if (ret != (ssize_t)chunk)
+					return -errno;
+			}
+		}
+	} else {
+		ret = pwrite(s->fd, data, end - addr, r->file_off + addr - r->addr);
+		if (ret != (ssize_t)(end - addr))
+			return -errno;
+	}
+
+	return range_add_extent(r, addr, end);
+}
+
+static int handle_range(struct mdump_session *s,
+			const struct mdump_range_header *rh, size_t len)
+{
+	uint32_t size = le32toh(rh->size);
+
+	if (len != sizeof(*rh) + size)
+		return -EINVAL;
+
+	return range_write(s, le32toh(rh->index), le64toh(rh->offset), rh->data,
+			   size, false, 0);
+}
+
+static int handle_range_enc(struct mdump_session *s,
+			    const struct mdump_range_enc_header *rh, size_t len)
+{
+	static uint8_t out[MDUMP_LZ4_MAX_OUT];
+	uint32_t data_size = le16toh(rh->data_size);
+	uint64_t size = le64toh(rh->size), val;
+	uint8_t *op = out;
+	int ret;
+
+	if (len != sizeof(*rh) + data_size)
+		return -EINVAL;
+
+	switch (le16toh(rh->encoding)) {
+	case MDUMP_ENC_RAW:
+		if (size != data_size)
+			return -EINVAL;
+
+		return range_write(s, le32toh(rh->index), le64toh(rh->offset),
+				   rh->data, size, false, 0);
+
+	case MDUMP_ENC_FILL:
+		if (data_size != sizeof(val))
+			return -EINVAL;
+
+		memcpy(&val, rh->data, sizeof(val));
+
+		return range_write(s, le32toh(rh->index), le64toh(rh->offset),
+				   NULL, size, true, val);
+
+	case MDUMP_ENC_LZ4:
+		if (size > sizeof(out))
+			return -EINVAL;
+
+		ret = lz4_decode_block(rh->data, data_size, out, &op,
+				       out + size);
+		if (ret || op != out + size)
+			return -EINVAL;
+
+		return range_write(s, le32toh(rh->index), le64toh(rh->offset),
+				   out, size, false, 0);
+
+	default:
+		return -EINVAL;
+	}
+}
+
+static int handle_range_end(struct mdump_session *s,
+			    const struct mdump_range_end_header *reh,
+			    const struct sockaddr_in *from)
+{
+	uint32_t index = le32toh(reh->index);
+	uint32_t ver = le32toh(reh->bh.version);
+	struct recv_range *r;
+	struct extent hole;
+
+	if (index >= s->nranges)
+		return -EINVAL;
+
+	r = &s->ranges[index];
+
+	if (range_find_hole(r, &hole))
+		return send_response(s, from, ver, MDUMP_RESP_RANGE_REXMIT,
+				     index, &hole);
+
+	if (!r->done) {
+		r->done = true;
+		printf("Range %u received\n", index);
+	}
+
+	return send_response(s, from, ver, MDUMP_RESP_RANGE_ACK, index, NULL);
+}
+
+static int handle_packet(struct mdump_session *s, void *pkt, size_t len,
+			 const struct sockaddr_in *from)
+{
+	struct mdump_basic_header *bh = pkt;
+	uint32_t magic, ver;
+	int ret;
+
+	if (len < sizeof(*bh) || !pkt_crc_ok(pkt, len))
+		return -EBADMSG;
+
+	magic = le32toh(bh->magic);
+	ver = le32toh(bh->version);
+
+	if (magic == MDUMP_MAGIC_CONTROL) {
+		if (len < sizeof(struct mdump_control_header))
+			return -EINVAL;
+
+		ret = handle_control(s, pkt, len);
+		if (ret)
+			return ret;
+
+		return send_response(s, from, MDUMP_PACKET_VERSION,
+				     MDUMP_RESP_CONTROL_ACK, 0, NULL);
+	}
+
+	if (!s->started || le32toh(bh->assoc_id) != s->assoc_id)
+		return -ESRCH;
+
+	switch (magic) {
+	case MDUMP_MAGIC_RANGE:
+		if (len < sizeof(struct mdump_range_header))
+			return -EINVAL;
+
+		return handle_range(s, pkt, len);
+
+	case MDUMP_MAGIC_RANGE_ENC:
+		if (len < sizeof(struct mdump_range_enc_header))
+			return -EINVAL;
+
+		return handle_range_enc(s, pkt, len);
+
+	case MDUMP_MAGIC_RANGE_END:
+		if (len != sizeof(struct mdump_range_end_header))
+			return -EINVAL;
+
+		return handle_range_end(s, pkt, from);
+
+	case MDUMP_MAGIC_CONTEXT:
+		if (len != sizeof(struct mdump_context_header))
+			return -EINVAL;
+
+		memcpy(&s->context, pkt, sizeof(s->context));
+		s->has_context = true;
+
+		return send_response(s, from, ver, MDUMP_RESP_CONTEXT_ACK, 0,
+				     NULL);
+
+	case MDUMP_MAGIC_CORE_DATA:
+		if (len != sizeof(struct mdump_core_data_header))
+			return -EINVAL;
+
+		s->core_data_pa = le64toh(((struct mdump_core_data_header *)pkt)->core_data_pa);
+		s->has_core_data = true;
+
+		return send_response(s, from, ver, MDUMP_RESP_CORE_DATA_ACK, 0,
+				     NULL);
+
+	case MDUMP_MAGIC_END:
+		if (!s->ended) {
+			ret = write_elf_headers(s);
+			if (ret)
+				return ret;
+
+			s->ended = true;
+			printf("Session 0x%08x ended, dump written to %s\n",
+			       s->assoc_id, s->output);
+		}
+
+		return send_response(s, from, ver, MDUMP_RESP_END_ACK, 0, NULL);
+
+	default:
+		return -EINVAL;
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-b <bind address>] [-p <port>] [-o <core file>]\n",
+		prog);
+}
+
+int main(int argc, char *argv[])
+{
+	static union {
+		uint64_t align;
+		uint8_t buf[MDUMP_MAX_PKT_LEN];
+	} pkt;
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(MDUMP_DST_PORT),
+		.sin_addr.s_addr = htonl(INADDR_ANY),
+	};
+	struct timeval tv = { .tv_sec = MDUMP_LINGER_SEC };
+	struct mdump_session s = { .output = "mdump.core" };
+	struct sockaddr_in from;
+	socklen_t fromlen;
+	ssize_t len;
+	int opt, ret;
+
+	while ((opt = getopt(argc, argv, "b:p:o:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			if (inet_pton(AF_INET, optarg, &addr.sin_addr) != 1) {
+				fprintf(stderr, "Invalid address '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 'p':
+			addr.sin_port = htons(strtoul(optarg, NULL, 0));
+			break;
+		case 'o':
+			s.output = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt != 'h';
+		}
+	}
+
+	crc32_init();
+
+	s.fd = open(s.output, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (s.fd < 0) {
+		perror(s.output);
+		return 1;
+	}
+
+	s.sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (s.sock < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	if (bind(s.sock, (struct sockaddr *)&addr, sizeof(addr))) {
+		perror("bind");
+		return 1;
+	}
+
+	printf("Waiting for memory dump on port %u\n", ntohs(addr.sin_port));
+
+	while (true) {
+		fromlen = sizeof(from);
+		len = recvfrom(s.sock, pkt.buf, sizeof(pkt.buf), 0,
+			       (struct sockaddr *)&from, &fromlen);
+		if (len < 0) {
+			/* Re-sent end headers have all been answered */
+			if (s.ended && (errno == EAGAIN || errno == EWOULDBLOCK))
+				break;
+
+			if (errno == EINTR)
+				continue;
+
+			perror("recvfrom");
+			return 1;
+		}
+
+		ret = handle_packet(&s, pkt.buf, len, &from);
+		if (ret && ret != -EBADMSG && ret != -ESRCH && ret != -EINVAL) {
+			fprintf(stderr, "Failed to handle packet: %s\n",
+				strerror(-ret));
+			return 1;
+		}
+
+		if (s.ended)
+			setsockopt(s.sock, SOL_SOCKET, SO_RCVTIMEO, &tv,
+				   sizeof(tv));
+	}
+
+	close(s.sock);
+	close(s.fd);
+	session_reset(&s);
+
+	return 0;
+}
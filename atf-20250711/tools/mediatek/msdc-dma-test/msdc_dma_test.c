@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2025, MediaTek Inc. All rights reserved.
+ *
+ * Host test of the MSDC DMA descriptor helpers. The descriptors are consumed
+ * by a model of the MSDC DMA engine which walks the GPD/BD chain the way the
+ * controller does and fills the buffers with a known pattern.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mtk-sd-dma.h"
+
+#define MODEL_MEM_SIZE		0x100000
+#define MODEL_MAX_BD		8
+#define MODEL_BUF_OFFSET	0x1000
+
+#define CACHE_LINE		64
+
+static int failures;
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__func__, __LINE__, #cond);		\
+			failures++;					\
+		}							\
+	} while (0)
+
+struct model {
+	uint8_t *mem;
+	uint64_t base;
+	struct msdc_dma dma;
+};
+
+static void *model_ptr(struct model *m, uint64_t addr, size_t len)
+{
+	if (addr < m->base || addr + len > m->base + MODEL_MEM_SIZE)
+		return NULL;
+
+	return m->mem + (addr - m->base);
+}
+
+static uint8_t model_pattern(size_t offset)
+{
+	return (offset * 7 + 1) & 0xff;
+}
+
+static void model_fill(uint8_t *p, size_t offset, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		p[i] = model_pattern(offset + i);
+}
+
+static void model_init(struct model *m, uint64_t base)
+{
+	struct msdc_gpd *gpd;
+	struct msdc_bd *bd;
+
+	m->mem = calloc(1, MODEL_MEM_SIZE);
+	if (!m->mem) {
+		perror("calloc");
+		exit(1);
+	}
+
+	m->base = base;
+
+	/* GPDs at the start of the memory, BDs on the next cache line */
+	gpd = (struct msdc_gpd *)m->mem;
+	bd = (struct msdc_bd *)(m->mem + CACHE_LINE);
+
+	msdc_dma_init_desc(&m->dma, gpd, base, bd, base + CACHE_LINE,
+			   MODEL_MAX_BD);
+}
+
+static void model_exit(struct model *m)
+{
+	free(m->mem);
+}
+
+/* Run one read transfer, returns the number of bytes transferred */
+static long model_run(struct model *m, const struct msdc_dma_regs *regs)
+{
+	struct msdc_gpd *gpd, *null_gpd;
+	struct msdc_bd *bd;
+	size_t total = 0, nbd = 0;
+	uint64_t addr;
+	uint32_t len;
+	uint8_t *p;
+
+	addr = ((uint64_t)regs->sa_high4bit << 32) | regs->sa;
+
+	if (!(regs->ctrl & MSDC_DMA_CTRL_MODE)) {
+		if (!(regs->ctrl & MSDC_DMA_CTRL_LASTBUF))
+			return -EINVAL;
+
+		p = model_ptr(m, addr, regs->length);
+		if (!p)
+			return -EFAULT;
+
+		model_fill(p, 0, regs->length);
+		return regs->length;
+	}
+
+	gpd = model_ptr(m, addr, sizeof(*gpd));
+	if (!gpd)
+		return -EFAULT;
+
+	if (!(gpd->gpd_info & GPDMA_DESC_HWO) ||
+	    !(gpd->gpd_info & GPDMA_DESC_BDP))
+		return -EPERM;
+
+	if ((regs->cfg & MSDC_DMA_CFG_DECSEN) &&
+	    msdc_dma_checksum(gpd, MSDC_DESC_CHECKSUM_LEN))
+		return -EBADMSG;
+
+	addr = ((uint64_t)((gpd->gpd_info & GPDMA_DESC_PTR_H4_M) >>
+			   GPDMA_DESC_PTR_H4_S) << 32) | gpd->ptr;
+
+	while (1) {
+		if (++nbd > MODEL_MAX_BD)
+			return -ELOOP;
+
+		bd = model_ptr(m, addr, sizeof(*bd));
+		if (!bd)
+			return -EFAULT;
+
+		if ((regs->cfg & MSDC_DMA_CFG_DECSEN) &&
+		    msdc_dma_checksum(bd, MSDC_DESC_CHECKSUM_LEN))
+			return -EBADMSG;
+
+		len = bd->bd_data_len & BDMA_DESC_BUFLEN_M;
+		addr = ((uint64_t)((bd->bd_info & BDMA_DESC_PTR_H4_M) >>
+				   BDMA_DESC_PTR_H4_S) << 32) | bd->ptr;
+
+		p = model_ptr(m, addr, len);
+		if (!p)
+			return -EFAULT;
+
+		model_fill(p, total, len);
+		total += len;
+
+		if (bd->bd_info & BDMA_DESC_EOL)
+			break;
+
+		addr = ((uint64_t)((bd->bd_info & BDMA_DESC_NEXT_H4_M) >>
+				   BDMA_DESC_NEXT_H4_S) << 32) | bd->next;
+	}
+
+	/* Give the GPD back and make sure the chain ends at the null GPD */
+	gpd->gpd_info &= ~GPDMA_DESC_HWO;
+
+	addr = ((uint64_t)((gpd->gpd_info & GPDMA_DESC_NEXT_H4_M) >>
+			   GPDMA_DESC_NEXT_H4_S) << 32) | gpd->next;
+	null_gpd = model_ptr(m, addr, sizeof(*null_gpd));
+	if (!null_gpd || (null_gpd->gpd_info & GPDMA_DESC_HWO))
+		return -EFAULT;
+
+	return total;
+}
+
+static int model_check(struct model *m, uint64_t addr, size_t len)
+{
+	const uint8_t *p = model_ptr(m, addr, len);
+	size_t i;
+
+	if (!p)
+		return 0;
+
+	for (i = 0; i < len; i++) {
+		if (p[i] != model_pattern(i))
+			return 0;
+	}
+
+	return 1;
+}
+
+static void test_chunking(uint64_t base)
+{
+	static const size_t sizes[] = {
+		512, 4096, MSDC_BD_MAX_LEN - 512, MSDC_BD_MAX_LEN,
+		MSDC_BD_MAX_LEN + 512, 3 * MSDC_BD_MAX_LEN + 1024,
+		MODEL_MAX_BD * MSDC_BD_MAX_LEN,
+	};
+	uint64_t buf = base + MODEL_BUF_OFFSET;
+	struct msdc_dma_regs regs;
+	struct model m;
+	size_t i, j, nbd, len;
+
+	model_init(&m, base);
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		memset(m.mem + MODEL_BUF_OFFSET, 0,
+		       MODEL_MEM_SIZE - MODEL_BUF_OFFSET);
+
+		CHECK(!msdc_dma_build_desc(&m.dma, buf, sizes[i], &regs));
+
+		CHECK(regs.sa == (uint32_t)m.dma.gpd_addr);
+		CHECK(regs.sa_high4bit == (uint32_t)(base >> 32));
+		CHECK(regs.ctrl & MSDC_DMA_CTRL_MODE);
+		CHECK(regs.cfg & MSDC_DMA_CFG_DECSEN);
+		CHECK(!msdc_dma_checksum(&m.dma.gpd[0],
+					 MSDC_DESC_CHECKSUM_LEN));
+
+		nbd = (sizes[i] + MSDC_BD_MAX_LEN - 1) / MSDC_BD_MAX_LEN;
+
+		for (j = 0; j < nbd; j++) {
+			len = sizes[i] - j * MSDC_BD_MAX_LEN;
+			if (len > MSDC_BD_MAX_LEN)
+				len = MSDC_BD_MAX_LEN;
+
+			CHECK(m.dma.bd[j].bd_data_len == len);
+			CHECK(!!(m.dma.bd[j].bd_info & BDMA_DESC_EOL) ==
+			      (j == nbd - 1));
+			CHECK(!msdc_dma_checksum(&m.dma.bd[j],
+						 MSDC_DESC_CHECKSUM_LEN));
+		}
+
+		CHECK(model_run(&m, &regs) == (long)sizes[i]);
+		CHECK(model_check(&m, buf, sizes[i]));
+
+		/* Nothing past the end of the buffer is touched */
+		if (MODEL_BUF_OFFSET + sizes[i] < MODEL_MEM_SIZE)
+			CHECK(!m.mem[MODEL_BUF_OFFSET + sizes[i]]);
+	}
+
+	/* The engine rejects a BD changed after its checksum was computed */
+	CHECK(!msdc_dma_build_desc(&m.dma, buf, 2 * MSDC_BD_MAX_LEN, &regs));
+	m.dma.bd[1].bd_data_len = 512;
+	CHECK(model_run(&m, &regs) == -EBADMSG);
+
+	model_exit(&m);
+}
+
+static void test_limits(void)
+{
+	struct msdc_dma_regs regs;
+	struct model m;
+
+	model_init(&m, 0x40000000);
+
+	CHECK(msdc_dma_build_desc(&m.dma, m.base, 0, &regs) == -EINVAL);
+	CHECK(msdc_dma_build_desc(&m.dma, MSDC_DMA_ADDR_LIMIT, 512,
+				  &regs) == -EINVAL);
+	CHECK(msdc_dma_build_desc(&m.dma, m.base,
+				  MODEL_MAX_BD * MSDC_BD_MAX_LEN + 512,
+				  &regs) == -E2BIG);
+
+	CHECK(!msdc_dma_build_basic(0x812345000ULL, 512, &regs));
+	CHECK(regs.sa_high4bit == 0x8);
+	CHECK(regs.sa == 0x12345000);
+	CHECK(regs.length == 512);
+	CHECK(!(regs.ctrl & MSDC_DMA_CTRL_MODE));
+	CHECK(regs.ctrl & MSDC_DMA_CTRL_LASTBUF);
+	CHECK(msdc_dma_build_basic(MSDC_DMA_ADDR_LIMIT - 512, 1024,
+				   &regs) == -EINVAL);
+
+	model_exit(&m);
+}
+
+static void test_mode_select(void)
+{
+	uint64_t buf = 0x40000000 + MODEL_BUF_OFFSET;
+	size_t desc_max = MODEL_MAX_BD * MSDC_BD_MAX_LEN;
+	struct msdc_dma_regs regs;
+	struct model m;
+
+	model_init(&m, 0x40000000);
+
+	/* Unaligned buffers fall back to PIO */
+	CHECK(msdc_dma_setup(&m.dma, buf + 4, 512, CACHE_LINE, &regs) ==
+	      MSDC_XFER_PIO);
+	CHECK(msdc_dma_setup(&m.dma, buf, 520, CACHE_LINE, &regs) ==
+	      MSDC_XFER_PIO);
+	CHECK(msdc_dma_setup(&m.dma, buf, 0, CACHE_LINE, &regs) ==
+	      MSDC_XFER_PIO);
+	CHECK(msdc_dma_setup(&m.dma, MSDC_DMA_ADDR_LIMIT, 512, CACHE_LINE,
+			     &regs) == MSDC_XFER_PIO);
+
+	/* Descriptors while the BD table is large enough */
+	CHECK(msdc_dma_setup(&m.dma, buf, 512, CACHE_LINE, &regs) ==
+	      MSDC_XFER_DMA_DESC);
+	CHECK(msdc_dma_setup(&m.dma, buf, desc_max, CACHE_LINE, &regs) ==
+	      MSDC_XFER_DMA_DESC);
+
+	/* Basic DMA beyond that, or without descriptors */
+	CHECK(msdc_dma_setup(&m.dma, buf, desc_max + 512, CACHE_LINE,
+			     &regs) == MSDC_XFER_DMA_BASIC);
+	CHECK(regs.length == desc_max + 512);
+	CHECK(msdc_dma_setup(NULL, buf, 512, CACHE_LINE, &regs) ==
+	      MSDC_XFER_DMA_BASIC);
+
+	model_exit(&m);
+}
+
+int main(void)
+{
+	test_chunking(0x40000000);
+	/* Descriptors and buffers above 4GiB use the H4 address bits */
+	test_chunking(0x240000000ULL);
+	test_limits();
+	test_mode_select();
+
+	if (failures) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("All MSDC DMA checks passed\n");
+
+	return 0;
+}
@@ -10,9 +10,37 @@
 #define __ETH_H
 
 #include <net.h>
+#include <net/eth_keepalive.h>
 
 void sandbox_eth_disable_response(int index, bool disable);
 
+/*
+ * sandbox_eth_set_keepalive()
+ *
+ * Enable or disable keep-alive of the controller between network commands
+ *
+ * @index: the alias index (also DM seq number)
+ * @enable: whether to use keep-alive
+ */
+void sandbox_eth_set_keepalive(int index, bool enable);
+
+/*
+ * sandbox_eth_get_keepalive()
+ *
+ * @index: the alias index (also DM seq number)
+ * Return: keep-alive state of the controller, NULL if not found
+ */
+const struct eth_keepalive *sandbox_eth_get_keepalive(int index);
+
+/*
+ * sandbox_eth_link_flap()
+ *
+ * Mock the link going down and up again while the controller is stopped
+ *
+ * @index: the alias index (also DM seq number)
+ */
+void sandbox_eth_link_flap(int index);
+
 void sandbox_eth_skip_timeout(void);
 
 /*
@@ -84,6 +112,9 @@ typedef int sandbox_eth_tx_hand_f(struct udevice *dev, void *pkt,
  * recv_packets - number of packets returned
  * tx_handler - function to generate responses to sent packets
  * priv - a pointer to some structure a test may want to keep track of
+ * ka - keep-alive state
+ * link_lost - link went down since the last start, latched like the link
+ *	       status of a PHY
  */
 struct eth_sandbox_priv {
 	uchar fake_host_hwaddr[ARP_HLEN];
@@ -96,6 +127,8 @@ struct eth_sandbox_priv {
 	int recv_packets;
 	sandbox_eth_tx_hand_f *tx_handler;
 	void *priv;
+	struct eth_keepalive ka;
+	bool link_lost;
 };
 
 /*
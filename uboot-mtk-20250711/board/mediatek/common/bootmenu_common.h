@@ -44,6 +44,9 @@ int generic_mtd_write_bl2_redund(void *priv, const struct data_part_entry *dpe,
 int generic_mtd_write_fip(void *priv, const struct data_part_entry *dpe,
 			  const void *data, size_t size);
 
+extern const struct data_stream_ops generic_mtd_bl2_stream_ops;
+extern const struct data_stream_ops generic_mtd_fip_stream_ops;
+
 #ifdef CONFIG_MTD_UBI
 int generic_ubi_write_fip(void *priv, const struct data_part_entry *dpe,
 			  const void *data, size_t size);
@@ -10,6 +10,7 @@
 #include <u-boot/crc.h>
 
 #include "bootmenu_common.h"
+#include "data_hash.h"
 #include "colored_print.h"
 #include "mmc_helper.h"
 #include "bl2_helper.h"
@@ -142,7 +143,7 @@ int generic_mmc_write_dual_fip(void *priv, const struct data_part_entry *dpe,
 	curr_bspconf.current_fip_slot = next_slot;
 	curr_bspconf.fip[next_slot].invalid = 0;
 	curr_bspconf.fip[next_slot].size = size;
-	curr_bspconf.fip[next_slot].crc32 = crc32(0, data, size);
+	curr_bspconf.fip[next_slot].crc32 = data_hash_crc32(data, size);
 	curr_bspconf.fip[next_slot].upd_cnt++;
 
 	return save_bsp_conf();
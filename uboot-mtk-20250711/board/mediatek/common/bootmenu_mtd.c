@@ -16,6 +16,7 @@ static const struct data_part_entry mtd_parts[] = {
 		.env_name = "bootfile.bl2",
 		.validate = generic_validate_bl2,
 		.write = generic_mtd_write_bl2,
+		.stream = &generic_mtd_bl2_stream_ops,
 	},
 	{
 		.name = "ATF FIP",
@@ -23,6 +24,7 @@ static const struct data_part_entry mtd_parts[] = {
 		.env_name = "bootfile.fip",
 		.validate = generic_validate_fip,
 		.write = generic_mtd_write_fip,
+		.stream = &generic_mtd_fip_stream_ops,
 		.post_action = UPGRADE_ACTION_CUSTOM,
 		//.do_post_action = generic_invalidate_env,
 	},
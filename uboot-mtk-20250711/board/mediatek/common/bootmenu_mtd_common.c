@@ -9,6 +9,7 @@
 #include <ubi_uboot.h>
 
 #include "bootmenu_common.h"
+#include "data_hash.h"
 #include "colored_print.h"
 #include "mtd_helper.h"
 #include "bl2_helper.h"
@@ -177,6 +178,73 @@ int generic_mtd_write_fip(void *priv, const struct data_part_entry *dpe,
 	return write_mtd_part(PART_FIP_NAME, data, size, true);
 }
 
+static int mtd_part_stream_begin(const char *partname, void **ctx)
+{
+	struct mtd_stream *ms;
+	struct mtd_info *mtd;
+	int ret;
+
+	mtd = get_mtd_part(partname);
+	if (IS_ERR(mtd))
+		return -PTR_ERR(mtd);
+
+	ret = mtd_stream_begin(mtd, true, &ms);
+	if (ret) {
+		put_mtd_device(mtd);
+		return ret;
+	}
+
+	*ctx = ms;
+
+	return 0;
+}
+
+static int generic_mtd_stream_bl2_begin(void *priv,
+					const struct data_part_entry *dpe,
+					void **ctx)
+{
+	return mtd_part_stream_begin(PART_BL2_NAME, ctx);
+}
+
+static int generic_mtd_stream_fip_begin(void *priv,
+					const struct data_part_entry *dpe,
+					void **ctx)
+{
+	return mtd_part_stream_begin(PART_FIP_NAME, ctx);
+}
+
+static int generic_mtd_stream_feed(void *ctx, const void *data, size_t size,
+				   bool last)
+{
+	return mtd_stream_feed(ctx, data, size, last);
+}
+
+static int generic_mtd_stream_finish(void *ctx, const void *data, size_t size,
+				     bool commit)
+{
+	struct mtd_stream *ms = ctx;
+	struct mtd_info *mtd = ms->mtd;
+	int ret;
+
+	ret = mtd_stream_finish(ms, data, size, commit);
+
+	put_mtd_device(mtd);
+
+	return ret;
+}
+
+const struct data_stream_ops generic_mtd_bl2_stream_ops = {
+	.begin = generic_mtd_stream_bl2_begin,
+	.feed = generic_mtd_stream_feed,
+	.finish = generic_mtd_stream_finish,
+};
+
+const struct data_stream_ops generic_mtd_fip_stream_ops = {
+	.begin = generic_mtd_stream_fip_begin,
+	.feed = generic_mtd_stream_feed,
+	.finish = generic_mtd_stream_finish,
+};
+
 #ifdef CONFIG_MTD_UBI
 static int ubi_write_fip(struct ubi_volume *vol, const char *volname,
 			 const void *data, size_t size)
@@ -234,7 +302,7 @@ int generic_ubi_write_dual_fip(void *priv, const struct data_part_entry *dpe,
 	curr_bspconf.current_fip_slot = next_slot;
 	curr_bspconf.fip[next_slot].invalid = 0;
 	curr_bspconf.fip[next_slot].size = size;
-	curr_bspconf.fip[next_slot].crc32 = crc32(0, data, size);
+	curr_bspconf.fip[next_slot].crc32 = data_hash_crc32(data, size);
 	curr_bspconf.fip[next_slot].upd_cnt++;
 
 	return save_bsp_conf();
@@ -16,6 +16,7 @@ static const struct data_part_entry snor_emmc_parts[] = {
 		.env_name = "bootfile.bl2",
 		.validate = generic_validate_bl2,
 		.write = generic_mtd_write_bl2,
+		.stream = &generic_mtd_bl2_stream_ops,
 	},
 	{
 		.name = "ATF FIP",
@@ -24,6 +25,7 @@ static const struct data_part_entry snor_emmc_parts[] = {
 		.validate = generic_validate_fip,
 #if defined(CONFIG_FIP_IN_SPI_NOR)
 		.write = generic_mtd_write_fip,
+		.stream = &generic_mtd_fip_stream_ops,
 #elif defined(CONFIG_FIP_IN_EMMC)
 		.write = generic_mmc_write_fip,
 #endif
@@ -9,6 +9,7 @@
 #include "autoboot_helper.h"
 #include "mtd_helper.h"
 #include "bsp_conf.h"
+#include "verify_ledger.h"
 
 static const struct data_part_entry mtd_parts[] = {
 	{
@@ -143,6 +144,18 @@ int board_save_bsp_conf(const struct mtk_bsp_conf_data *bspconf, uint32_t index)
 }
 #endif
 
+#ifdef CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER
+int board_load_verify_ledger(void *data, size_t size)
+{
+	return ubi_load_verify_ledger(data, size);
+}
+
+int board_save_verify_ledger(const void *data, size_t size)
+{
+	return ubi_save_verify_ledger(data, size);
+}
+#endif
+
 int board_late_init(void)
 {
 	if (IS_ENABLED(CONFIG_MTK_BSPCONF_SUPPORT)) {
@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Incremental data hashing helper
+ */
+
+#include <cyclic.h>
+#include <errno.h>
+#include <image.h>
+#include <linux/string.h>
+#include <u-boot/crc.h>
+#include <asm/unaligned.h>
+
+#include "data_hash.h"
+
+static struct data_hash_ctx published;
+
+/**
+ * data_hash_init() - Start hashing a new data stream
+ *
+ * @param ctx: hash context
+ * @param algos: bitmask of DATA_HASH_* to be calculated
+ */
+void data_hash_init(struct data_hash_ctx *ctx, u32 algos)
+{
+	memset(ctx, 0, sizeof(*ctx));
+
+	ctx->algos = algos;
+
+	if (CONFIG_IS_ENABLED(MD5) && (algos & DATA_HASH_MD5))
+		MD5Init(&ctx->md5);
+
+	if (CONFIG_IS_ENABLED(SHA1) && (algos & DATA_HASH_SHA1))
+		sha1_starts(&ctx->sha1);
+
+	if (CONFIG_IS_ENABLED(SHA256) && (algos & DATA_HASH_SHA256))
+		sha256_starts(&ctx->sha256);
+}
+
+static void data_hash_block(struct data_hash_ctx *ctx, const void *data,
+			    size_t size)
+{
+	if (CONFIG_IS_ENABLED(MD5) && (ctx->algos & DATA_HASH_MD5))
+		MD5Update(&ctx->md5, data, size);
+
+	if (CONFIG_IS_ENABLED(SHA1) && (ctx->algos & DATA_HASH_SHA1))
+		sha1_update(&ctx->sha1, data, size);
+
+	if (CONFIG_IS_ENABLED(SHA256) && (ctx->algos & DATA_HASH_SHA256))
+		sha256_update(&ctx->sha256, data, size);
+
+	if (ctx->algos & DATA_HASH_CRC32)
+		ctx->crc32 = crc32(ctx->crc32, data, size);
+}
+
+/**
+ * data_hash_update() - Hash the next segment of a data stream
+ *
+ * @param ctx: hash context
+ * @param data: data segment
+ * @param size: size of the data segment
+ *
+ * All algorithms are updated with one block before moving to the next one,
+ * so the data is read from memory only once however many digests are used.
+ */
+void data_hash_update(struct data_hash_ctx *ctx, const void *data,
+		      size_t size)
+{
+	size_t chksz;
+
+	if (ctx->finished)
+		return;
+
+	if (ctx->limit && size > ctx->limit - ctx->size)
+		size = ctx->limit - ctx->size;
+
+	while (size) {
+		chksz = min_t(size_t, size, DATA_HASH_BLOCK_SIZE);
+
+		data_hash_block(ctx, data, chksz);
+
+		ctx->size += chksz;
+		data += chksz;
+		size -= chksz;
+
+		schedule();
+	}
+}
+
+/**
+ * data_hash_finish() - Finish hashing and bind digests to the data buffer
+ *
+ * @param ctx: hash context
+ * @param data: buffer holding the whole hashed data
+ * @param size: size of the buffer
+ *
+ * The digests are invalidated if @size does not match the amount of data
+ * hashed.
+ */
+void data_hash_finish(struct data_hash_ctx *ctx, const void *data,
+		      size_t size)
+{
+	if (ctx->finished)
+		return;
+
+	if (CONFIG_IS_ENABLED(MD5) && (ctx->algos & DATA_HASH_MD5))
+		MD5Final(ctx->md5_sum, &ctx->md5);
+
+	if (CONFIG_IS_ENABLED(SHA1) && (ctx->algos & DATA_HASH_SHA1))
+		sha1_finish(&ctx->sha1, ctx->sha1_sum);
+
+	if (CONFIG_IS_ENABLED(SHA256) && (ctx->algos & DATA_HASH_SHA256))
+		sha256_finish(&ctx->sha256, ctx->sha256_sum);
+
+	if (!CONFIG_IS_ENABLED(MD5))
+		ctx->algos &= ~DATA_HASH_MD5;
+
+	if (!CONFIG_IS_ENABLED(SHA1))
+		ctx->algos &= ~DATA_HASH_SHA1;
+
+	if (!CONFIG_IS_ENABLED(SHA256))
+		ctx->algos &= ~DATA_HASH_SHA256;
+
+	if (ctx->size != size)
+		ctx->algos = 0;
+
+	ctx->data = data;
+	ctx->finished = true;
+}
+
+/**
+ * data_hash_algo() - Get the DATA_HASH_* bit of an algorithm
+ *
+ * @param algo: algorithm name, same as calculate_hash()
+ *
+ * @return the bit, or 0 if the algorithm is not supported
+ */
+u32 data_hash_algo(const char *algo)
+{
+	if (!strcmp(algo, "md5"))
+		return DATA_HASH_MD5;
+
+	if (!strcmp(algo, "sha1"))
+		return DATA_HASH_SHA1;
+
+	if (!strcmp(algo, "sha256"))
+		return DATA_HASH_SHA256;
+
+	if (!strcmp(algo, "crc32"))
+		return DATA_HASH_CRC32;
+
+	return 0;
+}
+
+/**
+ * data_hash_get() - Get a digest of a finished hash context
+ *
+ * @param ctx: finished hash context
+ * @param algo: algorithm name, same as calculate_hash()
+ * @param value: output buffer
+ * @param value_len: output digest length
+ *
+ * @return 0 on success, -ENOENT if the digest was not calculated
+ */
+int data_hash_get(const struct data_hash_ctx *ctx, const char *algo,
+		  u8 *value, int *value_len)
+{
+	u32 bit = data_hash_algo(algo);
+
+	if (!ctx->finished || !(ctx->algos & bit))
+		return -ENOENT;
+
+	switch (bit) {
+	case DATA_HASH_MD5:
+		memcpy(value, ctx->md5_sum, MD5_SUM_LEN);
+		*value_len = MD5_SUM_LEN;
+		break;
+
+	case DATA_HASH_SHA1:
+		memcpy(value, ctx->sha1_sum, SHA1_SUM_LEN);
+		*value_len = SHA1_SUM_LEN;
+		break;
+
+	case DATA_HASH_SHA256:
+		memcpy(value, ctx->sha256_sum, SHA256_SUM_LEN);
+		*value_len = SHA256_SUM_LEN;
+		break;
+
+	default:
+		put_unaligned_be32(ctx->crc32, value);
+		*value_len = sizeof(u32);
+	}
+
+	return 0;
+}
+
+void data_hash_unpublish(void)
+{
+	memset(&published, 0, sizeof(published));
+}
+
+void data_hash_publish(const struct data_hash_ctx *ctx)
+{
+	if (ctx->finished)
+		memcpy(&published, ctx, sizeof(published));
+	else
+		data_hash_unpublish();
+}
+
+static bool data_hash_lookup(const void *data, size_t size, u32 algo)
+{
+	return published.finished && (published.algos & algo) &&
+	       published.data == data && published.size == size;
+}
+
+/**
+ * data_hash_calculate() - Calculate hash, reusing published digests
+ *
+ * @param data: data to be hashed
+ * @param size: size of data
+ * @param algo: algorithm name, same as calculate_hash()
+ * @param value: output buffer
+ * @param value_len: output digest length
+ *
+ * @return 0 on success, -1 if algorithm is not supported
+ */
+int data_hash_calculate(const void *data, size_t size, const char *algo,
+			u8 *value, int *value_len)
+{
+	if (data_hash_lookup(data, size, data_hash_algo(algo)))
+		return data_hash_get(&published, algo, value, value_len);
+
+	return calculate_hash(data, size, algo, value, value_len);
+}
+
+u32 data_hash_crc32(const void *data, size_t size)
+{
+	if (data_hash_lookup(data, size, DATA_HASH_CRC32))
+		return published.crc32;
+
+	return crc32(0, data, size);
+}
@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Incremental data hashing helper
+ */
+
+#ifndef _DATA_HASH_H_
+#define _DATA_HASH_H_
+
+#include <stdbool.h>
+#include <linux/bitops.h>
+#include <linux/sizes.h>
+#include <linux/types.h>
+#include <u-boot/md5.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+
+#define DATA_HASH_MD5		BIT(0)
+#define DATA_HASH_SHA1		BIT(1)
+#define DATA_HASH_SHA256	BIT(2)
+#define DATA_HASH_CRC32		BIT(3)
+
+/* Data is fed to all algorithms in blocks of this size while it is cached */
+#define DATA_HASH_BLOCK_SIZE	SZ_16K
+
+struct data_hash_ctx {
+	u32 algos;
+	bool finished;
+
+	/* Data after this amount is not hashed if non-zero */
+	size_t limit;
+
+	/* Data described by the digests, set by data_hash_finish() */
+	const void *data;
+	size_t size;
+
+	MD5Context md5;
+	sha1_context sha1;
+	sha256_context sha256;
+
+	u8 md5_sum[MD5_SUM_LEN];
+	u8 sha1_sum[SHA1_SUM_LEN];
+	u8 sha256_sum[SHA256_SUM_LEN];
+	u32 crc32;
+};
+
+void data_hash_init(struct data_hash_ctx *ctx, u32 algos);
+void data_hash_update(struct data_hash_ctx *ctx, const void *data,
+		      size_t size);
+void data_hash_finish(struct data_hash_ctx *ctx, const void *data,
+		      size_t size);
+
+u32 data_hash_algo(const char *algo);
+int data_hash_get(const struct data_hash_ctx *ctx, const char *algo,
+		  u8 *value, int *value_len);
+
+/* Make finished digests available to data_hash_calculate() */
+void data_hash_publish(const struct data_hash_ctx *ctx);
+void data_hash_unpublish(void);
+
+int data_hash_calculate(const void *data, size_t size, const char *algo,
+			u8 *value, int *value_len);
+u32 data_hash_crc32(const void *data, size_t size);
+
+#endif /* _DATA_HASH_H_ */
@@ -122,3 +122,85 @@ int failsafe_write_image(const void *data, size_t size, failsafe_fw_t fw)
 
 	return 0;
 }
+
+static const struct data_part_entry *stream_dpe;
+static void *stream_ctx;
+
+int failsafe_stream_begin(failsafe_fw_t fw)
+{
+	const struct data_part_entry *upgrade_parts, *dpe;
+	u32 num_parts;
+	int ret;
+
+	board_upgrade_data_parts(&upgrade_parts, &num_parts);
+
+	if (!upgrade_parts || !num_parts)
+		return -ENOSYS;
+
+	dpe = find_part(upgrade_parts, num_parts, fw_to_part_name(fw));
+	if (!dpe)
+		return -ENODEV;
+
+	if (!dpe->stream)
+		return -EOPNOTSUPP;
+
+	printf("\n");
+	cprintln(PROMPT, "*** Upgrading %s while receiving ***", dpe->name);
+	printf("\n");
+
+	ret = dpe->stream->begin(dpe->priv, dpe, &stream_ctx);
+	if (ret)
+		return ret;
+
+#ifdef CONFIG_CMD_GL_BTN
+	led_control("led", "system_led", "off");
+	led_control("ledblink", "blink_led", "100");
+#endif
+
+	stream_dpe = dpe;
+
+	return 0;
+}
+
+int failsafe_stream_feed(const void *data, size_t size, bool last)
+{
+	if (!stream_dpe)
+		return -EINVAL;
+
+	return stream_dpe->stream->feed(stream_ctx, data, size, last);
+}
+
+int failsafe_stream_finish(const void *data, size_t size, bool commit)
+{
+	const struct data_part_entry *dpe = stream_dpe;
+	int ret;
+
+	if (!dpe)
+		return -EINVAL;
+
+	stream_dpe = NULL;
+
+	ret = dpe->stream->finish(stream_ctx, data, size, commit);
+#ifdef CONFIG_CMD_GL_BTN
+	led_control("ledblink", "blink_led", "0");
+	led_control("led", "system_led", "on");
+#endif
+	if (ret)
+		return ret;
+
+	if (!commit) {
+		printf("\n");
+		cprintln(ERROR, "*** %s upgrade aborted! ***", dpe->name);
+		printf("\n");
+		return 0;
+	}
+
+	printf("\n");
+	cprintln(PROMPT, "*** %s upgrade completed! ***", dpe->name);
+	printf("\n");
+
+	if (dpe->do_post_action)
+		dpe->do_post_action(dpe->priv, dpe, data, size);
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Read-back verification of flash writes
+ *
+ * Written data is read back in pieces as large as whole blocks instead of
+ * single pages, which lets flash drivers use multi-page reads. The CRC32 of
+ * the data read back is calculated while it is still in the cache, and
+ * compared with the CRC32 of the data written, instead of comparing both
+ * byte by byte.
+ */
+
+#include <errno.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <u-boot/crc.h>
+
+#include "colored_print.h"
+#include "flash_verify.h"
+
+/**
+ * flash_verify_init() - Start a verification stage
+ *
+ * @param fv: verification stage
+ * @param read: function reading data back from the flash
+ * @param priv: argument passed to @read
+ * @param base: offset added to addresses in messages
+ * @param buf_size: size of the read-back buffer, normally the size of the
+ *		    regions to be added
+ * @return 0 on success, -ENOMEM if the buffer can not be allocated
+ */
+int flash_verify_init(struct flash_verify *fv, flash_verify_read_t read,
+		      void *priv, u64 base, size_t buf_size)
+{
+	memset(fv, 0, sizeof(*fv));
+
+	fv->buf = malloc_cache_aligned(buf_size);
+	if (!fv->buf) {
+		cprintln(ERROR, "*** Insufficient memory for verifying! ***");
+		return -ENOMEM;
+	}
+
+	fv->read = read;
+	fv->priv = priv;
+	fv->base = base;
+	fv->buf_size = buf_size;
+
+	return 0;
+}
+
+static int flash_verify_region(struct flash_verify *fv, u64 addr,
+			       size_t size, u32 expected)
+{
+	size_t chksz, off = 0;
+	u32 crc = 0;
+	int ret;
+
+	while (off < size) {
+		chksz = min(size - off, fv->buf_size);
+
+		ret = fv->read(fv->priv, addr + off, fv->buf, chksz);
+		if (ret) {
+			printf("Failed to read at 0x%llx, err = %d\n",
+			       fv->base + addr + off, ret);
+			return ret;
+		}
+
+		crc = crc32(crc, fv->buf, chksz);
+		off += chksz;
+	}
+
+	if (crc == expected)
+		return 0;
+
+	printf("Fail\n");
+	cprintln(ERROR, "*** Verification failed at 0x%llx, size 0x%zx! ***",
+		 fv->base + addr, size);
+	cprintln(ERROR, "*** Expected CRC32 0x%08x, got 0x%08x ***", expected,
+		 crc);
+	cprintln(ERROR, "*** Data is damaged, please retry! ***");
+
+	return -EBADMSG;
+}
+
+/**
+ * flash_verify_add() - Verify a region which has just been written
+ *
+ * @param fv: verification stage
+ * @param addr: address of the region
+ * @param data: data written to the region
+ * @param size: size of the region
+ * @return 0 on success, negative error code if the region failed
+ */
+int flash_verify_add(struct flash_verify *fv, u64 addr, const void *data,
+		     size_t size)
+{
+	return flash_verify_region(fv, addr, size, crc32(0, data, size));
+}
+
+/**
+ * flash_verify_finish() - End the verification stage
+ *
+ * @param fv: verification stage
+ * @return 0
+ */
+int flash_verify_finish(struct flash_verify *fv)
+{
+	flash_verify_abort(fv);
+
+	return 0;
+}
+
+/**
+ * flash_verify_abort() - End the stage on failure
+ *
+ * @param fv: verification stage
+ */
+void flash_verify_abort(struct flash_verify *fv)
+{
+	free(fv->buf);
+
+	fv->buf = NULL;
+}
@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Read-back verification of flash writes
+ */
+
+#ifndef _FLASH_VERIFY_H_
+#define _FLASH_VERIFY_H_
+
+#include <linux/types.h>
+
+typedef int (*flash_verify_read_t)(void *priv, u64 addr, void *buf,
+				   size_t size);
+
+/*
+ * Each region is read back right after it has been written, in pieces as
+ * large as the buffer, and the CRC32 of the data read back is compared with
+ * the CRC32 of the data written.
+ */
+struct flash_verify {
+	flash_verify_read_t read;
+	void *priv;
+
+	/* Added to addresses in messages */
+	u64 base;
+
+	u8 *buf;
+	size_t buf_size;
+};
+
+int flash_verify_init(struct flash_verify *fv, flash_verify_read_t read,
+		      void *priv, u64 base, size_t buf_size);
+int flash_verify_add(struct flash_verify *fv, u64 addr, const void *data,
+		     size_t size);
+int flash_verify_finish(struct flash_verify *fv);
+void flash_verify_abort(struct flash_verify *fv);
+
+#endif /* _FLASH_VERIFY_H_ */
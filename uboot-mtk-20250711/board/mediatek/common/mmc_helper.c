@@ -47,6 +47,12 @@
 
 #define PART_PRODUCTION_NAME	"production"
 
+/* Piece of data read at a time when hashing while reading */
+#define MMC_READ_HASH_CHUNK	SZ_256K
+
+/* Piece of data compared at a time when writing only changed data */
+#define MMC_DELTA_CHUNK		SZ_64K
+
 struct mmc_image_read_priv {
 	struct image_read_priv p;
 	struct mmc *mmc;
@@ -141,13 +147,146 @@ static const char *mmc_hwpart_name(struct mmc *mmc)
 	}
 }
 
+static int mmc_verify_range(struct mmc *mmc, u64 offset, const void *data,
+			    size_t size, u8 *vbuff, size_t vbuff_size)
+{
+	size_t size_left, chksz;
+	u64 verify_offset;
+	u32 blks, n;
+
+	size_left = size;
+	verify_offset = 0;
+
+	while (size_left) {
+		chksz = min(vbuff_size, size_left);
+		blks = (chksz + mmc->read_bl_len - 1) / mmc->read_bl_len;
+
+		n = blk_dread(mmc_get_blk_desc(mmc),
+			      (offset + verify_offset) / mmc->read_bl_len,
+			      blks, vbuff);
+
+		if (n != blks) {
+			printf("Fail\n");
+			cprintln(ERROR, "*** Only 0x%zx read! ***",
+				 (size_t)n * mmc->read_bl_len);
+			return -EIO;
+		}
+
+		if (!verify_data(data + verify_offset, vbuff,
+				 offset + verify_offset, chksz))
+			return -EIO;
+
+		verify_offset += chksz;
+		size_left -= chksz;
+	}
+
+	return 0;
+}
+
+static int mmc_write_delta_run(struct mmc *mmc, u64 offset, const void *data,
+			       size_t size, u8 *vbuff, bool verify)
+{
+	u32 blks, n;
+
+	blks = (size + mmc->write_bl_len - 1) / mmc->write_bl_len;
+
+	n = blk_dwrite(mmc_get_blk_desc(mmc), offset / mmc->write_bl_len, blks,
+		       data);
+	if (n != blks) {
+		printf("Fail\n");
+		cprintln(ERROR, "*** Only 0x%zx written at 0x%llx! ***",
+			 (size_t)n * mmc->write_bl_len, offset);
+		return -EIO;
+	}
+
+	if (!verify)
+		return 0;
+
+	return mmc_verify_range(mmc, offset, data, size, vbuff,
+				MMC_DELTA_CHUNK);
+}
+
+/**
+ * mmc_write_delta() - Write data, skipping parts already stored
+ *
+ * @description:
+ * The stored data is read and compared in chunks of MMC_DELTA_CHUNK.
+ * Each run of changed chunks is written by one request, and read back for
+ * verification if requested.
+ *
+ * @param mmc: MMC device
+ * @param offset: Offset to write to, aligned to the block size
+ * @param data: Pointer to the data to be written
+ * @param size: Size of the data
+ * @param verify: Whether to verify the data written
+ * @return 0 on success, -ENOMEM if there is no memory for the compare
+ *	   buffer, other negative error code on failure
+ */
+static int mmc_write_delta(struct mmc *mmc, u64 offset, const void *data,
+			   size_t size, bool verify)
+{
+	size_t pos = 0, run_pos = 0, run_size = 0, changed = 0, chksz;
+	u32 blks, n;
+	int ret = 0;
+	u8 *buf;
+
+	buf = malloc_cache_aligned(MMC_DELTA_CHUNK);
+	if (!buf)
+		return -ENOMEM;
+
+	printf("Updating %s from 0x%lx to 0x%llx, size 0x%zx ... ",
+	       mmc_hwpart_name(mmc), (ulong)data, offset, size);
+
+	while (pos < size || run_size) {
+		if (pos < size) {
+			chksz = min_t(size_t, MMC_DELTA_CHUNK, size - pos);
+			blks = (chksz + mmc->read_bl_len - 1) /
+			       mmc->read_bl_len;
+
+			n = blk_dread(mmc_get_blk_desc(mmc),
+				      (offset + pos) / mmc->read_bl_len, blks,
+				      buf);
+
+			/* Unreadable data is simply rewritten */
+			if (n != blks || memcmp(buf, data + pos, chksz)) {
+				if (!run_size)
+					run_pos = pos;
+
+				run_size += chksz;
+				pos += chksz;
+				continue;
+			}
+
+			pos += chksz;
+		}
+
+		if (!run_size)
+			continue;
+
+		ret = mmc_write_delta_run(mmc, offset + run_pos, data + run_pos,
+					  run_size, buf, verify);
+		if (ret)
+			goto out;
+
+		changed += run_size;
+		run_size = 0;
+	}
+
+	printf("OK\n");
+	printf("0x%zx of 0x%zx bytes changed\n", changed, size);
+
+out:
+	free(buf);
+
+	return ret;
+}
+
 int _mmc_write(struct mmc *mmc, u64 offset, size_t max_size, const void *data,
 	       size_t size, bool verify)
 {
 	u8 vbuff[MMC_MAX_BLOCK_LEN * 4];
-	size_t size_left, chksz;
-	u64 verify_offset;
 	u32 blks, n;
+	int ret;
 
 	if (check_data_size(mmc->capacity, offset, max_size, size, true))
 		return -EINVAL;
@@ -157,6 +296,12 @@ int _mmc_write(struct mmc *mmc, u64 offset, size_t max_size, const void *data,
 		return -EINVAL;
 	}
 
+	if (IS_ENABLED(CONFIG_MTK_UPGRADE_DELTA)) {
+		ret = mmc_write_delta(mmc, offset, data, size, verify);
+		if (ret != -ENOMEM)
+			return ret;
+	}
+
 	blks = (size + mmc->write_bl_len - 1) / mmc->write_bl_len;
 
 	printf("Writing %s from 0x%lx to 0x%llx, size 0x%zx ... ",
@@ -179,38 +324,17 @@ int _mmc_write(struct mmc *mmc, u64 offset, size_t max_size, const void *data,
 	printf("Verifying from 0x%llx to 0x%llx, size 0x%zx ... ", offset,
 	       offset + size - 1, size);
 
-	size_left = size;
-	verify_offset = 0;
-
-	while (size_left) {
-		chksz = min(sizeof(vbuff), size_left);
-		blks = (chksz + mmc->read_bl_len - 1) / mmc->read_bl_len;
-
-		n = blk_dread(mmc_get_blk_desc(mmc),
-			      (offset + verify_offset) / mmc->read_bl_len,
-			      blks, vbuff);
-
-		if (n != blks) {
-			printf("Fail\n");
-			cprintln(ERROR, "*** Only 0x%zx read! ***",
-				 (size_t)n * mmc->read_bl_len);
-			return -EIO;
-		}
-
-		if (!verify_data(data + verify_offset, vbuff,
-				 offset + verify_offset, chksz))
-			return -EIO;
-
-		verify_offset += chksz;
-		size_left -= chksz;
-	}
+	ret = mmc_verify_range(mmc, offset, data, size, vbuff, sizeof(vbuff));
+	if (ret)
+		return ret;
 
 	printf("OK\n");
 
 	return 0;
 }
 
-int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
+static int __mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size,
+		      struct data_hash_ctx *ctx)
 {
 	u8 rbuff[MMC_MAX_BLOCK_LEN];
 	u32 blks, n;
@@ -236,6 +360,10 @@ int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
 		}
 
 		memcpy(data, rbuff, chksz);
+
+		if (ctx)
+			data_hash_update(ctx, data, chksz);
+
 		offset += chksz;
 		data += chksz;
 		size -= chksz;
@@ -244,8 +372,14 @@ int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
 			goto success;
 	}
 
-	if (size >= mmc->read_bl_len) {
+	while (size >= mmc->read_bl_len) {
 		blks = size / mmc->read_bl_len;
+
+		/* Hash the data in pieces, right after each is read */
+		if (ctx)
+			blks = min_t(u32, blks,
+				     MMC_READ_HASH_CHUNK / mmc->read_bl_len);
+
 		chksz = (size_t)blks * mmc->read_bl_len;
 
 		n = blk_dread(mmc_get_blk_desc(mmc), offset / mmc->read_bl_len,
@@ -258,6 +392,9 @@ int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
 			return -EIO;
 		}
 
+		if (ctx)
+			data_hash_update(ctx, data, chksz);
+
 		offset += chksz;
 		data += chksz;
 		size -= chksz;
@@ -274,6 +411,9 @@ int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
 		}
 
 		memcpy(data, rbuff, size);
+
+		if (ctx)
+			data_hash_update(ctx, data, size);
 	}
 
 success:
@@ -282,6 +422,11 @@ success:
 	return 0;
 }
 
+int _mmc_read(struct mmc *mmc, u64 offset, void *data, size_t size)
+{
+	return __mmc_read(mmc, offset, data, size, NULL);
+}
+
 static ulong _mmc_erase_real(struct mmc *mmc, u32 start_blk, u32 blks)
 {
 	return blk_derase(mmc_get_blk_desc(mmc), start_blk, blks);
@@ -927,8 +1072,9 @@ int boot_from_mmc_partition(u32 dev, u32 hwpart, const char *part_name,
 	return _boot_from_mmc_partition(mmc, part_name, do_boot);
 }
 
-static int mmc_image_read(struct image_read_priv *rpriv, void *buff, u64 addr,
-			   size_t size)
+static int mmc_image_read_hash(struct image_read_priv *rpriv, void *buff,
+				u64 addr, size_t size,
+				struct data_hash_ctx *ctx)
 {
 	struct mmc_image_read_priv *priv =
 		container_of(rpriv, struct mmc_image_read_priv, p);
@@ -945,8 +1091,14 @@ static int mmc_image_read(struct image_read_priv *rpriv, void *buff, u64 addr,
 	if (addr + size > part_size)
 		return -EINVAL;
 
-	return _mmc_read(priv->mmc, (u64)dpart.start * dpart.blksz + addr, buff,
-			 size);
+	return __mmc_read(priv->mmc, (u64)dpart.start * dpart.blksz + addr,
+			  buff, size, ctx);
+}
+
+static int mmc_image_read(struct image_read_priv *rpriv, void *buff, u64 addr,
+			   size_t size)
+{
+	return mmc_image_read_hash(rpriv, buff, addr, size, NULL);
 }
 
 static int mmc_boot_verify(struct mmc *mmc, const struct dual_boot_slot *slot,
@@ -963,6 +1115,7 @@ static int mmc_boot_verify(struct mmc *mmc, const struct dual_boot_slot *slot,
 	read_priv.p.page_size = MMC_MAX_BLOCK_LEN;
 	read_priv.p.block_size = 0;
 	read_priv.p.read = mmc_image_read;
+	read_priv.p.read_hash = mmc_image_read_hash;
 
 	read_priv.part = slot->kernel;
 	kernel_data = (void *)loadaddr;
@@ -28,6 +28,8 @@
 #include "mtd_helper.h"
 #include "dual_boot.h"
 #include "bsp_conf.h"
+#include "verify_ledger.h"
+#include "flash_verify.h"
 #include "rootdisk.h"
 #include "untar.h"
 
@@ -196,66 +198,24 @@ int mtd_erase_skip_bad(struct mtd_info *mtd, u64 offset, u64 size,
 	return 0;
 }
 
-static int mtd_validate_block(struct mtd_info *mtd, u64 addr, size_t size,
-			      const void *data)
+static int mtd_verify_read(void *priv, u64 addr, void *buf, size_t size)
 {
+	struct mtd_info *mtd = priv;
 	struct mtd_oob_ops ops;
-	size_t col, chksz;
 	int ret;
 
-	static u8 *vbuff_ptr = NULL;
-	static size_t vbuff_sz = 0;
-
-	if (mtd->writesize > vbuff_sz) {
-		if (!vbuff_ptr) {
-			vbuff_ptr = malloc(mtd->writesize);
-		} else {
-			u8 *tptr = realloc(vbuff_ptr, mtd->writesize);
-			if (tptr) {
-				vbuff_ptr = tptr;
-			} else {
-				free(vbuff_ptr);
-				vbuff_ptr = NULL;
-			}
-		}
-
-		if (!vbuff_ptr) {
-			cprintln(ERROR,
-				 "*** Insufficient memory for verifying! ***");
-			return -ENOMEM;
-		}
-
-		vbuff_sz = mtd->writesize;
-	}
-
 	memset(&ops, 0, sizeof(ops));
 
-	while (size) {
-		col = addr & mtd->writesize_mask;
-
-		chksz = mtd->writesize - col;
-		if (chksz > size)
-			chksz = size;
+	ops.mode = MTD_OPS_AUTO_OOB;
+	ops.datbuf = buf;
+	ops.len = size;
 
-		ops.mode = MTD_OPS_AUTO_OOB;
-		ops.datbuf = vbuff_ptr;
-		ops.len = chksz;
-		ops.retlen = 0;
-
-		ret = mtd_read_oob(mtd, addr, &ops);
-		if (ret && ret != -EUCLEAN) {
-			printf("Failed to read at 0x%llx, err = %d\n",
-			       mtd->offset + addr, ret);
-			return ret;
-		}
+	ret = mtd_read_oob(mtd, addr, &ops);
+	if (ret && ret != -EUCLEAN)
+		return ret;
 
-		if (!verify_data(data, vbuff_ptr, mtd->offset + addr, chksz))
-			return -EBADMSG;
-
-		size -= chksz;
-		addr += chksz;
-		data = (char *)data + chksz;
-	}
+	if (ops.retlen != size)
+		return -EIO;
 
 	return 0;
 }
@@ -264,12 +224,13 @@ int mtd_write_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 		       u64 maxsize, size_t *writtensize, const void *data,
 		       bool verify)
 {
+	struct flash_verify fv = { 0 };
 	struct mtd_oob_ops ops;
 	bool checkbad = true;
 	size_t len, chksz;
 	u64 addr, limit;
 	u32 blockoff;
-	int ret;
+	int ret = 0;
 
 	if (!mtd)
 		return -EINVAL;
@@ -307,13 +268,20 @@ int mtd_write_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 	if (writtensize)
 		*writtensize = 0;
 
+	if (verify) {
+		ret = flash_verify_init(&fv, mtd_verify_read, mtd, mtd->offset,
+					mtd->erasesize);
+		if (ret)
+			return ret;
+	}
+
 	while (len && addr < limit) {
 		if (checkbad || !(addr & mtd->erasesize_mask)) {
 			ret = mtd_block_isbad(mtd, addr);
 			if (ret < 0) {
 				printf("Failed to check bad block at 0x%llx\n",
 				       mtd->offset + addr);
-				return ret;
+				goto out;
 			}
 
 			if (ret) {
@@ -345,13 +313,13 @@ int mtd_write_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 		if (ret) {
 			printf("Failed at 0x%llx, err = %d\n",
 			       mtd->offset + addr, ret);
-			return ret;
+			goto out;
 		}
 
 		if (verify) {
-			ret = mtd_validate_block(mtd, addr, chksz, data);
+			ret = flash_verify_add(&fv, addr, data, ops.retlen);
 			if (ret)
-				return ret;
+				goto out;
 		}
 
 		addr += ops.retlen;
@@ -364,12 +332,24 @@ int mtd_write_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 
 	if (len) {
 		printf("Incomplete write\n");
-		return -ENODATA;
+		ret = -ENODATA;
+		goto out;
+	}
+
+	if (verify) {
+		ret = flash_verify_finish(&fv);
+		if (ret)
+			return ret;
 	}
 
 	printf("OK\n");
 
 	return 0;
+
+out:
+	flash_verify_abort(&fv);
+
+	return ret;
 }
 
 int mtd_read_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
@@ -474,11 +454,222 @@ int mtd_read_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 	return 0;
 }
 
+static bool mtd_delta_ec_hdr_valid(const struct ubi_ec_hdr *ec_hdr)
+{
+	u32 crc;
+
+	if (be32_to_cpu(ec_hdr->magic) != UBI_EC_HDR_MAGIC)
+		return false;
+
+	crc = crc32(UBI_CRC32_INIT, ec_hdr, UBI_EC_HDR_SIZE_CRC);
+
+	return crc == be32_to_cpu(ec_hdr->hdr_crc);
+}
+
+/* Compare two UBI EC headers, except the erase counter and the CRC */
+static bool mtd_delta_ec_hdr_same(const struct ubi_ec_hdr *a,
+				  const struct ubi_ec_hdr *b)
+{
+	size_t ec_end = offsetof(struct ubi_ec_hdr, ec) + sizeof(a->ec);
+
+	return !memcmp(a, b, offsetof(struct ubi_ec_hdr, ec)) &&
+	       !memcmp((const u8 *)a + ec_end, (const u8 *)b + ec_end,
+		       UBI_EC_HDR_SIZE_CRC - ec_end);
+}
+
+/**
+ * mtd_update_delta() - Update a MTD partition, skipping unchanged blocks
+ *
+ * @description:
+ * Same as erasing and writing @data from the start of @mtd, except that
+ * each good block is read first, and erased and programmed only if its
+ * content differs from the new data. The part of the last block beyond
+ * @data must be erased to be unchanged. Blocks reporting bitflips above
+ * the threshold are always rewritten.
+ *
+ * For UBI images, a block differing only in the erase counter of its EC
+ * header is left alone. A rewritten block takes the erase counter found on
+ * flash plus one, so that erase counters survive the upgrade.
+ *
+ * @param mtd: MTD partition to be updated
+ * @param data: Pointer to the new data
+ * @param size: Size of the new data
+ * @param verify: Whether to verify blocks written
+ * @return 0 on success, -ENOMEM if there is no memory for the block buffer,
+ *	   other negative error code on failure
+ */
+static int mtd_update_delta(struct mtd_info *mtd, const void *data,
+			    size_t size, bool verify)
+{
+	struct flash_verify fv = { 0 };
+	u32 blocks = 0, changed = 0;
+	struct ubi_ec_hdr *ec_hdr;
+	struct mtd_oob_ops ops;
+	struct erase_info ei;
+	size_t chksz, retlen;
+	bool same, ubi;
+	size_t hdrsz;
+	u64 addr = 0;
+	u64 ec;
+	u8 *buf;
+	int ret;
+
+	if (check_data_size(mtd->size, 0, mtd->size, size, true))
+		return -EINVAL;
+
+	buf = malloc(mtd->erasesize);
+	if (!buf)
+		return -ENOMEM;
+
+	ec_hdr = (struct ubi_ec_hdr *)buf;
+
+	if (verify) {
+		ret = flash_verify_init(&fv, mtd_verify_read, mtd, mtd->offset,
+					mtd->erasesize);
+		if (ret)
+			goto out;
+	}
+
+	printf("Updating '%s' from 0x%lx to 0x%llx, size 0x%zx ... ",
+	       mtd->name, (ulong)data, mtd->offset, size);
+
+	memset(&ei, 0, sizeof(ei));
+	memset(&ops, 0, sizeof(ops));
+
+	ei.mtd = mtd;
+
+	while (size) {
+		if (addr >= mtd->size) {
+			printf("Incomplete write\n");
+			ret = -ENODATA;
+			goto out;
+		}
+
+		ret = mtd_block_isbad(mtd, addr);
+		if (ret < 0) {
+			printf("Failed to check bad block at 0x%llx\n",
+			       mtd->offset + addr);
+			goto out;
+		}
+
+		if (ret) {
+			printf("Skipped bad block at 0x%llx\n",
+			       mtd->offset + addr);
+			addr += mtd->erasesize;
+			continue;
+		}
+
+		chksz = min_t(size_t, size, mtd->erasesize);
+		blocks++;
+
+		ubi = chksz >= UBI_EC_HDR_SIZE &&
+		      be32_to_cpu(((const struct ubi_ec_hdr *)data)->magic) ==
+		      UBI_EC_HDR_MAGIC;
+
+		ret = mtd_read(mtd, addr, mtd->erasesize, &retlen, buf);
+		if (ret && ret != -EUCLEAN && ret != -EBADMSG) {
+			printf("Failed to read at 0x%llx, err = %d\n",
+			       mtd->offset + addr, ret);
+			goto out;
+		}
+
+		same = !ret && retlen == mtd->erasesize;
+
+		if (ubi && !mtd_delta_ec_hdr_valid(ec_hdr))
+			ubi = false;
+
+		if (same) {
+			hdrsz = 0;
+			if (ubi && mtd_delta_ec_hdr_same(data, ec_hdr))
+				hdrsz = UBI_EC_HDR_SIZE;
+
+			same = !memcmp(buf + hdrsz, data + hdrsz,
+				       chksz - hdrsz) &&
+			       !memchr_inv(buf + chksz, 0xff,
+					   mtd->erasesize - chksz);
+		}
+
+		if (same)
+			goto next;
+
+		/* Carry the erase counter on flash over to the new header */
+		if (ubi) {
+			ec = be64_to_cpu(ec_hdr->ec) + 1;
+			if (ec > UBI_MAX_ERASECOUNTER)
+				ec = UBI_MAX_ERASECOUNTER;
+
+			memcpy(buf, data, chksz);
+			ec_hdr->ec = cpu_to_be64(ec);
+			ec_hdr->hdr_crc = cpu_to_be32(crc32(UBI_CRC32_INIT,
+							    ec_hdr,
+							    UBI_EC_HDR_SIZE_CRC));
+		}
+
+		ei.addr = addr;
+		ei.len = mtd->erasesize;
+
+		ret = mtd_erase(mtd, &ei);
+		if (ret) {
+			printf("Failed to erase at 0x%llx, err = %d\n",
+			       mtd->offset + addr, ret);
+			goto out;
+		}
+
+		ops.mode = MTD_OPS_AUTO_OOB;
+		ops.datbuf = ubi ? buf : (void *)data;
+		ops.len = chksz;
+		ops.retlen = 0;
+
+		ret = mtd_write_oob(mtd, addr, &ops);
+		if (ret) {
+			printf("Failed at 0x%llx, err = %d\n",
+			       mtd->offset + addr, ret);
+			goto out;
+		}
+
+		if (verify) {
+			ret = flash_verify_add(&fv, addr, ops.datbuf, chksz);
+			if (ret)
+				goto out;
+		}
+
+		changed++;
+
+	next:
+		addr += mtd->erasesize;
+		data += chksz;
+		size -= chksz;
+	}
+
+	if (verify) {
+		ret = flash_verify_finish(&fv);
+		if (ret)
+			goto out;
+	}
+
+	printf("OK\n");
+	printf("%u of %u blocks changed\n", changed, blocks);
+
+	ret = 0;
+
+out:
+	flash_verify_abort(&fv);
+	free(buf);
+
+	return ret;
+}
+
 int mtd_update_generic(struct mtd_info *mtd, const void *data, size_t size,
 		       bool verify)
 {
 	int ret;
 
+	if (IS_ENABLED(CONFIG_MTK_UPGRADE_DELTA)) {
+		ret = mtd_update_delta(mtd, data, size, verify);
+		if (ret != -ENOMEM)
+			return ret;
+	}
+
 	ret = mtd_erase_skip_bad(mtd, 0, size, mtd->size, NULL, NULL, NULL,
 				 true);
 	if (ret)
@@ -487,6 +678,207 @@ int mtd_update_generic(struct mtd_info *mtd, const void *data, size_t size,
 	return mtd_write_skip_bad(mtd, 0, size, mtd->size, NULL, data, verify);
 }
 
+/*
+ * Streaming update of a MTD partition. Erasing runs one block ahead of the
+ * received data, and each block is programmed as soon as it has been fully
+ * received. The first good block is left erased until the stream is
+ * committed.
+ */
+static int mtd_stream_next_good(struct mtd_stream *ms, u64 *addr)
+{
+	struct mtd_info *mtd = ms->mtd;
+	int ret;
+
+	while (*addr < mtd->size) {
+		ret = mtd_block_isbad(mtd, *addr);
+		if (ret < 0) {
+			printf("Failed to check bad block at 0x%llx\n",
+			       mtd->offset + *addr);
+			return ret;
+		}
+
+		if (!ret)
+			return 0;
+
+		printf("Skipped bad block at 0x%llx\n", mtd->offset + *addr);
+		*addr += mtd->erasesize;
+	}
+
+	return -ENOSPC;
+}
+
+static int mtd_stream_erase(struct mtd_stream *ms, u32 count)
+{
+	struct mtd_info *mtd = ms->mtd;
+	struct erase_info ei;
+	int ret;
+
+	memset(&ei, 0, sizeof(ei));
+
+	ei.mtd = mtd;
+	ei.len = mtd->erasesize;
+
+	while (ms->erased < count) {
+		ret = mtd_stream_next_good(ms, &ms->erase_addr);
+		if (ret)
+			return ret;
+
+		ei.addr = ms->erase_addr;
+
+		ret = mtd_erase(mtd, &ei);
+		if (ret) {
+			printf("Failed to erase at 0x%llx, err = %d\n",
+			       mtd->offset + ms->erase_addr, ret);
+			return ret;
+		}
+
+		ms->erase_addr += mtd->erasesize;
+		ms->erased++;
+	}
+
+	return 0;
+}
+
+static int mtd_stream_program(struct mtd_stream *ms, u64 addr,
+			      const void *data, size_t size)
+{
+	struct mtd_info *mtd = ms->mtd;
+	struct mtd_oob_ops ops;
+	int ret;
+
+	memset(&ops, 0, sizeof(ops));
+
+	ops.mode = MTD_OPS_AUTO_OOB;
+	ops.datbuf = (void *)data;
+	ops.len = size;
+
+	ret = mtd_write_oob(mtd, addr, &ops);
+	if (ret) {
+		printf("Failed to write at 0x%llx, err = %d\n",
+		       mtd->offset + addr, ret);
+		return ret;
+	}
+
+	if (ms->verify)
+		return flash_verify_add(&ms->fv, addr, data, size);
+
+	return 0;
+}
+
+int mtd_stream_begin(struct mtd_info *mtd, bool verify,
+		     struct mtd_stream **retms)
+{
+	struct mtd_stream *ms;
+	int ret;
+
+	if (!mtd || !retms)
+		return -EINVAL;
+
+	ms = calloc(1, sizeof(*ms));
+	if (!ms)
+		return -ENOMEM;
+
+	ms->mtd = mtd;
+	ms->verify = verify;
+
+	if (verify) {
+		ret = flash_verify_init(&ms->fv, mtd_verify_read, mtd,
+					mtd->offset, mtd->erasesize);
+		if (ret) {
+			free(ms);
+			return ret;
+		}
+	}
+
+	*retms = ms;
+
+	return 0;
+}
+
+int mtd_stream_feed(struct mtd_stream *ms, const void *data, size_t size,
+		    bool last)
+{
+	struct mtd_info *mtd = ms->mtd;
+	size_t off, len;
+	u32 ready;
+	int ret;
+
+	/* Blocks fully received (all blocks if no more data will come) */
+	if (last)
+		ready = DIV_ROUND_UP(size, mtd->erasesize);
+	else
+		ready = size / mtd->erasesize;
+
+	ret = mtd_stream_erase(ms, ready);
+	if (ret)
+		goto out;
+
+	/* Keep one erased block ahead of the incoming data */
+	if (!last && (u64)size < mtd->size) {
+		ret = mtd_stream_erase(ms, ready + 1);
+		if (ret && ret != -ENOSPC)
+			return ret;
+	}
+
+	while (ms->programmed < ready) {
+		ret = mtd_stream_next_good(ms, &ms->prog_addr);
+		if (ret)
+			goto out;
+
+		if (!ms->programmed) {
+			ms->head_addr = ms->prog_addr;
+		} else {
+			off = (size_t)ms->programmed * mtd->erasesize;
+			len = min_t(size_t, size - off, mtd->erasesize);
+
+			ret = mtd_stream_program(ms, ms->prog_addr,
+						 data + off, len);
+			if (ret)
+				return ret;
+		}
+
+		ms->prog_addr += mtd->erasesize;
+		ms->programmed++;
+	}
+
+	return 0;
+
+out:
+	if (ret == -ENOSPC) {
+		printf("\n");
+		cprintln(ERROR, "*** Data size pasts partition size! ***");
+	}
+
+	return ret;
+}
+
+int mtd_stream_finish(struct mtd_stream *ms, const void *data, size_t size,
+		      bool commit)
+{
+	struct mtd_info *mtd = ms->mtd;
+	int ret = 0;
+
+	if (commit && size) {
+		printf("Writing '%s' from 0x%lx to 0x%llx, size 0x%zx ... ",
+		       mtd->name, (ulong)data, mtd->offset, size);
+
+		ret = mtd_stream_feed(ms, data, size, true);
+		if (!ret)
+			ret = mtd_stream_program(ms, ms->head_addr, data,
+						 min_t(size_t, size,
+						       mtd->erasesize));
+		if (!ret && ms->verify)
+			ret = flash_verify_finish(&ms->fv);
+		if (!ret)
+			printf("OK\n");
+	}
+
+	flash_verify_abort(&ms->fv);
+	free(ms);
+
+	return ret;
+}
+
 static int mtd_set_fdtargs_basic(void)
 {
 	int ret;
@@ -689,47 +1081,48 @@ static int create_ubi_volume(const char *volume, u64 size, int vol_id,
 	return ret;
 }
 
+static int ubi_verify_read(void *priv, u64 addr, void *buf, size_t size)
+{
+	int ret;
+
+	ret = ubi_volume_read(priv, buf, addr, size);
+	if (ret)
+		return -ret;
+
+	return 0;
+}
+
 static int ubi_verify_volume(const char *volume, const void *data, size_t size)
 {
+	struct flash_verify fv;
 	struct ubi_volume *vol;
 	size_t chksz, offs = 0;
-	int ret = 0;
-	u8 *vbuff;
+	int ret;
 
 	vol = ubi_find_volume((char *)volume);
 	if (!vol)
 		return -ENODEV;
 
-	vbuff = malloc(vol->usable_leb_size);
-	if (!vbuff) {
-		cprintln(ERROR,  "*** Insufficient memory for verifying! ***");
-		return -ENOMEM;
-	}
+	ret = flash_verify_init(&fv, ubi_verify_read, (char *)volume, 0,
+				vol->usable_leb_size);
+	if (ret)
+		return ret;
 
 	while (offs < size) {
 		chksz = size - offs;
 		if (chksz > vol->usable_leb_size)
 			chksz = vol->usable_leb_size;
 
-		ret = ubi_volume_read((char *)volume, vbuff, offs, chksz);
+		ret = flash_verify_add(&fv, offs, data + offs, chksz);
 		if (ret) {
-			printf("Failed to read at 0x%zx, err = %d\n", offs,
-			       ret);
-			goto out;
-		}
-
-		if (!verify_data(data + offs, vbuff, offs, chksz)) {
-			ret = -EBADMSG;
-			goto out;
+			flash_verify_abort(&fv);
+			return ret;
 		}
 
 		offs += chksz;
 	}
 
-out:
-	free(vbuff);
-
-	return ret;
+	return flash_verify_finish(&fv);
 }
 
 int update_ubi_volume_raw(struct ubi_volume *vol, const char *volume,
@@ -881,6 +1274,9 @@ static int mtd_dual_boot_post_upgrade(u32 slot, const char *rootfs_data)
 		dual_boot_set_boot_count(slot, 0);
 	}
 
+	if (IS_ENABLED(CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER))
+		verify_ledger_invalidate(slot);
+
 	if (!IS_ENABLED(CONFIG_MTK_DUAL_BOOT_RESERVE_ROOTFS_DATA)) {
 		/* If we do not reserve rootfs_data, just recreate it */
 		remove_ubi_volume(rootfs_data);
@@ -1023,17 +1419,133 @@ static int ubi_image_read(struct image_read_priv *rpriv, void *buff, u64 addr,
 	return read_ubi_volume(priv->volume, buff, size);
 }
 
+/* Read the volume LEB by LEB, hashing each one right after it is read */
+static int ubi_image_read_hash(struct image_read_priv *rpriv, void *buff,
+			       u64 addr, size_t size,
+			       struct data_hash_ctx *ctx)
+{
+	struct ubi_image_read_priv *priv =
+		container_of(rpriv, struct ubi_image_read_priv, p);
+	struct ubi_volume *vol;
+	int lnum = 0, ret;
+	size_t chksz;
+
+	if (addr) {
+		printf("Reading from non-zero offset within a volume is not allowed.\n");
+		return -ENOTSUPP;
+	}
+
+	vol = ubi_find_volume((char *)priv->volume);
+	if (!vol)
+		return -ENODEV;
+
+	if (vol->updating || vol->upd_marker)
+		return -EBADF;
+
+	if (size > vol->used_bytes)
+		return -EINVAL;
+
+	printf("Reading %zu bytes from volume %s to %p ... ", size,
+	       priv->volume, buff);
+
+	while (size) {
+		chksz = min_t(size_t, size, vol->usable_leb_size);
+
+		ret = ubi_eba_read_leb(vol->ubi, vol, lnum, buff, 0, chksz, 0);
+		if (ret) {
+			printf("Fail\n");
+			return ret;
+		}
+
+		data_hash_update(ctx, buff, chksz);
+
+		buff += chksz;
+		size -= chksz;
+		lnum++;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+
+/*
+ * Fingerprint of the volume from the VID header of each mapped LEB. Any write
+ * of a LEB, including moves by wear-leveling, gives it a new sequence number.
+ */
+static int ubi_volume_fingerprint(const char *volume, u8 *fp)
+{
+	struct ubi_vid_hdr *vid_hdr;
+	struct ubi_volume *vol;
+	sha256_context ctx;
+	int lnum, pnum, ret;
+	struct {
+		__be32 lnum;
+		__be32 pnum;
+		__be64 sqnum;
+		__be32 data_crc;
+	} rec;
+
+	vol = ubi_find_volume((char *)volume);
+	if (!vol)
+		return -ENODEV;
+
+	if (vol->updating || vol->upd_marker)
+		return -EBADF;
+
+	vid_hdr = ubi_zalloc_vid_hdr(vol->ubi, GFP_KERNEL);
+	if (!vid_hdr)
+		return -ENOMEM;
+
+	sha256_starts(&ctx);
+
+	for (lnum = 0; lnum < vol->reserved_pebs; lnum++) {
+		pnum = vol->eba_tbl[lnum];
+		if (pnum < 0)
+			continue;
+
+		ret = ubi_io_read_vid_hdr(vol->ubi, pnum, vid_hdr, 0);
+		if (ret && ret != UBI_IO_BITFLIPS) {
+			ret = -EIO;
+			goto out;
+		}
+
+		if (be32_to_cpu(vid_hdr->vol_id) != vol->vol_id ||
+		    be32_to_cpu(vid_hdr->lnum) != lnum) {
+			ret = -EBADMSG;
+			goto out;
+		}
+
+		rec.lnum = cpu_to_be32(lnum);
+		rec.pnum = cpu_to_be32(pnum);
+		rec.sqnum = vid_hdr->sqnum;
+		rec.data_crc = vid_hdr->data_crc;
+
+		sha256_update(&ctx, (const u8 *)&rec, sizeof(rec));
+	}
+
+	sha256_finish(&ctx, fp);
+	ret = 0;
+
+out:
+	ubi_free_vid_hdr(vol->ubi, vid_hdr);
+
+	return ret;
+}
+
 static int ubi_boot_verify(const struct dual_boot_slot *slot, ulong loadaddr)
 {
 	struct fit_hashes kernel_hashes, rootfs_hashes;
 	struct ubi_image_read_priv read_priv;
 	size_t kernel_size, rootfs_size;
 	void *kernel_data, *rootfs_data;
-	bool ret;
+	u8 fp[VERIFY_LEDGER_FP_LEN];
+	bool ret, fp_valid = false;
 
 	read_priv.p.page_size = 1;
 	read_priv.p.block_size = 0;
 	read_priv.p.read = ubi_image_read;
+	read_priv.p.read_hash = ubi_image_read_hash;
 
 	read_priv.volume = slot->kernel;
 	kernel_data = (void *)loadaddr;
@@ -1061,6 +1573,14 @@ static int ubi_boot_verify(const struct dual_boot_slot *slot, ulong loadaddr)
 	/* Verify rootfs, requiring valid kernel FIT image */
 	read_priv.volume = slot->rootfs;
 	rootfs_data = kernel_data + ALIGN(kernel_size, 4);
+
+	if (IS_ENABLED(CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER)) {
+		fp_valid = !ubi_volume_fingerprint(slot->rootfs, fp);
+		if (fp_valid && verify_ledger_check(slot - dual_boot_slots,
+						    kernel_data, fp))
+			return 0;
+	}
+
 	ret = read_verify_rootfs(&read_priv.p, kernel_data, rootfs_data,
 				 0, 0, &rootfs_size, false, NULL,
 				 &rootfs_hashes);
@@ -1069,6 +1589,9 @@ static int ubi_boot_verify(const struct dual_boot_slot *slot, ulong loadaddr)
 		return -EBADMSG;
 	}
 
+	if (IS_ENABLED(CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER) && fp_valid)
+		verify_ledger_record(slot - dual_boot_slots, kernel_data, fp);
+
 	return 0;
 }
 
@@ -1379,7 +1902,8 @@ static int ubi_check_reserved_volumes(bool require_attach)
 	u64 volsize;
 	int ret = 0;
 
-	if (!rsvd_vols[0])
+	if (!rsvd_vols[0] &&
+	    !IS_ENABLED(CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER))
 		return 0;
 
 	if (require_attach) {
@@ -1414,6 +1938,24 @@ static int ubi_check_reserved_volumes(bool require_attach)
 		}
 	}
 
+	/*
+	 * The ledger is only rewritten in place later, so its volume must be
+	 * reserved before rootfs_data takes all remaining PEBs
+	 */
+	if (IS_ENABLED(CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER)) {
+		vol = ubi_find_volume(VERIFY_LEDGER_NAME);
+		if (!vol) {
+			ret = ubi_create_vol(VERIFY_LEDGER_NAME,
+					     sizeof(struct verify_ledger_data),
+					     false, -1, false);
+			if (ret) {
+				printf("Error: failed to reserve volume for %s\n",
+				       VERIFY_LEDGER_NAME);
+				return ret;
+			}
+		}
+	}
+
 	buf = strdup(rsvd_vols);
 	if (!buf) {
 		printf("Error: no memory for parsing reserved volume list\n");
@@ -1534,6 +2076,38 @@ int ubi_update_bsp_conf(const void *bspconf, uint32_t index)
 	return update_ubi_volume_raw(vol, volname, -1, bspconf, len, len,
 				     false);
 }
+
+int ubi_load_verify_ledger(void *data, size_t size)
+{
+	struct ubi_volume *vol;
+
+	/* The volume is reserved by the next firmware upgrade */
+	vol = ubi_find_volume((char *)VERIFY_LEDGER_NAME);
+	if (!vol)
+		return -ENOTSUPP;
+
+	if (!vol->used_bytes)
+		return -ENOENT;
+
+	return read_ubi_volume(VERIFY_LEDGER_NAME, data, size);
+}
+
+int ubi_save_verify_ledger(const void *data, size_t size)
+{
+	struct ubi_volume *vol;
+	int ret;
+
+	vol = ubi_find_volume((char *)VERIFY_LEDGER_NAME);
+	if (!vol)
+		return -ENOENT;
+
+	ret = ubi_volume_write((char *)VERIFY_LEDGER_NAME, (void *)data, 0,
+			       size);
+	if (ret)
+		return ret;
+
+	return ubi_verify_volume(VERIFY_LEDGER_NAME, data, size);
+}
 #endif /* CONFIG_CMD_UBI */
 
 int mtd_upgrade_image(const void *data, size_t size)
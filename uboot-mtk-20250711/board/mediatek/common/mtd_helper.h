@@ -14,6 +14,8 @@
 #include <linux/types.h>
 #include <linux/mtd/mtd.h>
 
+#include "flash_verify.h"
+
 struct ubi_volume;
 
 int mtd_erase_skip_bad(struct mtd_info *mtd, u64 offset, u64 size,
@@ -25,6 +27,24 @@ int mtd_write_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 int mtd_read_skip_bad(struct mtd_info *mtd, u64 offset, size_t size,
 		      u64 maxsize, size_t *readsize, void *data);
 
+struct mtd_stream {
+	struct mtd_info *mtd;
+	u64 erase_addr;
+	u64 prog_addr;
+	u64 head_addr;
+	u32 erased;
+	u32 programmed;
+	bool verify;
+	struct flash_verify fv;
+};
+
+int mtd_stream_begin(struct mtd_info *mtd, bool verify,
+		     struct mtd_stream **retms);
+int mtd_stream_feed(struct mtd_stream *ms, const void *data, size_t size,
+		    bool last);
+int mtd_stream_finish(struct mtd_stream *ms, const void *data, size_t size,
+		      bool commit);
+
 int mtd_update_generic(struct mtd_info *mtd, const void *data, size_t size,
 		       bool verify);
 int boot_from_mtd(struct mtd_info *mtd, u64 offset, bool do_boot);
@@ -39,6 +59,9 @@ int update_ubi_volume_raw(struct ubi_volume *vol, const char *volume,
 void ubi_import_bsp_conf(void);
 int ubi_update_bsp_conf(const void *bspconf, uint32_t index);
 
+int ubi_load_verify_ledger(void *data, size_t size);
+int ubi_save_verify_ledger(const void *data, size_t size);
+
 int mtd_upgrade_image(const void *data, size_t size);
 int mtd_boot_image(bool do_boot);
 
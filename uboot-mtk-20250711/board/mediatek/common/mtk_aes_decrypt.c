@@ -6,7 +6,11 @@
  */
 
 #ifndef USE_HOSTCC
+#include <cyclic.h>
 #include <linux/arm-smccc.h>
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
 #endif /* ifndef USE_HOSTCC */
 #include <image.h>
 #include <uboot_aes.h>
@@ -16,6 +20,13 @@
 #define MTK_SIP_FW_DEC_SET_IV			0xC2000580
 #define MTK_SIP_FW_DEC_SET_KEY			0xC2000581
 #define MTK_SIP_FW_DEC_IMAGE			0xC2000582
+#define MTK_SIP_FW_DEC_IMAGE_CHUNK		0xC2000584
+#define MTK_SIP_FW_DEC_GET_FEATURES		0xC2000585
+
+#define FW_DEC_CHUNK_SIZE			SZ_1M
+#define FW_DEC_CHUNK_LAST			BIT(0)
+
+#define FW_DEC_FEAT_IMAGE_CHUNK			BIT(0)
 
 #define KERNEL_KEY_IDX				1
 #define ROOTFS_KEY_IDX				2
@@ -39,8 +50,8 @@ static int set_key(uint8_t key_idx)
 	return res.a0;
 }
 
-static int image_decrypt(uint8_t *cipher, size_t cipher_len,
-			 uint8_t *plain, size_t plain_len)
+static int image_decrypt_whole(uint8_t *cipher, size_t cipher_len,
+			       uint8_t *plain, size_t plain_len)
 {
 	struct arm_smccc_res res = { 0 };
 
@@ -50,6 +61,63 @@ static int image_decrypt(uint8_t *cipher, size_t cipher_len,
 	return res.a0;
 }
 
+static unsigned long image_decrypt_chunk(uint8_t *chunk, size_t len,
+					 bool last)
+{
+	struct arm_smccc_res res = { 0 };
+
+	arm_smccc_smc(MTK_SIP_FW_DEC_IMAGE_CHUNK, (uintptr_t)chunk, len,
+		      last ? FW_DEC_CHUNK_LAST : 0, 0, 0, 0, 0, &res);
+
+	return res.a0;
+}
+
+/*
+ * Errors of the decryption calls share values with SMCCC return codes, so
+ * support of optional calls must be queried separately. BL31 without the
+ * query call returns ARM_SMCCC_RET_NOT_SUPPORTED.
+ */
+static unsigned long get_features(void)
+{
+	struct arm_smccc_res res = { 0 };
+
+	arm_smccc_smc(MTK_SIP_FW_DEC_GET_FEATURES, 0, 0, 0, 0, 0, 0, 0, &res);
+
+	if ((long)res.a0 < 0)
+		return 0;
+
+	return res.a0;
+}
+
+/*
+ * Decrypt the image in place in chunks, so that BL31 returns regularly
+ * instead of holding the CPU for the whole image. BL31 without the chunked
+ * call decrypts the image at once.
+ */
+static int image_decrypt(uint8_t *cipher, size_t cipher_len,
+			 uint8_t *plain, size_t plain_len)
+{
+	unsigned long res;
+	size_t off, len;
+
+	if (!(get_features() & FW_DEC_FEAT_IMAGE_CHUNK))
+		return image_decrypt_whole(cipher, cipher_len, plain,
+					   plain_len);
+
+	for (off = 0; off < cipher_len; off += len) {
+		len = min_t(size_t, cipher_len - off, FW_DEC_CHUNK_SIZE);
+
+		res = image_decrypt_chunk(cipher + off, len,
+					  off + len == cipher_len);
+		if (res)
+			return (int)res;
+
+		schedule();
+	}
+
+	return 0;
+}
+
 static int image_decrypt_via_smc(uint8_t key_idx, uint8_t *iv, uint32_t iv_len,
 				 uint8_t *cipher, size_t cipher_len,
 				 uint8_t *plain, size_t plain_len)
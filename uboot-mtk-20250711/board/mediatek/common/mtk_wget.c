@@ -266,6 +266,7 @@ static void wget_rx(struct mtk_wget_pdata *pdata, struct mtk_tcp_cb_data *cbd)
 				return;
 
 			if (ret > 0) {
+				mtk_tcp_conn_print_stats(cbd->conn);
 				mtk_tcp_close_conn(cbd->conn, 0);
 				return;
 			}
@@ -281,6 +282,7 @@ static void wget_rx(struct mtk_wget_pdata *pdata, struct mtk_tcp_cb_data *cbd)
 			return;
 
 		if (ret > 0) {
+			mtk_tcp_conn_print_stats(cbd->conn);
 			mtk_tcp_close_conn(cbd->conn, 0);
 			return;
 		}
@@ -25,6 +25,19 @@ struct data_part_entry;
 typedef int (*data_handler_t)(void *priv, const struct data_part_entry *dpe,
 			      const void *data, size_t size);
 
+/*
+ * Streaming writer used to flash data while it is still being received.
+ * @data always points to the start of the image, and @size is the amount of
+ * data received so far. The buffer must stay valid until finish() is called.
+ * The first block is written by finish() only if @commit is true, so an
+ * interrupted or rejected image never becomes bootable.
+ */
+struct data_stream_ops {
+	int (*begin)(void *priv, const struct data_part_entry *dpe, void **ctx);
+	int (*feed)(void *ctx, const void *data, size_t size, bool last);
+	int (*finish)(void *ctx, const void *data, size_t size, bool commit);
+};
+
 struct data_part_entry {
 	const char *name;
 	const char *abbr;
@@ -35,6 +48,7 @@ struct data_part_entry {
 	data_handler_t validate;
 	data_handler_t write;
 	data_handler_t do_post_action;
+	const struct data_stream_ops *stream;
 };
 
 extern void board_upgrade_data_parts(const struct data_part_entry **dpes,
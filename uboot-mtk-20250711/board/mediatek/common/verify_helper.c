@@ -13,6 +13,7 @@
 #include <linux/sizes.h>
 #include <u-boot/crc.h>
 
+#include "data_hash.h"
 #include "upgrade_helper.h"
 #include "verify_helper.h"
 #include "untar.h"
@@ -169,11 +170,13 @@ static bool verify_kernel_fit(const void *fit,  size_t size,
  * @param noffset: Node offset of rootfs in FIT image
  * @param rootfs: Pointer to rootfs data
  * @param size: Size of rootfs data
+ * @param ctx: digests of rootfs already calculated
  * @param hashes: (optional) stores hashes of rootfs
  * @return zero if passed, negative if failed, positive if not supported
  */
 static int verify_rootfs_hash_fit(const void *fit, int noffset,
 				  const void *rootfs, size_t size,
+				  const struct data_hash_ctx *ctx,
 				  struct fit_hashes *hashes)
 {
 	u8 value[FIT_MAX_HASH_LEN];
@@ -194,7 +197,8 @@ static int verify_rootfs_hash_fit(const void *fit, int noffset,
 
 	printf("%s", algo);
 
-	if (calculate_hash(rootfs, size, algo, value, &value_len)) {
+	if (data_hash_get(ctx, algo, value, &value_len) &&
+	    data_hash_calculate(rootfs, size, algo, value, &value_len)) {
 		debug("Warning: Unsupported hash algorithm '%s'\n", algo);
 		return 1;
 	}
@@ -232,6 +236,59 @@ static int verify_rootfs_hash_fit(const void *fit, int noffset,
 	return 0;
 }
 
+/**
+ * fit_rootfs_hash_algos() - Get algorithms used by the rootfs hash nodes
+ *
+ * @param fit: Pointer to FIT image data
+ * @param rootfs_noffset: Node offset of rootfs in FIT image
+ * @return bitmask of DATA_HASH_*
+ */
+static u32 fit_rootfs_hash_algos(const void *fit, int rootfs_noffset)
+{
+	const char *algo;
+	u32 algos = 0;
+	int noffset;
+
+	fdt_for_each_subnode(noffset, fit, rootfs_noffset) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+
+		if (strncmp(name, FIT_HASH_NODENAME,
+			    strlen(FIT_HASH_NODENAME)))
+			continue;
+
+		if (!fit_image_hash_get_algo(fit, noffset, &algo))
+			algos |= data_hash_algo(algo);
+	}
+
+	return algos;
+}
+
+/**
+ * fit_rootfs_hash_info() - Get what is needed to hash rootfs in one pass
+ *
+ * @param fit: Pointer to FIT image data
+ * @param size: on return stores the rootfs size recorded in FIT
+ * @return bitmask of DATA_HASH_* used by the rootfs hash nodes, 0 if the
+ *	   rootfs node is missing or invalid
+ */
+static u32 fit_rootfs_hash_info(const void *fit, u32 *size)
+{
+	int len, rootfs_noffset;
+	const u32 *cell;
+
+	rootfs_noffset = fdt_path_offset(fit, "/rootfs");
+	if (rootfs_noffset < 0)
+		return 0;
+
+	cell = fdt_getprop(fit, rootfs_noffset, "size", &len);
+	if (!cell || len != sizeof(*cell))
+		return 0;
+
+	*size = fdt32_to_cpu(*cell);
+
+	return fit_rootfs_hash_algos(fit, rootfs_noffset);
+}
+
 /**
  * verify_rootfs_fit() - Verify rootfs associated with the given FIT image
  *
@@ -239,16 +296,23 @@ static int verify_rootfs_hash_fit(const void *fit, int noffset,
  * Verify rootfs associated with the given FIT image. The FIT image must
  * contain rootfs node to make verification pass.
  *
+ * All digests are calculated in a single pass over rootfs, unless @ctx
+ * already holds them.
+ *
  * @param fit: Pointer to FIT image data
  * @param rootfs: Pointer to rootfs data
  * @param rootfs_size: Size of rootfs data
+ * @param ctx: (optional) digests of rootfs calculated while reading it
  * @param hashes: (optional) stores hashes of rootfs
  * @return true if integrity verification passed
  */
 static bool verify_rootfs_fit(const void *fit, const void *rootfs,
-			      size_t rootfs_size, struct fit_hashes *hashes)
+			      size_t rootfs_size,
+			      const struct data_hash_ctx *ctx,
+			      struct fit_hashes *hashes)
 {
 	int ret, len, rootfs_noffset, noffset, failed = 0, passed = 0;
+	struct data_hash_ctx local_ctx;
 	u32 fit_rootfs_size;
 	const u32 *cell;
 
@@ -291,6 +355,15 @@ static bool verify_rootfs_fit(const void *fit, const void *rootfs,
 		return false;
 	}
 
+	if (!ctx || !ctx->finished || ctx->data != rootfs ||
+	    ctx->size != fit_rootfs_size) {
+		data_hash_init(&local_ctx,
+			       fit_rootfs_hash_algos(fit, rootfs_noffset));
+		data_hash_update(&local_ctx, rootfs, fit_rootfs_size);
+		data_hash_finish(&local_ctx, rootfs, fit_rootfs_size);
+		ctx = &local_ctx;
+	}
+
 	printf("   Hash(es) for rootfs: ");
 
 	if (hashes)
@@ -310,7 +383,7 @@ static bool verify_rootfs_fit(const void *fit, const void *rootfs,
 		debug("%s: verifying hash node '%s'\n", __func__, name);
 
 		ret = verify_rootfs_hash_fit(fit, noffset, rootfs,
-					     fit_rootfs_size, hashes);
+					     fit_rootfs_size, ctx, hashes);
 		if (ret) {
 			failed++;
 		} else {
@@ -425,7 +498,7 @@ bool verify_image_ram(const void *data, size_t size, u32 block_size,
 			return true;
 
 		return verify_rootfs_fit(kernel_data, rootfs_data, rootfs_size,
-					 rootfs_hashes);
+					 NULL, rootfs_hashes);
 
 	}
 
@@ -477,7 +550,7 @@ bool verify_image_ram(const void *data, size_t size, u32 block_size,
 
 	return verify_rootfs_fit(data,
 				 data + ii->kernel_size + ii->padding_size,
-				 ii->rootfs_size, rootfs_hashes);
+				 ii->rootfs_size, NULL, rootfs_hashes);
 }
 
 /**
@@ -551,6 +624,55 @@ bool read_verify_kernel(struct image_read_priv *rpriv, void *ptr, u64 addr,
 	}
 }
 
+/**
+ * read_hash_rootfs() - Read rootfs and hash it in the same pass
+ *
+ * @description:
+ * Read rootfs and calculate all digests needed by the FIT image. The data is
+ * hashed right after being read if the flash supports it, or in one pass
+ * after the whole read otherwise.
+ *
+ * @param rpriv: priv structure for flash read operation
+ * @param fit: Pointer to FIT image data
+ * @param ptr: Pointer to memory to where rootfs will be read
+ * @param addr: Address in flash from where rootfs will be read
+ * @param size: Size of rootfs to be read
+ * @param ctx: on return holds the digests of rootfs, if any
+ * @return 0 on success, negative on read failure
+ */
+static int read_hash_rootfs(struct image_read_priv *rpriv, const void *fit,
+			    void *ptr, u64 addr, size_t size,
+			    struct data_hash_ctx *ctx)
+{
+	u32 algos, hash_size = 0;
+	int ret;
+
+	algos = fit_rootfs_hash_info(fit, &hash_size);
+
+	data_hash_init(ctx, algos);
+
+	/* Let verify_rootfs_fit() report what is wrong */
+	if (!algos || !hash_size || hash_size > size)
+		return rpriv->read(rpriv, ptr, addr, size);
+
+	ctx->limit = hash_size;
+
+	if (rpriv->read_hash) {
+		ret = rpriv->read_hash(rpriv, ptr, addr, size, ctx);
+	} else {
+		ret = rpriv->read(rpriv, ptr, addr, size);
+		if (!ret)
+			data_hash_update(ctx, ptr, hash_size);
+	}
+
+	if (ret)
+		return ret;
+
+	data_hash_finish(ctx, ptr, hash_size);
+
+	return 0;
+}
+
 /**
  * read_verify_rootfs() - Read and verify rootfs from flash
  *
@@ -575,6 +697,7 @@ bool read_verify_rootfs(struct image_read_priv *rpriv, const void *fit,
 			struct fit_hashes *hashes)
 {
 	struct squashfs_super_block sb;
+	struct data_hash_ctx ctx;
 	u32 trailing = 0;
 	u64 offset = 0;
 	void *rptr;
@@ -625,7 +748,8 @@ bool read_verify_rootfs(struct image_read_priv *rpriv, const void *fit,
 		}
 
 		/* Read rootfs */
-		ret = rpriv->read(rpriv, rptr, addr + offset, sb.bytes_used);
+		ret = read_hash_rootfs(rpriv, fit, rptr, addr + offset,
+				       sb.bytes_used, &ctx);
 		if (ret) {
 			printf("Error: read failure at offset 0x%llx\n",
 			       addr + offset);
@@ -633,7 +757,7 @@ bool read_verify_rootfs(struct image_read_priv *rpriv, const void *fit,
 		}
 
 		/* Verify rootfs */
-		if (verify_rootfs_fit(fit, rptr, sb.bytes_used, hashes)) {
+		if (verify_rootfs_fit(fit, rptr, sb.bytes_used, &ctx, hashes)) {
 			if (actual_size)
 				*actual_size = sb.bytes_used;
 
@@ -14,6 +14,7 @@
 #include <u-boot/sha1.h>
 #include <u-boot/sha256.h>
 
+#include "data_hash.h"
 #include "image_helper.h"
 
 #define FIT_HASH_CRC32		BIT(0)
@@ -33,6 +34,13 @@ struct image_read_priv {
 
 	int (*read)(struct image_read_priv *priv, void *buff, u64 addr,
 		    size_t size);
+
+	/*
+	 * Optional. Same as read(), also feeding the data to @ctx piece by
+	 * piece right after it has been read.
+	 */
+	int (*read_hash)(struct image_read_priv *priv, void *buff, u64 addr,
+			 size_t size, struct data_hash_ctx *ctx);
 };
 
 bool verify_image_ram(const void *data, size_t size, u32 block_size,
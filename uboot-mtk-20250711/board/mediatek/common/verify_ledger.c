@@ -0,0 +1,326 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Ledger of rootfs verifications of dual boot image slots
+ *
+ * A successful full verification of the rootfs of a slot is recorded with
+ * the digest of the rootfs hashes in the kernel FIT and a fingerprint of the
+ * rootfs storage taken by the caller. Later boots of the same slot may skip
+ * reading and hashing the whole rootfs as long as both still match.
+ *
+ * The ledger is authenticated by HMAC-SHA256. Without a key the ledger is
+ * not used at all.
+ *
+ * The ledger is only written when a verification is recorded or a slot is
+ * upgraded, never on boots which skip the verification.
+ *
+ * With CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_INTERVAL set to N, a full
+ * verification is still forced on a random one in N boots on average. The
+ * decision needs no state kept across boots.
+ */
+
+#include <dm.h>
+#include <errno.h>
+#include <image.h>
+#include <rng.h>
+#include <stdio.h>
+#include <time.h>
+#include <linux/string.h>
+#include <u-boot/crc.h>
+#include <u-boot/sha256.h>
+
+#include "verify_ledger.h"
+
+static struct verify_ledger_data ledger;
+static bool ledger_loaded, ledger_usable;
+
+static const u8 *ledger_key;
+static u32 ledger_key_len;
+
+int __weak board_verify_ledger_key(const u8 **key, u32 *len)
+{
+#ifdef CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_KEY
+	static const char default_key[] = CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_KEY;
+
+	if (default_key[0]) {
+		*key = (const u8 *)default_key;
+		*len = strlen(default_key);
+		return 0;
+	}
+#endif
+
+	return -ENOENT;
+}
+
+int __weak board_load_verify_ledger(void *data, size_t size)
+{
+	return -ENOTSUPP;
+}
+
+int __weak board_save_verify_ledger(const void *data, size_t size)
+{
+	return -ENOTSUPP;
+}
+
+static void verify_ledger_mac(const struct verify_ledger_data *vl, u8 *mac)
+{
+	sha256_hmac(ledger_key, ledger_key_len, (const u8 *)vl,
+		    offsetof(struct verify_ledger_data, mac), mac);
+}
+
+/**
+ * verify_ledger_load() - Load the ledger on first use
+ *
+ * @description:
+ * A ledger which is missing, corrupted or fails authentication is replaced
+ * by an empty one, so that every slot gets a full verification first.
+ *
+ * @return true if the ledger can be used
+ */
+static bool verify_ledger_load(void)
+{
+	u8 mac[SHA256_SUM_LEN];
+	int ret;
+
+	if (ledger_loaded)
+		return ledger_usable;
+
+	ledger_loaded = true;
+
+	if (board_verify_ledger_key(&ledger_key, &ledger_key_len)) {
+		printf("Verification ledger is disabled without a key\n");
+		return false;
+	}
+
+	ret = board_load_verify_ledger(&ledger, sizeof(ledger));
+	if (ret == -ENOTSUPP)
+		return false;
+
+	ledger_usable = true;
+
+	if (!ret && ledger.magic == VERIFY_LEDGER_MAGIC &&
+	    ledger.len == sizeof(ledger) && ledger.ver == VERIFY_LEDGER_VER) {
+		verify_ledger_mac(&ledger, mac);
+		if (!memcmp(mac, ledger.mac, sizeof(mac)))
+			return true;
+
+		printf("Verification ledger failed authentication\n");
+	}
+
+	memset(&ledger, 0, sizeof(ledger));
+
+	return true;
+}
+
+static void verify_ledger_save(void)
+{
+	int ret;
+
+	ledger.magic = VERIFY_LEDGER_MAGIC;
+	ledger.len = sizeof(ledger);
+	ledger.ver = VERIFY_LEDGER_VER;
+
+	verify_ledger_mac(&ledger, ledger.mac);
+
+	ret = board_save_verify_ledger(&ledger, sizeof(ledger));
+	if (ret)
+		printf("Error: failed to update verification ledger\n");
+}
+
+/**
+ * verify_ledger_fit_digest() - Digest rootfs information in kernel FIT
+ *
+ * @param fit: Pointer to FIT image data
+ * @param digest: on return stores the SHA256 digest of rootfs size and all
+ *		  hash algorithms and values of rootfs
+ * @return true if rootfs node has at least one hash
+ */
+static bool verify_ledger_fit_digest(const void *fit, u8 *digest)
+{
+	int len, rootfs_noffset, noffset, value_len, count = 0;
+	sha256_context ctx;
+	const char *algo;
+	const u32 *cell;
+	u8 *value;
+
+	rootfs_noffset = fdt_path_offset(fit, "/rootfs");
+	if (rootfs_noffset < 0)
+		return false;
+
+	cell = fdt_getprop(fit, rootfs_noffset, "size", &len);
+	if (!cell || len != sizeof(*cell))
+		return false;
+
+	sha256_starts(&ctx);
+	sha256_update(&ctx, (const u8 *)cell, sizeof(*cell));
+
+	fdt_for_each_subnode(noffset, fit, rootfs_noffset) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+
+		if (strncmp(name, FIT_HASH_NODENAME,
+			    strlen(FIT_HASH_NODENAME)))
+			continue;
+
+		if (fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    fit_image_hash_get_value(fit, noffset, &value, &value_len))
+			continue;
+
+		sha256_update(&ctx, (const u8 *)algo, strlen(algo) + 1);
+		sha256_update(&ctx, value, value_len);
+		count++;
+	}
+
+	sha256_finish(&ctx, digest);
+
+	return count > 0;
+}
+
+/**
+ * verify_ledger_random_due() - Decide randomly whether a full verification
+ *				is due on this boot
+ *
+ * @description:
+ * The hardware RNG is used if there is one. Otherwise the low bits of the
+ * timer, which vary with flash timing between boots, are mixed by CRC32.
+ *
+ * @return true with a chance of 1/CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_INTERVAL
+ */
+static bool verify_ledger_random_due(void)
+{
+	u32 interval = 0, randv = 0;
+	struct udevice *dev;
+	u64 ticks;
+
+	/* Avoid compilation error */
+#ifdef CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_INTERVAL
+	interval = CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_INTERVAL;
+#endif
+
+	if (!interval)
+		return false;
+
+	if (CONFIG_IS_ENABLED(DM_RNG) &&
+	    !uclass_get_device(UCLASS_RNG, 0, &dev)) {
+		if (dm_rng_read(dev, &randv, sizeof(randv)) < 0)
+			randv = 0;
+	}
+
+	if (!randv) {
+		ticks = get_ticks();
+		randv = crc32(0, (const u8 *)&ticks, sizeof(ticks));
+	}
+
+	return !(randv % interval);
+}
+
+/**
+ * verify_ledger_check() - Check whether full rootfs verification can be
+ *			   skipped
+ *
+ * @description:
+ * Verification is skipped only if the last full verification of the slot
+ * was done for the same rootfs hashes in FIT and the same storage
+ * fingerprint.
+ *
+ * A slot retried by dual boot is always fully verified. Its previous boot
+ * did not finish, which may be caused by a corrupted rootfs. Besides, one
+ * in CONFIG_MTK_DUAL_BOOT_VERIFY_LEDGER_INTERVAL boots is fully verified
+ * at random, to catch corruption which leaves the fingerprint unchanged.
+ * Neither needs the ledger to be written on every boot.
+ *
+ * @param slot: image slot
+ * @param fit: Pointer to the verified kernel FIT image
+ * @param fp: current fingerprint of rootfs storage
+ * @return true if full verification can be skipped
+ */
+bool verify_ledger_check(u32 slot, const void *fit, const u8 *fp)
+{
+	struct verify_ledger_entry *ent;
+	u8 digest[SHA256_SUM_LEN];
+	u32 bc_slot, bootcount;
+
+	if (slot >= DUAL_BOOT_MAX_SLOTS || !verify_ledger_load())
+		return false;
+
+	ent = &ledger.slot[slot];
+
+	if (!(ent->flags & VERIFY_LEDGER_ENTRY_VALID))
+		return false;
+
+	if (!verify_ledger_fit_digest(fit, digest) ||
+	    memcmp(digest, ent->fit_digest, sizeof(digest))) {
+		printf("Rootfs hashes changed since last verification\n");
+		return false;
+	}
+
+	if (memcmp(fp, ent->fp, sizeof(ent->fp))) {
+		printf("Rootfs has been written since last verification\n");
+		return false;
+	}
+
+	/* Boot count is set to 1 by dual_boot() for the first attempt */
+	if (IS_ENABLED(CONFIG_MTK_DUAL_BOOT_ENABLE_RETRY) &&
+	    dual_boot_get_boot_count(&bc_slot, &bootcount) &&
+	    bc_slot == slot && bootcount > 1) {
+		printf("Rootfs full verification is due for retried slot\n");
+		return false;
+	}
+
+	if (verify_ledger_random_due()) {
+		printf("Rootfs full verification is due\n");
+		return false;
+	}
+
+	printf("Rootfs unchanged since its last full verification\n");
+
+	return true;
+}
+
+/**
+ * verify_ledger_record() - Record a successful full rootfs verification
+ *
+ * @param slot: image slot
+ * @param fit: Pointer to the verified kernel FIT image
+ * @param fp: fingerprint of rootfs storage taken before verification
+ */
+void verify_ledger_record(u32 slot, const void *fit, const u8 *fp)
+{
+	struct verify_ledger_entry ent = {};
+
+	if (slot >= DUAL_BOOT_MAX_SLOTS || !verify_ledger_load())
+		return;
+
+	if (!verify_ledger_fit_digest(fit, ent.fit_digest))
+		return;
+
+	ent.flags = VERIFY_LEDGER_ENTRY_VALID;
+	memcpy(ent.fp, fp, sizeof(ent.fp));
+
+	if (!memcmp(&ent, &ledger.slot[slot], sizeof(ent)))
+		return;
+
+	memcpy(&ledger.slot[slot], &ent, sizeof(ent));
+	verify_ledger_save();
+}
+
+/**
+ * verify_ledger_invalidate() - Forget the verification of a slot
+ *
+ * @description:
+ * Called after the slot has been written, forcing a full verification on
+ * its next boot.
+ *
+ * @param slot: image slot
+ */
+void verify_ledger_invalidate(u32 slot)
+{
+	if (slot >= DUAL_BOOT_MAX_SLOTS || !verify_ledger_load())
+		return;
+
+	if (!(ledger.slot[slot].flags & VERIFY_LEDGER_ENTRY_VALID))
+		return;
+
+	memset(&ledger.slot[slot], 0, sizeof(ledger.slot[slot]));
+	verify_ledger_save();
+}
@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Ledger of rootfs verifications of dual boot image slots
+ */
+
+#ifndef _VERIFY_LEDGER_H_
+#define _VERIFY_LEDGER_H_
+
+#include <linux/bitops.h>
+#include <linux/types.h>
+#include <u-boot/sha256.h>
+
+#include "dual_boot.h"
+
+#define VERIFY_LEDGER_NAME		"bspledger"
+
+#define VERIFY_LEDGER_MAGIC		0x4c56424d	/* "MBVL" */
+#define VERIFY_LEDGER_VER		1
+
+/* Length of the fingerprint of rootfs storage */
+#define VERIFY_LEDGER_FP_LEN		SHA256_SUM_LEN
+
+#define VERIFY_LEDGER_ENTRY_VALID	BIT(0)
+
+struct verify_ledger_entry {
+	u32 flags;
+
+	/* Digest of rootfs size and hashes recorded in the kernel FIT */
+	u8 fit_digest[SHA256_SUM_LEN];
+
+	/* Fingerprint of the storage of rootfs when it was verified */
+	u8 fp[VERIFY_LEDGER_FP_LEN];
+};
+
+struct verify_ledger_data {
+	u32 magic;
+	u32 len;
+	u32 ver;
+	u32 reserved;
+
+	struct verify_ledger_entry slot[DUAL_BOOT_MAX_SLOTS];
+
+	/* HMAC-SHA256 of all fields above */
+	u8 mac[SHA256_SUM_LEN];
+};
+
+/* Board hooks, the key is required for using the ledger */
+int board_verify_ledger_key(const u8 **key, u32 *len);
+int board_load_verify_ledger(void *data, size_t size);
+int board_save_verify_ledger(const void *data, size_t size);
+
+bool verify_ledger_check(u32 slot, const void *fit, const u8 *fp);
+void verify_ledger_record(u32 slot, const void *fit, const u8 *fp);
+void verify_ledger_invalidate(u32 slot);
+
+#endif /* _VERIFY_LEDGER_H_ */
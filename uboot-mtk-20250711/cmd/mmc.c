@@ -15,11 +15,29 @@
 #include <part.h>
 #include <sparse_format.h>
 #include <image-sparse.h>
+#include <time.h>
 #include <vsprintf.h>
 #include <linux/ctype.h>
+#include <linux/math64.h>
 
 static int curr_device = -1;
 
+static void print_mmc_xfer_result(struct mmc *mmc, u32 n, u32 cnt,
+				  const char *what, ulong elapsed)
+{
+	u64 bytes = (u64)n * mmc_get_blk_desc(mmc)->blksz;
+
+	printf("%d blocks %s: %s", n, what, (n == cnt) ? "OK" : "ERROR");
+
+	if (n != cnt || !elapsed) {
+		printf("\n");
+		return;
+	}
+
+	printf(" (%lu ms, ", elapsed);
+	print_size(div_u64(bytes * 1000, elapsed), "/s)\n");
+}
+
 static void print_mmcinfo(struct mmc *mmc)
 {
 	int i;
@@ -352,6 +370,7 @@ static int do_mmc_read(struct cmd_tbl *cmdtp, int flag,
 {
 	struct mmc *mmc;
 	u32 blk, cnt, n;
+	ulong start;
 	void *ptr;
 
 	if (argc != 4)
@@ -368,8 +387,9 @@ static int do_mmc_read(struct cmd_tbl *cmdtp, int flag,
 	printf("MMC read: dev # %d, block # %d, count %d ... ",
 	       curr_device, blk, cnt);
 
+	start = get_timer(0);
 	n = blk_dread(mmc_get_blk_desc(mmc), blk, cnt, ptr);
-	printf("%d blocks read: %s\n", n, (n == cnt) ? "OK" : "ERROR");
+	print_mmc_xfer_result(mmc, n, cnt, "read", get_timer(start));
 	unmap_sysmem(ptr);
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
@@ -446,6 +466,7 @@ static int do_mmc_write(struct cmd_tbl *cmdtp, int flag,
 {
 	struct mmc *mmc;
 	u32 blk, cnt, n;
+	ulong start;
 	void *ptr;
 
 	if (argc != 4)
@@ -466,8 +487,9 @@ static int do_mmc_write(struct cmd_tbl *cmdtp, int flag,
 		printf("Error: card is write protected!\n");
 		return CMD_RET_FAILURE;
 	}
+	start = get_timer(0);
 	n = blk_dwrite(mmc_get_blk_desc(mmc), blk, cnt, ptr);
-	printf("%d blocks written: %s\n", n, (n == cnt) ? "OK" : "ERROR");
+	print_mmc_xfer_result(mmc, n, cnt, "written", get_timer(start));
 	unmap_sysmem(ptr);
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
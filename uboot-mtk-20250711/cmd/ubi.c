@@ -73,6 +73,12 @@ static void display_ubi_info(struct ubi_device *ubi)
 	ubi_msg("number of PEBs reserved for bad PEB handling: %d",
 			ubi->beb_rsvd_pebs);
 	ubi_msg("max/mean erase counter: %d/%d", ubi->max_ec, ubi->mean_ec);
+	ubi_msg("attach time: %lu ms (I/O %lu ms, CPU %lu ms)",
+		ubi->attach_stats.total_us / 1000,
+		ubi->attach_stats.io_us / 1000,
+		(ubi->attach_stats.total_us - ubi->attach_stats.io_us) / 1000);
+	ubi_msg("header pages read in batch: %u in %u batches",
+		ubi->attach_stats.hdr_pages, ubi->attach_stats.batches);
 }
 
 static int ubi_info(int layout)
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * MediaTek SD/MMC Card Interface DMA descriptor helpers
+ *
+ * Copyright (C) 2025 MediaTek Inc.
+ *
+ * These helpers only build descriptors and compute register values. They do
+ * not touch the controller, so that the same code can be exercised by the
+ * sandbox unit tests.
+ */
+
+#include <errno.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include "mtk-sd-dma.h"
+
+/* Keep the BD table on its own cache line(s), apart from the GPDs */
+#define MSDC_DESC_ALIGN			64
+
+#define MSDC_GPD_AREA_SIZE	\
+	ALIGN(2 * sizeof(struct msdc_gpd), MSDC_DESC_ALIGN)
+
+u8 msdc_dma_checksum(const void *buf, u32 len)
+{
+	const u8 *p = buf;
+	u8 sum = 0;
+	u32 i;
+
+	for (i = 0; i < len; i++)
+		sum += p[i];
+
+	return 0xff - sum;
+}
+
+bool msdc_dma_capable(u64 addr, u32 size, u32 align)
+{
+	if (!size)
+		return false;
+
+	if ((addr % align) || (size % align))
+		return false;
+
+	return addr + size <= MSDC_DMA_ADDR_LIMIT;
+}
+
+u32 msdc_dma_desc_size(u32 max_bd)
+{
+	return MSDC_GPD_AREA_SIZE + max_bd * sizeof(struct msdc_bd);
+}
+
+void msdc_dma_init_desc(struct msdc_dma *dma, void *desc, u64 desc_addr,
+			u32 max_bd)
+{
+	struct msdc_gpd *gpd;
+	u64 next;
+	u32 i;
+
+	memset(desc, 0, msdc_dma_desc_size(max_bd));
+
+	dma->gpd = desc;
+	dma->bd = desc + MSDC_GPD_AREA_SIZE;
+	dma->gpd_addr = desc_addr;
+	dma->bd_addr = desc_addr + MSDC_GPD_AREA_SIZE;
+	dma->max_bd = max_bd;
+
+	/* gpd[0] points to the BD table and is chained to the null gpd[1] */
+	gpd = &dma->gpd[0];
+	next = dma->gpd_addr + sizeof(struct msdc_gpd);
+
+	gpd->gpd_info = GPDMA_DESC_BDP;
+	gpd->gpd_info |= (upper_32_bits(next) << GPDMA_DESC_NEXT_H4_S) &
+			 GPDMA_DESC_NEXT_H4_M;
+	gpd->gpd_info |= (upper_32_bits(dma->bd_addr) << GPDMA_DESC_PTR_H4_S) &
+			 GPDMA_DESC_PTR_H4_M;
+	gpd->next = lower_32_bits(next);
+	gpd->ptr = lower_32_bits(dma->bd_addr);
+
+	for (i = 0; i + 1 < max_bd; i++) {
+		next = dma->bd_addr + (i + 1) * sizeof(struct msdc_bd);
+
+		dma->bd[i].next = lower_32_bits(next);
+		dma->bd[i].bd_info = (upper_32_bits(next) <<
+				      BDMA_DESC_NEXT_H4_S) &
+				     BDMA_DESC_NEXT_H4_M;
+	}
+}
+
+int msdc_dma_build_desc(struct msdc_dma *dma, u64 addr, u32 size,
+			struct msdc_dma_regs *regs)
+{
+	struct msdc_gpd *gpd = &dma->gpd[0];
+	struct msdc_bd *bd;
+	u32 nbd, chksz, i;
+
+	if (!size || addr + size > MSDC_DMA_ADDR_LIMIT)
+		return -EINVAL;
+
+	nbd = DIV_ROUND_UP(size, MSDC_BD_MAX_LEN);
+	if (nbd > dma->max_bd)
+		return -E2BIG;
+
+	for (i = 0; i < nbd; i++) {
+		bd = &dma->bd[i];
+		chksz = min(size, (u32)MSDC_BD_MAX_LEN);
+
+		bd->bd_info &= ~(BDMA_DESC_EOL | BDMA_DESC_CHECKSUM_M |
+				 BDMA_DESC_BLKPAD | BDMA_DESC_DWPAD |
+				 BDMA_DESC_PTR_H4_M);
+		bd->bd_info |= (upper_32_bits(addr) << BDMA_DESC_PTR_H4_S) &
+			       BDMA_DESC_PTR_H4_M;
+		bd->ptr = lower_32_bits(addr);
+		bd->bd_data_len = chksz & BDMA_DESC_BUFLEN_M;
+
+		if (i == nbd - 1)
+			bd->bd_info |= BDMA_DESC_EOL;
+
+		bd->bd_info |= msdc_dma_checksum(bd, MSDC_DESC_CHECKSUM_LEN) <<
+			       BDMA_DESC_CHECKSUM_S;
+
+		addr += chksz;
+		size -= chksz;
+	}
+
+	/* Hand the GPD over to the hardware */
+	gpd->gpd_info |= GPDMA_DESC_HWO;
+	gpd->gpd_info &= ~GPDMA_DESC_CHECKSUM_M;
+	gpd->gpd_info |= msdc_dma_checksum(gpd, MSDC_DESC_CHECKSUM_LEN) <<
+			 GPDMA_DESC_CHECKSUM_S;
+
+	regs->sa_high4bit = upper_32_bits(dma->gpd_addr) &
+			    MSDC_DMA_ADDR_HIGH4BIT_M;
+	regs->sa = lower_32_bits(dma->gpd_addr);
+	regs->ctrl = MSDC_DMA_CTRL_MODE |
+		     (MSDC_BURST_64B << MSDC_DMA_CTRL_BURSTSZ_S);
+	regs->cfg = MSDC_DMA_CFG_DECSEN;
+	regs->length = 0;
+
+	return 0;
+}
+
+int msdc_dma_build_basic(u64 addr, u32 size, struct msdc_dma_regs *regs)
+{
+	if (!size || size > MSDC_DMA_BASIC_MAX_LEN ||
+	    addr + size > MSDC_DMA_ADDR_LIMIT)
+		return -EINVAL;
+
+	regs->sa_high4bit = upper_32_bits(addr) & MSDC_DMA_ADDR_HIGH4BIT_M;
+	regs->sa = lower_32_bits(addr);
+	regs->ctrl = MSDC_DMA_CTRL_LASTBUF |
+		     (MSDC_BURST_64B << MSDC_DMA_CTRL_BURSTSZ_S);
+	regs->cfg = 0;
+	regs->length = size;
+
+	return 0;
+}
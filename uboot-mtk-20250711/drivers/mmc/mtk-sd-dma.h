@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * MediaTek SD/MMC Card Interface DMA descriptor helpers
+ *
+ * Copyright (C) 2025 MediaTek Inc.
+ */
+
+#ifndef _MTK_SD_DMA_H_
+#define _MTK_SD_DMA_H_
+
+#include <linux/bitops.h>
+#include <linux/types.h>
+
+/* MSDC_DMA_CTRL */
+#define MSDC_DMA_CTRL_START		BIT(0)
+#define MSDC_DMA_CTRL_STOP		BIT(1)
+#define MSDC_DMA_CTRL_RESUME		BIT(2)
+#define MSDC_DMA_CTRL_MODE		BIT(8)
+#define MSDC_DMA_CTRL_LASTBUF		BIT(10)
+#define MSDC_DMA_CTRL_BURSTSZ_M		0x7000
+#define MSDC_DMA_CTRL_BURSTSZ_S		12
+
+/* MSDC_DMA_CFG */
+#define MSDC_DMA_CFG_STS		BIT(0)
+#define MSDC_DMA_CFG_DECSEN		BIT(1)
+
+/* DMA_SA_HIGH4BIT */
+#define MSDC_DMA_ADDR_HIGH4BIT_M	0xf
+
+#define MSDC_BURST_64B			6
+
+/* General Purpose Descriptor */
+#define GPDMA_DESC_HWO			BIT(0)
+#define GPDMA_DESC_BDP			BIT(1)
+#define GPDMA_DESC_CHECKSUM_M		0xff00
+#define GPDMA_DESC_CHECKSUM_S		8
+#define GPDMA_DESC_INT			BIT(16)
+#define GPDMA_DESC_NEXT_H4_M		0xf000000
+#define GPDMA_DESC_NEXT_H4_S		24
+#define GPDMA_DESC_PTR_H4_M		0xf0000000
+#define GPDMA_DESC_PTR_H4_S		28
+
+/* Buffer Descriptor */
+#define BDMA_DESC_EOL			BIT(0)
+#define BDMA_DESC_CHECKSUM_M		0xff00
+#define BDMA_DESC_CHECKSUM_S		8
+#define BDMA_DESC_BLKPAD		BIT(17)
+#define BDMA_DESC_DWPAD			BIT(18)
+#define BDMA_DESC_NEXT_H4_M		0xf000000
+#define BDMA_DESC_NEXT_H4_S		24
+#define BDMA_DESC_PTR_H4_M		0xf0000000
+#define BDMA_DESC_PTR_H4_S		28
+#define BDMA_DESC_BUFLEN_M		0xffff
+
+/* Bytes covered by the checksum of both descriptor types */
+#define MSDC_DESC_CHECKSUM_LEN		16
+
+/* Largest block-aligned length a single BD can carry */
+#define MSDC_BD_MAX_LEN			0xf000
+
+/* Highest bus address reachable through the 4 extra address bits */
+#define MSDC_DMA_ADDR_LIMIT		(1ULL << 36)
+
+/* Basic DMA takes the whole length in the 32-bit DMA_LENGTH register */
+#define MSDC_DMA_BASIC_MAX_LEN		0xffffff00U
+
+struct msdc_gpd {
+	u32 gpd_info;
+	u32 next;
+	u32 ptr;
+	u32 gpd_data_len;
+	u32 arg;
+	u32 blknum;
+	u32 cmd;
+};
+
+struct msdc_bd {
+	u32 bd_info;
+	u32 next;
+	u32 ptr;
+	u32 bd_data_len;
+};
+
+/*
+ * Descriptor memory of one host: gpd[0] is the active descriptor and
+ * gpd[1] the null descriptor terminating the chain, bd[] holds the buffer
+ * descriptors the transfer is split into.
+ */
+struct msdc_dma {
+	struct msdc_gpd *gpd;
+	struct msdc_bd *bd;
+	u64 gpd_addr;
+	u64 bd_addr;
+	u32 max_bd;
+};
+
+/* Register values to be programmed for one DMA transfer */
+struct msdc_dma_regs {
+	u32 sa_high4bit;
+	u32 sa;
+	u32 ctrl;
+	u32 cfg;
+	u32 length;
+};
+
+u8 msdc_dma_checksum(const void *buf, u32 len);
+bool msdc_dma_capable(u64 addr, u32 size, u32 align);
+u32 msdc_dma_desc_size(u32 max_bd);
+void msdc_dma_init_desc(struct msdc_dma *dma, void *desc, u64 desc_addr,
+			u32 max_bd);
+int msdc_dma_build_desc(struct msdc_dma *dma, u64 addr, u32 size,
+			struct msdc_dma_regs *regs);
+int msdc_dma_build_basic(u64 addr, u32 size, struct msdc_dma_regs *regs);
+
+#endif /* _MTK_SD_DMA_H_ */
@@ -7,12 +7,14 @@
  */
 
 #include <clk.h>
+#include <cpu_func.h>
 #include <dm.h>
 #include <mmc.h>
 #include <errno.h>
 #include <malloc.h>
 #include <mapmem.h>
 #include <stdbool.h>
+#include <asm/cache.h>
 #include <asm/gpio.h>
 #include <dm/device_compat.h>
 #include <dm/pinctrl.h>
@@ -20,6 +22,7 @@
 #include <linux/io.h>
 #include <linux/iopoll.h>
 #include <linux/printk.h>
+#include "mtk-sd-dma.h"
 
 /* MSDC_CFG */
 #define MSDC_CFG_HS400_CK_MODE_EXT	BIT(22)
@@ -234,6 +237,12 @@
 
 #define MIN_BUS_CLK			260000
 
+/*
+ * Software limit for a DMA data phase, assuming at least 1MiB/s. The data
+ * timeout of the controller is expected to fire well before this.
+ */
+#define MSDC_DMA_TIMEOUT_US(size)	(1000000 + (size))
+
 #define CMD_INTS_MASK	\
 	(MSDC_INT_CMDRDY | MSDC_INT_RSPCRCERR | MSDC_INT_CMDTMO)
 
@@ -350,6 +359,12 @@ struct msdc_plat {
 	struct mmc mmc;
 };
 
+enum msdc_dma_mode {
+	MSDC_MODE_PIO,
+	MSDC_MODE_DMA_BASIC,
+	MSDC_MODE_DMA_DESC,
+};
+
 struct msdc_tune_para {
 	u32 iocon;
 	u32 pad_tune;
@@ -404,6 +419,16 @@ struct msdc_host {
 
 	struct msdc_tune_para def_tune_para;
 	struct msdc_tune_para saved_tune_para;
+
+	/* DMA transfer */
+	enum msdc_dma_mode dma_mode;
+	struct msdc_dma dma;
+	void *dma_desc;
+	u32 dma_desc_size;
+
+	bool dma_xfer;		/* current data phase is done by DMA */
+	ulong dma_buf;
+	u32 dma_size;
 };
 
 static void msdc_reset_hw(struct msdc_host *host)
@@ -579,6 +604,85 @@ static bool msdc_cmd_is_ready(struct msdc_host *host)
 	return true;
 }
 
+static void msdc_dma_prepare(struct msdc_host *host, struct mmc_data *data)
+{
+	struct msdc_dma_regs regs;
+	ulong buf;
+	u64 addr;
+	u32 size;
+	int ret;
+
+	host->dma_xfer = false;
+
+	if (host->dma_mode == MSDC_MODE_PIO)
+		goto use_pio;
+
+	if (data->flags == MMC_DATA_WRITE)
+		buf = (ulong)data->src;
+	else
+		buf = (ulong)data->dest;
+
+	size = data->blocks * data->blocksize;
+	addr = virt_to_phys((void *)buf);
+
+	/*
+	 * The buffer must occupy whole cache lines. Otherwise invalidating it
+	 * would discard data sharing its first or last cache line.
+	 */
+	if (!msdc_dma_capable(addr, size, ARCH_DMA_MINALIGN))
+		goto use_pio;
+
+	if (host->dma_mode == MSDC_MODE_DMA_DESC)
+		ret = msdc_dma_build_desc(&host->dma, addr, size, &regs);
+	else
+		ret = msdc_dma_build_basic(addr, size, &regs);
+
+	if (ret)
+		goto use_pio;
+
+	if (host->dma_mode == MSDC_MODE_DMA_DESC)
+		flush_dcache_range((ulong)host->dma_desc,
+				   (ulong)host->dma_desc + host->dma_desc_size);
+
+	if (data->flags == MMC_DATA_WRITE)
+		flush_dcache_range(buf, buf + size);
+	else
+		invalidate_dcache_range(buf, buf + size);
+
+	writel(regs.sa_high4bit, &host->base->dma_sa_high4bit);
+	writel(regs.sa, &host->base->dma_sa);
+	if (host->dma_mode == MSDC_MODE_DMA_BASIC)
+		writel(regs.length, &host->base->dma_length);
+
+	clrsetbits_le32(&host->base->dma_cfg, MSDC_DMA_CFG_DECSEN, regs.cfg);
+	clrsetbits_le32(&host->base->dma_ctrl,
+			MSDC_DMA_CTRL_MODE | MSDC_DMA_CTRL_LASTBUF |
+			MSDC_DMA_CTRL_BURSTSZ_M, regs.ctrl);
+
+	clrbits_le32(&host->base->msdc_cfg, MSDC_CFG_PIO);
+
+	host->dma_xfer = true;
+	host->dma_buf = buf;
+	host->dma_size = size;
+
+	return;
+
+use_pio:
+	setbits_le32(&host->base->msdc_cfg, MSDC_CFG_PIO);
+}
+
+static void msdc_dma_stop(struct msdc_host *host)
+{
+	u32 reg;
+
+	setbits_le32(&host->base->dma_ctrl, MSDC_DMA_CTRL_STOP);
+
+	readl_poll_timeout(&host->base->dma_ctrl, reg,
+			   !(reg & MSDC_DMA_CTRL_STOP), 1000000);
+	readl_poll_timeout(&host->base->dma_cfg, reg,
+			   !(reg & MSDC_DMA_CFG_STS), 1000000);
+}
+
 static int msdc_start_command(struct msdc_host *host, struct mmc_cmd *cmd,
 			      struct mmc_data *data)
 {
@@ -605,8 +709,10 @@ static int msdc_start_command(struct msdc_host *host, struct mmc_cmd *cmd,
 
 	rawcmd = msdc_cmd_prepare_raw_cmd(host, cmd, data);
 
-	if (data)
+	if (data) {
 		blocks = data->blocks;
+		msdc_dma_prepare(host, data);
+	}
 
 	writel(CMD_INTS_MASK, &host->base->msdc_int);
 	writel(DATA_INTS_MASK, &host->base->msdc_int);
@@ -751,6 +857,35 @@ static int msdc_pio_write(struct msdc_host *host, const u8 *ptr, u32 size)
 	return ret;
 }
 
+static int msdc_dma_xfer(struct msdc_host *host, struct mmc_data *data)
+{
+	u32 status;
+	int ret;
+
+	setbits_le32(&host->base->dma_ctrl, MSDC_DMA_CTRL_START);
+
+	ret = readl_poll_timeout(&host->base->msdc_int, status,
+				 status & DATA_INTS_MASK,
+				 MSDC_DMA_TIMEOUT_US(host->dma_size));
+	writel(status & DATA_INTS_MASK, &host->base->msdc_int);
+
+	if (ret || (status & MSDC_INT_DATTMO))
+		ret = -ETIMEDOUT;
+	else if (status & MSDC_INT_DATCRCERR)
+		ret = -EIO;
+
+	msdc_dma_stop(host);
+
+	/* Drop lines speculatively fetched while the transfer was running */
+	if (data->flags != MMC_DATA_WRITE)
+		invalidate_dcache_range(host->dma_buf,
+					host->dma_buf + host->dma_size);
+
+	host->dma_xfer = false;
+
+	return ret;
+}
+
 static int msdc_start_data(struct msdc_host *host, struct mmc_data *data)
 {
 	u32 size;
@@ -761,7 +896,9 @@ static int msdc_start_data(struct msdc_host *host, struct mmc_data *data)
 
 	size = data->blocks * data->blocksize;
 
-	if (data->flags == MMC_DATA_WRITE)
+	if (host->dma_xfer)
+		ret = msdc_dma_xfer(host, data);
+	else if (data->flags == MMC_DATA_WRITE)
 		ret = msdc_pio_write(host, (const u8 *)data->src, size);
 	else
 		ret = msdc_pio_read(host, (u8 *)data->dest, size);
@@ -787,6 +924,7 @@ static int msdc_ops_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 	    cmd->cmdidx == MMC_CMD_SEND_TUNING_BLOCK_HS200))) {
 		dev_dbg(dev, "MSDC start command failure with %d, cmd=%d, arg=0x%x\n",
 			cmd_ret, cmd->cmdidx, cmd->cmdarg);
+		host->dma_xfer = false;
 		return cmd_ret;
 	}
 
@@ -1485,7 +1623,7 @@ static void msdc_init_hw(struct msdc_host *host)
 	/* Configure to MMC/SD mode, clock free running */
 	setbits_le32(&host->base->msdc_cfg, MSDC_CFG_MODE);
 
-	/* Use PIO mode */
+	/* Use PIO mode until a data transfer selects DMA */
 	setbits_le32(&host->base->msdc_cfg, MSDC_CFG_PIO);
 
 	/* Reset */
@@ -1659,6 +1797,33 @@ static void msdc_ungate_clock(struct msdc_host *host)
 		clk_enable(&host->ahb_cg_clk);
 }
 
+static void msdc_dma_init(struct udevice *dev, struct msdc_host *host,
+			  u32 b_max)
+{
+	u32 max_bd;
+
+	host->dma_mode = MSDC_MODE_PIO;
+
+	if (!IS_ENABLED(CONFIG_MMC_MTK_DMA))
+		return;
+
+	max_bd = DIV_ROUND_UP(b_max * MMC_MAX_BLOCK_LEN, MSDC_BD_MAX_LEN);
+	host->dma_desc_size = ALIGN(msdc_dma_desc_size(max_bd),
+				    ARCH_DMA_MINALIGN);
+
+	host->dma_desc = memalign(ARCH_DMA_MINALIGN, host->dma_desc_size);
+	if (!host->dma_desc) {
+		dev_warn(dev, "No memory for DMA descriptors, using basic DMA\n");
+		host->dma_mode = MSDC_MODE_DMA_BASIC;
+		return;
+	}
+
+	msdc_dma_init_desc(&host->dma, host->dma_desc,
+			   virt_to_phys(host->dma_desc), max_bd);
+
+	host->dma_mode = MSDC_MODE_DMA_DESC;
+}
+
 static int msdc_drv_probe(struct udevice *dev)
 {
 	struct mmc_uclass_priv *upriv = dev_get_uclass_priv(dev);
@@ -1697,6 +1862,8 @@ static int msdc_drv_probe(struct udevice *dev)
 	pinctrl_select_state(dev, "default");
 #endif
 
+	msdc_dma_init(dev, host, cfg->b_max);
+
 	msdc_ungate_clock(host);
 	msdc_init_hw(host);
 
@@ -1007,6 +1007,68 @@ int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 }
 EXPORT_SYMBOL_GPL(mtd_read);
 
+/**
+ * mtd_read_pages - read the main data of a list of pages
+ * @mtd: MTD device
+ * @offs: page-aligned offsets of the pages, in any order
+ * @count: number of pages
+ * @buf: buffer of @count pages
+ * @stat: result of each page, with the same meaning as the return value of
+ *	  mtd_read()
+ *
+ * Drivers providing ->_read_pages() may pipeline the reads, e.g. load the
+ * next page from the array while the current one is being transferred.
+ * Others read the pages one by one. Drivers report the number of bitflips
+ * of each page in @stat, which is converted here.
+ *
+ * Return: 0 if @stat has been filled, or a negative error code if the
+ * arguments are invalid.
+ */
+int mtd_read_pages(struct mtd_info *mtd, const loff_t *offs,
+		   unsigned int count, u_char *buf, int *stat)
+{
+	unsigned int i;
+	size_t retlen;
+	int ret;
+
+	for (i = 0; i < count; i++) {
+		if (offs[i] < 0 || mtd_mod_by_ws(offs[i], mtd) ||
+		    offs[i] > mtd->size - mtd->writesize)
+			return -EINVAL;
+	}
+
+	if (mtd->_read_pages) {
+		ret = mtd->_read_pages(mtd, offs, count, buf, stat);
+		if (!ret) {
+			for (i = 0; i < count; i++) {
+				if (stat[i] < 0)
+					continue;
+
+				if (mtd->ecc_strength &&
+				    stat[i] >= mtd->bitflip_threshold)
+					stat[i] = -EUCLEAN;
+				else
+					stat[i] = 0;
+			}
+
+			return 0;
+		}
+	}
+
+	/* Pages are read again one by one if the batch failed as a whole */
+	for (i = 0; i < count; i++) {
+		ret = mtd_read(mtd, offs[i], mtd->writesize, &retlen,
+			       buf + (size_t)i * mtd->writesize);
+		if (ret >= 0 && retlen != mtd->writesize)
+			ret = -EIO;
+
+		stat[i] = ret;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(mtd_read_pages);
+
 int mtd_write(struct mtd_info *mtd, loff_t to, size_t len, size_t *retlen,
 	      const u_char *buf)
 {
@@ -307,6 +307,40 @@ static int part_read(struct mtd_info *mtd, loff_t from, size_t len,
 	return res;
 }
 
+static int part_read_pages(struct mtd_info *mtd, const loff_t *offs,
+			   unsigned int count, u_char *buf, int *stat)
+{
+	loff_t poffs[32];
+	unsigned int i, n;
+	int res;
+
+	while (count) {
+		n = min_t(unsigned int, count, ARRAY_SIZE(poffs));
+
+		for (i = 0; i < n; i++)
+			poffs[i] = offs[i] + mtd->offset;
+
+		res = mtd->parent->_read_pages(mtd->parent, poffs, n, buf,
+					       stat);
+		if (res)
+			return res;
+
+		for (i = 0; i < n; i++) {
+			if (mtd_is_eccerr(stat[i]))
+				mtd->ecc_stats.failed++;
+			else if (stat[i] > 0)
+				mtd->ecc_stats.corrected += stat[i];
+		}
+
+		offs += n;
+		stat += n;
+		buf += (size_t)n * mtd->writesize;
+		count -= n;
+	}
+
+	return 0;
+}
+
 #ifndef __UBOOT__
 static int part_point(struct mtd_info *mtd, loff_t from, size_t len,
 		size_t *retlen, void **virt, resource_size_t *phys)
@@ -600,6 +634,8 @@ static struct mtd_info *allocate_partition(struct mtd_info *master,
 
 	if (master->_read)
 		slave->_read = part_read;
+	if (master->_read_pages)
+		slave->_read_pages = part_read_pages;
 	if (master->_write)
 		slave->_write = part_write;
 
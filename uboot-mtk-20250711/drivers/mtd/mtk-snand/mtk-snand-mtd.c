@@ -8,6 +8,7 @@
 #include <dm.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <memalign.h>
 #include <linux/mtd/mtd.h>
 #include <watchdog.h>
 
@@ -81,6 +82,38 @@ static int mtk_snand_mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 	return ret;
 }
 
+/* Whole pages read by one batch, which ends at a block boundary */
+static size_t mtk_snand_mtd_batch_len(struct mtd_info *mtd, uint64_t addr,
+				      size_t len)
+{
+	size_t chklen;
+
+	chklen = mtd->erasesize - (addr & mtd->erasesize_mask);
+	if (chklen > len)
+		chklen = len & ~(size_t)mtd->writesize_mask;
+
+	return chklen;
+}
+
+static int mtk_snand_mtd_read_pages(struct mtk_snand_mtd *msm, uint64_t addr,
+				    uint8_t *buf, size_t len, bool raw)
+{
+	struct mtd_info *mtd = dev_get_uclass_priv(msm->dev);
+	struct mtk_snand_read_stats stats = { 0 };
+	size_t chklen;
+	int ret;
+
+	chklen = mtk_snand_mtd_batch_len(mtd, addr, len);
+
+	ret = mtk_snand_read_pages(msm->snf, addr, buf,
+				   chklen >> mtd->writesize_shift, raw, &stats);
+
+	mtd->ecc_stats.corrected += stats.corrected;
+	mtd->ecc_stats.failed += stats.failed;
+
+	return ret;
+}
+
 static int mtk_snand_mtd_read_data(struct mtk_snand_mtd *msm, uint64_t addr,
 				   struct mtd_oob_ops *ops)
 {
@@ -107,6 +140,26 @@ static int mtk_snand_mtd_read_data(struct mtk_snand_mtd *msm, uint64_t addr,
 	while (len || ooblen) {
 		schedule();
 
+		/* Whole pages without oob are read in batches */
+		if (!ooblen && !col && len >= 2 * mtd->writesize) {
+			ret = mtk_snand_mtd_read_pages(msm, addr,
+						       ops->datbuf + ops->retlen,
+						       len, raw);
+			if (ret < 0 && ret != -EBADMSG)
+				return ret;
+
+			if (ret == -EBADMSG)
+				ecc_failed = true;
+			else
+				max_bitflips = max_t(int, ret, max_bitflips);
+
+			chklen = mtk_snand_mtd_batch_len(mtd, addr, len);
+			len -= chklen;
+			ops->retlen += chklen;
+			addr += chklen;
+			continue;
+		}
+
 		if (ops->mode == MTD_OPS_AUTO_OOB)
 			ret = mtk_snand_read_page_auto_oob(msm->snf, addr,
 				datcache, oobcache, maxooblen, NULL, raw);
@@ -160,6 +213,40 @@ static int mtk_snand_mtd_read_data(struct mtk_snand_mtd *msm, uint64_t addr,
 	return ecc_failed ? -EBADMSG : max_bitflips;
 }
 
+static int mtk_snand_mtd_read_page_list(struct mtd_info *mtd, const loff_t *offs,
+					unsigned int count, u_char *buf, int *stat)
+{
+	struct mtk_snand_mtd *msm = mtd_to_msm(mtd);
+	struct mtk_snand_read_stats stats = { 0 };
+	uint64_t addrs[MTK_SNAND_PAGE_LIST_BATCH];
+	unsigned int i, n;
+	int ret = 0;
+
+	while (count) {
+		schedule();
+
+		n = min_t(unsigned int, count, MTK_SNAND_PAGE_LIST_BATCH);
+
+		for (i = 0; i < n; i++)
+			addrs[i] = offs[i];
+
+		ret = mtk_snand_read_page_list(msm->snf, addrs, n, buf, false,
+					       stat, &stats);
+		if (ret)
+			break;
+
+		offs += n;
+		stat += n;
+		buf += (size_t)n << mtd->writesize_shift;
+		count -= n;
+	}
+
+	mtd->ecc_stats.corrected += stats.corrected;
+	mtd->ecc_stats.failed += stats.failed;
+
+	return ret;
+}
+
 static int mtk_snand_mtd_read_oob(struct mtd_info *mtd, loff_t from,
 				  struct mtd_oob_ops *ops)
 {
@@ -445,7 +532,8 @@ static int mtk_snand_mtd_probe(struct udevice *dev)
 
 	mtk_snand_get_chip_info(msm->snf, &msm->cinfo);
 
-	msm->page_cache = malloc(msm->cinfo.pagesize + msm->cinfo.sparesize);
+	msm->page_cache = malloc_cache_aligned(msm->cinfo.pagesize +
+					       msm->cinfo.sparesize);
 	if (!msm->page_cache) {
 		printf("%s: failed to allocate memory for page cache\n",
 		       __func__);
@@ -486,6 +574,7 @@ static int mtk_snand_mtd_probe(struct udevice *dev)
 	mtd->ecc_step_size = msm->cinfo.sector_size;
 
 	mtd->_read = mtk_snand_mtd_read;
+	mtd->_read_pages = mtk_snand_mtd_read_page_list;
 	mtd->_write = mtk_snand_mtd_write;
 	mtd->_erase = mtk_snand_mtd_erase;
 	mtd->_read_oob = mtk_snand_mtd_read_oob;
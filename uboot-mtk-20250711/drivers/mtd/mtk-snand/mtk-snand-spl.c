@@ -9,6 +9,7 @@
 #include <dm/uclass.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <memalign.h>
 #include <mtd.h>
 #include <watchdog.h>
 
@@ -230,7 +231,7 @@ void nand_init(void)
 #ifdef CONFIG_ENABLE_NAND_NMBM
 	nmbm_init();
 #else
-	page_cache = malloc(cinfo.pagesize + cinfo.sparesize);
+	page_cache = malloc_cache_aligned(cinfo.pagesize + cinfo.sparesize);
 	if (!page_cache) {
 		mtk_snand_cleanup(snf);
 		printf("mtk-snand-spl: failed to allocate page cache\n");
@@ -44,6 +44,14 @@ struct mtk_snand_chip_info {
 	uint32_t ecc_bytes;
 };
 
+struct mtk_snand_read_stats {
+	uint32_t corrected;	/* Bitflips corrected */
+	uint32_t failed;	/* Pages with uncorrectable bitflips */
+};
+
+/* Max pages of one cache read sequence of mtk_snand_read_page_list() */
+#define MTK_SNAND_PAGE_LIST_BATCH	32
+
 struct mtk_snand;
 struct snand_flash_info;
 
@@ -54,6 +62,12 @@ int mtk_snand_cleanup(struct mtk_snand *snf);
 int mtk_snand_chip_reset(struct mtk_snand *snf);
 int mtk_snand_read_page(struct mtk_snand *snf, uint64_t addr, void *buf,
 			void *oob, bool raw);
+int mtk_snand_read_pages(struct mtk_snand *snf, uint64_t addr, void *buf,
+			 uint32_t count, bool raw,
+			 struct mtk_snand_read_stats *stats);
+int mtk_snand_read_page_list(struct mtk_snand *snf, const uint64_t *addrs,
+			     uint32_t count, void *buf, bool raw, int *stat,
+			     struct mtk_snand_read_stats *stats);
 int mtk_snand_write_page(struct mtk_snand *snf, uint64_t addr, const void *buf,
 			 const void *oob, bool raw);
 int mtk_snand_erase_block(struct mtk_snand *snf, uint64_t addr);
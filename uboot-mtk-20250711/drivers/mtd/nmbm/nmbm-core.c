@@ -2591,6 +2591,69 @@ static int nmbm_read_logic_page(struct nmbm_instance *ni, uint64_t addr,
 	return nmbm_read_phys_page(ni, paddr, data, oob, mode);
 }
 
+/*
+ * nmbm_read_logic_pages - Read consecutive pages based on logic address
+ * @ni: NMBM instance structure
+ * @addr: logic linear address, page aligned
+ * @data: buffer to store main data
+ * @count: number of pages, all within the block of @addr
+ * @mode: read mode
+ *
+ * The pages are read by one read_pages() call of the lower device if it
+ * provides one. On failure they are read again one by one with retries.
+ *
+ * Return 0 for success, positive value for corrected bitflip count,
+ * -EBADMSG for ecc error, other negative values for other errors
+ */
+static int nmbm_read_logic_pages(struct nmbm_instance *ni, uint64_t addr,
+				 void *data, uint32_t count,
+				 enum nmbm_oob_mode mode)
+{
+	uint32_t lb, pb, offset, i;
+	uint8_t *ptr = data;
+	bool has_ecc_err = false;
+	int ret, max_bitflips = 0;
+	uint64_t paddr;
+
+	lb = addr2ba(ni, addr);
+	offset = addr & ni->erasesize_mask;
+
+	pb = ni->block_mapping[lb];
+
+	if ((int32_t)pb < 0) {
+		nlog_debug(ni, "Logic block %u is a bad block\n", lb);
+		return -EIO;
+	}
+
+	if (nmbm_get_block_state(ni, pb) == BLOCK_ST_BAD)
+		return -EIO;
+
+	paddr = ba2addr(ni, pb) + offset;
+
+	if (ni->lower.read_pages) {
+		ret = ni->lower.read_pages(ni->lower.arg, paddr, data, count,
+					   mode);
+		if (ret >= 0)
+			return ret;
+	}
+
+	for (i = 0; i < count; i++) {
+		ret = nmbm_read_phys_page(ni, paddr, ptr, NULL, mode);
+		if (ret < 0 && ret != -EBADMSG)
+			return ret;
+
+		if (ret == -EBADMSG)
+			has_ecc_err = true;
+		else if (ret > max_bitflips)
+			max_bitflips = ret;
+
+		paddr += ni->lower.writesize;
+		ptr += ni->lower.writesize;
+	}
+
+	return has_ecc_err ? -EBADMSG : max_bitflips;
+}
+
 /*
  * nmbm_read_single_page - Read one page based on logic address
  * @ni: NMBM instance structure
@@ -2622,6 +2685,92 @@ int nmbm_read_single_page(struct nmbm_instance *ni, uint64_t addr, void *data,
 	return nmbm_read_logic_page(ni, addr, data, oob, mode);
 }
 
+/*
+ * nmbm_read_page_list - Read main data of a list of pages
+ * @ni: NMBM instance structure
+ * @addrs: page aligned logic linear addresses, in any order
+ * @count: number of pages
+ * @data: buffer to store main data of @count pages
+ * @stat: result of each page, same as nmbm_read_single_page()
+ * @mode: read mode
+ *
+ * Pages are mapped to physical pages and passed to read_page_list() of the
+ * lower device in batches. Pages failed in a batch, and all pages if the
+ * lower device does not support this, are read one by one with retries.
+ *
+ * Return 0 if @stat has been filled, negative value otherwise
+ */
+int nmbm_read_page_list(struct nmbm_instance *ni, const uint64_t *addrs,
+			uint32_t count, void *data, int *stat,
+			enum nmbm_oob_mode mode)
+{
+	uint64_t paddrs[NMBM_PAGE_LIST_BATCH];
+	uint8_t *ptr = data;
+	uint32_t i, n, lb, pb;
+	bool batched;
+
+	if (!ni)
+		return -EINVAL;
+
+	/* Sanity check */
+	if (ni->protected) {
+		nlog_debug(ni, "Device is forced read-only\n");
+		return -EROFS;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (addrs[i] >= ba2addr(ni, ni->data_block_count) ||
+		    (addrs[i] & ni->writesize_mask)) {
+			nlog_err(ni, "Address 0x%llx is invalid\n", addrs[i]);
+			return -EINVAL;
+		}
+	}
+
+	while (count) {
+		WATCHDOG_RESET();
+
+		n = count;
+		if (n > NMBM_PAGE_LIST_BATCH)
+			n = NMBM_PAGE_LIST_BATCH;
+
+		batched = false;
+
+		if (ni->lower.read_page_list) {
+			for (i = 0; i < n; i++) {
+				lb = addr2ba(ni, addrs[i]);
+				pb = ni->block_mapping[lb];
+
+				/* Bad blocks are handled by the fallback */
+				if ((int32_t)pb < 0 ||
+				    nmbm_get_block_state(ni, pb) == BLOCK_ST_BAD)
+					break;
+
+				paddrs[i] = ba2addr(ni, pb) +
+					    (addrs[i] & ni->erasesize_mask);
+			}
+
+			if (i == n)
+				batched = !ni->lower.read_page_list(
+					ni->lower.arg, paddrs, n, ptr, stat,
+					mode);
+		}
+
+		for (i = 0; i < n; i++) {
+			if (!batched || stat[i] < 0)
+				stat[i] = nmbm_read_logic_page(ni, addrs[i],
+					ptr + (size_t)i * ni->lower.writesize,
+					NULL, mode);
+		}
+
+		addrs += n;
+		stat += n;
+		ptr += (size_t)n * ni->lower.writesize;
+		count -= n;
+	}
+
+	return 0;
+}
+
 /*
  * nmbm_read_range - Read data without oob
  * @ni: NMBM instance structure
@@ -2677,7 +2826,18 @@ int nmbm_read_range(struct nmbm_instance *ni, uint64_t addr, size_t size,
 		if (chunksize > sizeremain)
 			chunksize = sizeremain;
 
-		if (chunksize == ni->lower.writesize) {
+		if (!leading && sizeremain >= 2 * ni->lower.writesize) {
+			/* Whole pages up to the end of the block */
+			chunksize = ni->lower.erasesize -
+				    (off & ni->erasesize_mask);
+			if (chunksize > sizeremain)
+				chunksize = sizeremain & ~(size_t)ni->writesize_mask;
+
+			ret = nmbm_read_logic_pages(ni, off, ptr,
+				chunksize >> ni->writesize_shift, mode);
+			if (ret < 0 && ret != -EBADMSG)
+				break;
+		} else if (chunksize == ni->lower.writesize) {
 			ret = nmbm_read_logic_page(ni, off - leading, ptr,
 							NULL, mode);
 			if (ret < 0 && ret != -EBADMSG)
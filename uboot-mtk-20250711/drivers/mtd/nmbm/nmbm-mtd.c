@@ -94,6 +94,93 @@ static int nmbm_lower_read_page(void *arg, uint64_t addr, void *buf, void *oob,
 	return 0;
 }
 
+static int nmbm_lower_read_pages(void *arg, uint64_t addr, void *buf,
+				 uint32_t count, enum nmbm_oob_mode mode)
+{
+	struct nmbm_mtd *nm = arg;
+	struct mtd_oob_ops ops;
+	int ret;
+
+	memset(&ops, 0, sizeof(ops));
+
+	switch (mode) {
+	case NMBM_MODE_PLACE_OOB:
+		ops.mode = MTD_OPS_PLACE_OOB;
+		break;
+	case NMBM_MODE_AUTO_OOB:
+		ops.mode = MTD_OPS_AUTO_OOB;
+		break;
+	case NMBM_MODE_RAW:
+		ops.mode = MTD_OPS_RAW;
+		break;
+	default:
+		pr_debug("%s: unsupported NMBM mode: %u\n", __func__, mode);
+		return -ENOTSUPP;
+	}
+
+	ops.datbuf = buf;
+	ops.len = (size_t)count * nm->lower->writesize;
+
+	ret = mtd_read_oob(nm->lower, addr, &ops);
+	nm->upper.ecc_stats.corrected = nm->lower->ecc_stats.corrected;
+	nm->upper.ecc_stats.failed = nm->lower->ecc_stats.failed;
+
+	/* Same as nmbm_lower_read_page() */
+	if (ret < 0 && ret != -EUCLEAN)
+		return ret;
+
+	if (ret == -EUCLEAN) {
+		return min_t(u32, nm->lower->bitflip_threshold + 1,
+			     nm->lower->ecc_strength);
+	}
+
+	return 0;
+}
+
+static int nmbm_lower_read_page_list(void *arg, const uint64_t *addrs,
+				     uint32_t count, void *buf, int *stat,
+				     enum nmbm_oob_mode mode)
+{
+	struct nmbm_mtd *nm = arg;
+	loff_t offs[NMBM_PAGE_LIST_BATCH];
+	uint8_t *ptr = buf;
+	uint32_t i, n;
+	int ret;
+
+	/* Only pages with ECC can be read in batch */
+	if (mode == NMBM_MODE_RAW)
+		return -ENOTSUPP;
+
+	while (count) {
+		n = min_t(uint32_t, count, ARRAY_SIZE(offs));
+
+		for (i = 0; i < n; i++)
+			offs[i] = addrs[i];
+
+		ret = mtd_read_pages(nm->lower, offs, n, ptr, stat);
+		if (ret)
+			return ret;
+
+		/* Same as nmbm_lower_read_page() */
+		for (i = 0; i < n; i++) {
+			if (stat[i] == -EUCLEAN)
+				stat[i] = min_t(u32,
+						nm->lower->bitflip_threshold + 1,
+						nm->lower->ecc_strength);
+		}
+
+		addrs += n;
+		stat += n;
+		ptr += (size_t)n * nm->lower->writesize;
+		count -= n;
+	}
+
+	nm->upper.ecc_stats.corrected = nm->lower->ecc_stats.corrected;
+	nm->upper.ecc_stats.failed = nm->lower->ecc_stats.failed;
+
+	return 0;
+}
+
 static int nmbm_lower_write_page(void *arg, uint64_t addr, const void *buf,
 				 const void *oob, enum nmbm_oob_mode mode)
 {
@@ -180,6 +267,34 @@ static int nmbm_mtd_read(struct mtd_info *mtd, loff_t from, size_t len,
 			       retlen);
 }
 
+static int nmbm_mtd_read_pages(struct mtd_info *mtd, const loff_t *offs,
+			       unsigned int count, u_char *buf, int *stat)
+{
+	struct nmbm_mtd *nm = container_of(mtd, struct nmbm_mtd, upper);
+	uint64_t addrs[NMBM_PAGE_LIST_BATCH];
+	unsigned int i, n;
+	int ret;
+
+	while (count) {
+		n = min_t(unsigned int, count, ARRAY_SIZE(addrs));
+
+		for (i = 0; i < n; i++)
+			addrs[i] = offs[i];
+
+		ret = nmbm_read_page_list(nm->ni, addrs, n, buf, stat,
+					  NMBM_MODE_PLACE_OOB);
+		if (ret)
+			return ret;
+
+		offs += n;
+		stat += n;
+		buf += (size_t)n * mtd->writesize;
+		count -= n;
+	}
+
+	return 0;
+}
+
 static int nmbm_mtd_write(struct mtd_info *mtd, loff_t to, size_t len,
 			  size_t *retlen, const u_char *buf)
 {
@@ -542,6 +657,9 @@ int nmbm_attach_mtd(struct mtd_info *lower, int flags, uint32_t max_ratio,
 
 	nld.arg = nm;
 	nld.read_page = nmbm_lower_read_page;
+	nld.read_pages = nmbm_lower_read_pages;
+	if (lower->_read_pages)
+		nld.read_page_list = nmbm_lower_read_page_list;
 	nld.write_page = nmbm_lower_write_page;
 	nld.erase_block = nmbm_lower_erase_block;
 	nld.is_bad_block = nmbm_lower_is_bad_block;
@@ -597,6 +715,7 @@ int nmbm_attach_mtd(struct mtd_info *lower, int flags, uint32_t max_ratio,
 	mtd->eraseregions = lower->eraseregions;
 
 	mtd->_read = nmbm_mtd_read;
+	mtd->_read_pages = nmbm_mtd_read_pages;
 	mtd->_write = nmbm_mtd_write;
 	mtd->_erase = nmbm_mtd_erase;
 	mtd->_read_oob = nmbm_mtd_read_oob;
@@ -43,6 +43,8 @@ typedef uint32_t				nmbm_bitmap_t;
 
 #define NMBM_TRY_COUNT				3
 
+#define NMBM_PAGE_LIST_BATCH			32
+
 #define BLOCK_ST_BAD				0
 #define BLOCK_ST_NEED_REMAP			2
 #define BLOCK_ST_GOOD				3
@@ -82,6 +82,7 @@
 #include <linux/bug.h>
 #include <linux/err.h>
 #include <linux/printk.h>
+#include <time.h>
 #endif
 
 #include <linux/math64.h>
@@ -1266,6 +1267,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
+		ubi_io_prefetch_hdrs(ubi, pnum, ubi->peb_count);
 		err = scan_peb(ubi, ai, pnum, NULL, NULL);
 		if (err < 0)
 			goto out_vidh;
@@ -1377,6 +1379,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
+		ubi_io_prefetch_hdrs(ubi, pnum, UBI_FM_MAX_START);
 		err = scan_peb(ubi, *ai, pnum, &vol_id, &sqnum);
 		if (err < 0)
 			goto out_vidh;
@@ -1410,15 +1413,7 @@ out:
 
 #endif
 
-/**
- * ubi_attach - attach an MTD device.
- * @ubi: UBI device descriptor
- * @force_scan: if set to non-zero attach by scanning
- *
- * This function returns zero in case of success and a negative error code in
- * case of failure.
- */
-int ubi_attach(struct ubi_device *ubi, int force_scan)
+static int do_attach(struct ubi_device *ubi, int force_scan)
 {
 	int err;
 	struct ubi_attach_info *ai;
@@ -1513,6 +1508,33 @@ out_ai:
 	return err;
 }
 
+/**
+ * ubi_attach - attach an MTD device.
+ * @ubi: UBI device descriptor
+ * @force_scan: if set to non-zero attach by scanning
+ *
+ * The time spent in attaching is recorded in @ubi->attach_stats.
+ *
+ * This function returns zero in case of success and a negative error code in
+ * case of failure.
+ */
+int ubi_attach(struct ubi_device *ubi, int force_scan)
+{
+	unsigned long start = timer_get_us();
+	int err;
+
+	err = ubi_io_prefetch_init(ubi);
+	if (err)
+		return err;
+
+	err = do_attach(ubi, force_scan);
+
+	ubi_io_prefetch_exit(ubi);
+	ubi->attach_stats.total_us = timer_get_us() - start;
+
+	return err;
+}
+
 /**
  * self_check_ai - check the attaching information.
  * @ubi: UBI device description object
@@ -28,6 +28,9 @@
 #include <u-boot/crc.h>
 #endif
 #include <linux/types.h>
+#ifdef CONFIG_ARM64_CRC32
+#include <u-boot/crc.h>
+#endif
 
 #include <asm/byteorder.h>
 
@@ -61,7 +64,16 @@ MODULE_LICENSE("GPL");
  */
 u32  crc32_le(u32 crc, unsigned char const *p, size_t len);
 
-#if CRC_LE_BITS == 1
+#ifdef CONFIG_ARM64_CRC32
+/*
+ * Same convention as crc32_no_comp(), which uses the ARMv8 CRC32
+ * instructions instead of a table.
+ */
+u32 crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	return crc32_no_comp(crc, p, len);
+}
+#elif CRC_LE_BITS == 1
 /*
  * In fact, the table-based code will work in this case, but it can be
  * simplified by inlining the table in ?: form.
@@ -82,6 +82,7 @@
 #include <u-boot/crc.h>
 #else
 #include <hexdump.h>
+#include <time.h>
 #include <ubi_uboot.h>
 #endif
 
@@ -97,6 +98,73 @@ static int self_check_vid_hdr(const struct ubi_device *ubi, int pnum,
 static int self_check_write(struct ubi_device *ubi, const void *buf, int pnum,
 			    int offset, int len);
 
+static bool in_prefetch_window(const struct ubi_hdr_prefetch *pf, int pnum)
+{
+	return pf && pf->count && pnum >= pf->first &&
+	       pnum < pf->first + pf->count;
+}
+
+static void drop_prefetch_window(const struct ubi_device *ubi)
+{
+	if (ubi->hdr_pf)
+		ubi->hdr_pf->count = 0;
+}
+
+/**
+ * read_prefetched - read data from the header pages read ahead.
+ * @ubi: UBI device description object
+ * @buf: buffer where to store the read data
+ * @pnum: physical eraseblock number to read from
+ * @offset: offset within the physical eraseblock from where to read
+ * @len: how many bytes to read
+ *
+ * This function returns %-ENODATA if the data is not within one page read
+ * ahead, or if reading that page failed, in which case the data has to be
+ * read from the flash. Otherwise the return codes are the same as
+ * 'ubi_io_read()'.
+ */
+static int read_prefetched(const struct ubi_device *ubi, void *buf, int pnum,
+			   int offset, int len)
+{
+	const struct ubi_hdr_prefetch *pf = ubi->hdr_pf;
+	int i, first, page_offset, writesize = ubi->mtd->writesize;
+
+	if (!in_prefetch_window(pf, pnum))
+		return -ENODATA;
+
+	first = pf->page[pnum - pf->first];
+	if (first < 0)
+		return -ENODATA;
+
+	for (i = first; i < first + pf->pages; i++) {
+		page_offset = pf->offs[i] - (loff_t)pnum * ubi->peb_size;
+		if (offset < page_offset ||
+		    offset + len > page_offset + writesize)
+			continue;
+
+		if (pf->stat[i] && !mtd_is_bitflip(pf->stat[i]))
+			return -ENODATA;
+
+		memcpy(buf, pf->buf + (size_t)i * writesize + offset -
+		       page_offset, len);
+
+		if (mtd_is_bitflip(pf->stat[i])) {
+			ubi_msg(ubi, "fixable bit-flip detected at PEB %d",
+				pnum);
+			return UBI_IO_BITFLIPS;
+		}
+
+		if (ubi_dbg_is_bitflip(ubi)) {
+			dbg_gen("bit-flip (emulated)");
+			return UBI_IO_BITFLIPS;
+		}
+
+		return 0;
+	}
+
+	return -ENODATA;
+}
+
 /**
  * ubi_io_read - read data from a physical eraseblock.
  * @ubi: UBI device description object
@@ -123,6 +191,7 @@ int ubi_io_read(const struct ubi_device *ubi, void *buf, int pnum, int offset,
 		int len)
 {
 	int err, retries = 0;
+	unsigned long start;
 	size_t read;
 	loff_t addr;
 
@@ -136,6 +205,10 @@ int ubi_io_read(const struct ubi_device *ubi, void *buf, int pnum, int offset,
 	if (err)
 		return err;
 
+	err = read_prefetched(ubi, buf, pnum, offset, len);
+	if (err != -ENODATA)
+		return err;
+
 	/*
 	 * Deliberately corrupt the buffer to improve robustness. Indeed, if we
 	 * do not do this, the following may happen:
@@ -160,7 +233,10 @@ int ubi_io_read(const struct ubi_device *ubi, void *buf, int pnum, int offset,
 
 	addr = (loff_t)pnum * ubi->peb_size + offset;
 retry:
+	start = timer_get_us();
 	err = mtd_read(ubi->mtd, addr, len, &read, buf);
+	if (ubi->hdr_pf)
+		ubi->hdr_pf->stats.io_us += timer_get_us() - start;
 	if (err) {
 		const char *errstr = mtd_is_eccerr(err) ? " (ECC error)" : "";
 
@@ -242,6 +318,8 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 	ubi_assert(offset % ubi->hdrs_min_io_size == 0);
 	ubi_assert(len > 0 && len % ubi->hdrs_min_io_size == 0);
 
+	drop_prefetch_window(ubi);
+
 	if (ubi->ro_mode) {
 		ubi_err(ubi, "read-only mode");
 		return -EROFS;
@@ -322,6 +400,8 @@ static int do_sync_erase(struct ubi_device *ubi, int pnum)
 	dbg_io("erase PEB %d", pnum);
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
 
+	drop_prefetch_window(ubi);
+
 	if (ubi->ro_mode) {
 		ubi_err(ubi, "read-only mode");
 		return -EROFS;
@@ -603,6 +683,9 @@ int ubi_io_is_bad(const struct ubi_device *ubi, int pnum)
 
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
 
+	if (in_prefetch_window(ubi->hdr_pf, pnum))
+		return ubi->hdr_pf->bad[pnum - ubi->hdr_pf->first];
+
 	if (ubi->bad_allowed) {
 		int ret;
 
@@ -633,6 +716,8 @@ int ubi_io_mark_bad(const struct ubi_device *ubi, int pnum)
 
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
 
+	drop_prefetch_window(ubi);
+
 	if (ubi->ro_mode) {
 		ubi_err(ubi, "read-only mode");
 		return -EROFS;
@@ -647,6 +732,120 @@ int ubi_io_mark_bad(const struct ubi_device *ubi, int pnum)
 	return err;
 }
 
+/**
+ * ubi_io_prefetch_init - prepare reading headers ahead while attaching.
+ * @ubi: UBI device description object
+ *
+ * Headers are read ahead only if the MTD device supports reading pages in
+ * batch, and if both EC and VID headers can be read from whole pages.
+ * Otherwise only the attaching statistics are collected.
+ *
+ * This function returns zero in case of success and %-ENOMEM in case of
+ * failure.
+ */
+int ubi_io_prefetch_init(struct ubi_device *ubi)
+{
+	struct ubi_hdr_prefetch *pf;
+	struct mtd_info *mtd = ubi->mtd;
+
+	pf = kzalloc(sizeof(*pf), GFP_KERNEL);
+	if (!pf)
+		return -ENOMEM;
+
+	pf->vid_page = ubi->vid_hdr_aloffset -
+		       ubi->vid_hdr_aloffset % mtd->writesize;
+	pf->pages = pf->vid_page ? 2 : 1;
+
+	if (mtd->_read_pages && pf->vid_page + mtd->writesize >=
+	    ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize) {
+		pf->buf = vmalloc((size_t)UBI_PREFETCH_PEBS * pf->pages *
+				  mtd->writesize);
+		if (!pf->buf)
+			ubi_warn(ubi, "no memory for reading headers in batch");
+	}
+
+	ubi->hdr_pf = pf;
+
+	return 0;
+}
+
+/**
+ * ubi_io_prefetch_exit - stop reading headers ahead.
+ * @ubi: UBI device description object
+ *
+ * The statistics collected are saved in @ubi->attach_stats.
+ */
+void ubi_io_prefetch_exit(struct ubi_device *ubi)
+{
+	struct ubi_hdr_prefetch *pf = ubi->hdr_pf;
+
+	if (!pf)
+		return;
+
+	ubi->attach_stats = pf->stats;
+	ubi->hdr_pf = NULL;
+
+	vfree(pf->buf);
+	kfree(pf);
+}
+
+/**
+ * ubi_io_prefetch_hdrs - read headers of PEBs ahead.
+ * @ubi: UBI device description object
+ * @pnum: the physical eraseblock number going to be scanned
+ * @end: the physical eraseblock number where scanning stops
+ *
+ * Unless @pnum is already in the window, this function reads the EC and VID
+ * header pages of up to %UBI_PREFETCH_PEBS good PEBs starting from @pnum by
+ * one 'mtd_read_pages()' call. Failures are not fatal, the headers are then
+ * read from the flash one by one as usual.
+ */
+void ubi_io_prefetch_hdrs(struct ubi_device *ubi, int pnum, int end)
+{
+	struct ubi_hdr_prefetch *pf = ubi->hdr_pf;
+	int i, err, n = 0;
+	unsigned long start;
+	loff_t addr;
+
+	if (!pf || !pf->buf || in_prefetch_window(pf, pnum))
+		return;
+
+	pf->count = 0;
+	pf->first = pnum;
+
+	for (i = 0; i < UBI_PREFETCH_PEBS && pnum + i < end; i++) {
+		err = ubi_io_is_bad(ubi, pnum + i);
+		if (err < 0)
+			break;
+
+		pf->bad[i] = err;
+		pf->page[i] = -1;
+
+		if (err)
+			continue;
+
+		addr = (loff_t)(pnum + i) * ubi->peb_size;
+
+		pf->page[i] = n;
+		pf->offs[n++] = addr;
+		if (pf->pages > 1)
+			pf->offs[n++] = addr + pf->vid_page;
+	}
+
+	if (n) {
+		start = timer_get_us();
+		err = mtd_read_pages(ubi->mtd, pf->offs, n, pf->buf, pf->stat);
+		pf->stats.io_us += timer_get_us() - start;
+		if (err)
+			return;
+
+		pf->stats.hdr_pages += n;
+		pf->stats.batches++;
+	}
+
+	pf->count = i;
+}
+
 /**
  * validate_ec_hdr - validate an erase counter header.
  * @ubi: UBI device description object
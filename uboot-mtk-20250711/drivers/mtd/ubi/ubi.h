@@ -416,6 +416,56 @@ struct ubi_debug_info {
 	struct dentry *dfs_power_cut_max;
 };
 
+/* Number of PEBs whose headers are read in one batch while attaching */
+#define UBI_PREFETCH_PEBS 32
+
+/**
+ * struct ubi_attach_stats - statistics of attaching an MTD device.
+ * @total_us: time spent in attaching, in microseconds
+ * @io_us: part of @total_us spent in reading the flash
+ * @hdr_pages: number of EC/VID header pages read in batches
+ * @batches: number of batches
+ */
+struct ubi_attach_stats {
+	unsigned long total_us;
+	unsigned long io_us;
+	unsigned int hdr_pages;
+	unsigned int batches;
+};
+
+/**
+ * struct ubi_hdr_prefetch - EC/VID header pages read ahead while attaching.
+ * @first: first PEB of the window
+ * @count: number of PEBs in the window, zero if the window is empty
+ * @pages: number of header pages of each PEB, one if both headers share a
+ *         page
+ * @vid_page: offset of the page holding the VID header
+ * @bad: result of 'ubi_io_is_bad()' for each PEB of the window
+ * @page: index in @offs of the first header page of each PEB of the window,
+ *        %-1 for bad PEBs
+ * @stat: result of 'mtd_read_pages()' for each page of the window
+ * @offs: flash offsets of the pages of the window
+ * @buf: data of the pages of the window, %NULL if the MTD device can not
+ *       read pages in batch
+ * @stats: attaching statistics being collected
+ *
+ * Header pages of consecutive PEBs are read by one 'mtd_read_pages()' call,
+ * which lets the driver pipeline the reads. Reads of the headers are then
+ * served from @buf.
+ */
+struct ubi_hdr_prefetch {
+	int first;
+	int count;
+	int pages;
+	int vid_page;
+	int bad[UBI_PREFETCH_PEBS];
+	int page[UBI_PREFETCH_PEBS];
+	int stat[UBI_PREFETCH_PEBS * 2];
+	loff_t offs[UBI_PREFETCH_PEBS * 2];
+	void *buf;
+	struct ubi_attach_stats stats;
+};
+
 /**
  * struct ubi_device - UBI device description structure
  * @dev: UBI device object to use the the Linux device model
@@ -524,6 +574,8 @@ struct ubi_debug_info {
  * @max_write_size: maximum amount of bytes the underlying flash can write at a
  *                  time (MTD write buffer size)
  * @mtd: MTD device descriptor
+ * @hdr_pf: EC/VID header pages read ahead, only used while attaching
+ * @attach_stats: statistics of attaching the MTD device
  *
  * @peb_buf: a buffer of PEB size used for different purposes
  * @buf_mutex: protects @peb_buf
@@ -623,6 +675,8 @@ struct ubi_device {
 	unsigned int nor_flash:1;
 	int max_write_size;
 	struct mtd_info *mtd;
+	struct ubi_hdr_prefetch *hdr_pf;
+	struct ubi_attach_stats attach_stats;
 
 	void *peb_buf;
 	struct mutex buf_mutex;
@@ -892,6 +946,9 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture);
 int ubi_io_is_bad(const struct ubi_device *ubi, int pnum);
 int ubi_io_mark_bad(const struct ubi_device *ubi, int pnum);
+int ubi_io_prefetch_init(struct ubi_device *ubi);
+void ubi_io_prefetch_exit(struct ubi_device *ubi);
+void ubi_io_prefetch_hdrs(struct ubi_device *ubi, int pnum, int end);
 int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 		       struct ubi_ec_hdr *ec_hdr, int verbose);
 int ubi_io_write_ec_hdr(struct ubi_device *ubi, int pnum,
@@ -26,6 +26,7 @@
 #include <linux/mdio.h>
 #include <linux/mii.h>
 #include <linux/printk.h>
+#include <net/eth_keepalive.h>
 
 #include "mtk_eth.h"
 
@@ -111,6 +112,8 @@ struct mtk_eth_priv {
 
 	struct reset_ctl rst_fe;
 	struct reset_ctl rst_mcm;
+
+	struct eth_keepalive ka;
 };
 
 static void mtk_pdma_write(struct mtk_eth_priv *priv, u32 reg, u32 val)
@@ -1035,10 +1038,33 @@ static void mtk_eth_mdc_init(struct mtk_eth_priv *priv)
 		     FIELD_PREP(PHY_MDC_CFG, divider));
 }
 
-static int mtk_eth_start(struct udevice *dev)
+/*
+ * Whether the link stayed up since the last start. The link status bit is
+ * latched low, so a single read tells whether the link has ever gone down.
+ */
+static bool mtk_eth_link_alive(struct mtk_eth_priv *priv)
 {
-	struct mtk_eth_priv *priv = dev_get_priv(dev);
-	int i, ret;
+	int devad = MDIO_DEVAD_NONE, reg = MII_BMSR, val;
+
+	/* Links of switch ports and fixed links are not managed here */
+	if (priv->swpriv || priv->force_mode)
+		return true;
+
+	if (priv->phydev->is_c45) {
+		devad = MDIO_MMD_PCS;
+		reg = MDIO_STAT1;
+	}
+
+	val = phy_read(priv->phydev, devad, reg);
+	if (val < 0)
+		return false;
+
+	return !!(val & BMSR_LSTATUS);
+}
+
+static void mtk_eth_fe_init(struct mtk_eth_priv *priv)
+{
+	int i;
 
 	/* Reset FE */
 	reset_assert(&priv->rst_fe);
@@ -1078,6 +1104,20 @@ static int mtk_eth_start(struct udevice *dev)
 	}
 
 	udelay(500);
+}
+
+static int mtk_eth_start(struct udevice *dev)
+{
+	struct mtk_eth_priv *priv = dev_get_priv(dev);
+	bool full;
+	int ret;
+
+	/* With keep-alive, FE and the link may be kept from the last start */
+	full = !eth_keepalive_quick_start(&priv->ka) ||
+	       !mtk_eth_link_alive(priv);
+
+	if (full)
+		mtk_eth_fe_init(priv);
 
 	mtk_eth_fifo_init(priv);
 
@@ -1085,17 +1125,22 @@ static int mtk_eth_start(struct udevice *dev)
 		/* Enable communication with switch */
 		if (priv->swpriv->sw->mac_control)
 			priv->swpriv->sw->mac_control(priv->swpriv, true);
-	} else {
+	} else if (full) {
 		/* Start PHY */
 		ret = mtk_phy_start(priv);
-		if (ret)
+		if (ret) {
+			eth_keepalive_reset(&priv->ka);
 			return ret;
+		}
 	}
 
 	mtk_pdma_rmw(priv, PDMA_GLO_CFG_REG, 0,
 		     TX_WB_DDONE | RX_DMA_EN | TX_DMA_EN);
 	udelay(500);
 
+	eth_keepalive_started(&priv->ka, full,
+			      priv->swpriv || priv->phydev->link);
+
 	return 0;
 }
 
@@ -1114,6 +1159,8 @@ static void mtk_eth_stop(struct udevice *dev)
 
 	wait_for_bit_le32(priv->fe_base + priv->soc->pdma_base + PDMA_GLO_CFG_REG,
 			  RX_DMA_BUSY | TX_DMA_BUSY, 0, 5000, 0);
+
+	eth_keepalive_stopped(&priv->ka);
 }
 
 static int mtk_eth_write_hwaddr(struct udevice *dev)
@@ -1228,6 +1275,8 @@ static int mtk_eth_probe(struct udevice *dev)
 	/* Frame Engine Register Base */
 	priv->fe_base = (void *)iobase;
 
+	priv->ka.enabled = IS_ENABLED(CONFIG_MTK_ETH_KEEPALIVE);
+
 	/* GMAC Register Base */
 	priv->gmac_base = (void *)(iobase + GMAC_BASE);
 
@@ -1276,6 +1325,7 @@ static int mtk_eth_remove(struct udevice *dev)
 
 	/* Stop possibly started DMA */
 	mtk_eth_stop(dev);
+	eth_keepalive_reset(&priv->ka);
 
 	if (priv->swpriv) {
 		if (priv->swpriv->sw->cleanup)
@@ -109,6 +109,67 @@ void sandbox_eth_disable_response(int index, bool disable)
 	priv->disabled = disable;
 }
 
+/*
+ * sandbox_eth_set_keepalive()
+ *
+ * index - The alias index (also DM seq number)
+ * enable - Whether to use keep-alive between network commands
+ */
+void sandbox_eth_set_keepalive(int index, bool enable)
+{
+	struct udevice *dev;
+	struct eth_sandbox_priv *priv;
+	int ret;
+
+	ret = uclass_get_device(UCLASS_ETH, index, &dev);
+	if (ret)
+		return;
+
+	priv = dev_get_priv(dev);
+	memset(&priv->ka, 0, sizeof(priv->ka));
+	priv->ka.enabled = enable;
+}
+
+/*
+ * sandbox_eth_get_keepalive()
+ *
+ * index - The alias index (also DM seq number)
+ * returns the keep-alive state, NULL if the device is not found
+ */
+const struct eth_keepalive *sandbox_eth_get_keepalive(int index)
+{
+	struct udevice *dev;
+	struct eth_sandbox_priv *priv;
+	int ret;
+
+	ret = uclass_get_device(UCLASS_ETH, index, &dev);
+	if (ret)
+		return NULL;
+
+	priv = dev_get_priv(dev);
+
+	return &priv->ka;
+}
+
+/*
+ * sandbox_eth_link_flap()
+ *
+ * index - The alias index (also DM seq number)
+ */
+void sandbox_eth_link_flap(int index)
+{
+	struct udevice *dev;
+	struct eth_sandbox_priv *priv;
+	int ret;
+
+	ret = uclass_get_device(UCLASS_ETH, index, &dev);
+	if (ret)
+		return;
+
+	priv = dev_get_priv(dev);
+	priv->link_lost = true;
+}
+
 /*
  * sandbox_eth_skip_timeout()
  *
@@ -397,11 +458,28 @@ void sandbox_eth_set_priv(int index, void *priv)
 	dev_priv->priv = priv;
 }
 
+/* Reading the mocked link status clears the latched link loss */
+static bool sb_eth_link_alive(struct eth_sandbox_priv *priv)
+{
+	bool alive = !priv->link_lost;
+
+	priv->link_lost = false;
+
+	return alive;
+}
+
 static int sb_eth_start(struct udevice *dev)
 {
 	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	bool full;
+
+	full = !eth_keepalive_quick_start(&priv->ka) ||
+	       !sb_eth_link_alive(priv);
+
+	debug("eth_sandbox: Start (%s)\n", full ? "full" : "re-arm");
 
-	debug("eth_sandbox: Start\n");
+	if (full)
+		priv->link_lost = false;
 
 	priv->recv_packets = 0;
 	for (int i = 0; i < PKTBUFSRX; i++) {
@@ -409,6 +487,8 @@ static int sb_eth_start(struct udevice *dev)
 		priv->recv_packet_length[i] = 0;
 	}
 
+	eth_keepalive_started(&priv->ka, full, true);
+
 	return 0;
 }
 
@@ -466,7 +546,11 @@ static int sb_eth_free_pkt(struct udevice *dev, uchar *packet, int length)
 
 static void sb_eth_stop(struct udevice *dev)
 {
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+
 	debug("eth_sandbox: Stop\n");
+
+	eth_keepalive_stopped(&priv->ka);
 }
 
 static int sb_eth_write_hwaddr(struct udevice *dev)
@@ -491,6 +575,10 @@ static const struct eth_ops sb_eth_ops = {
 
 static int sb_eth_remove(struct udevice *dev)
 {
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+
+	eth_keepalive_reset(&priv->ka);
+
 	return 0;
 }
 
@@ -14,14 +14,15 @@
 #include <net.h>
 #include <net/mtk_tcp.h>
 #include <net/mtk_httpd.h>
-#include <u-boot/md5.h>
 #include <linux/stringify.h>
 #include <dm/ofnode.h>
 #include <vsprintf.h>
 #include <version_string.h>
 #include <failsafe/fw_type.h>
+#include <u-boot/crc.h>
 
 #include "../board/mediatek/common/boot_helper.h"
+#include "../board/mediatek/common/data_hash.h"
 #include "fs.h"
 
 static u32 upload_data_id;
@@ -30,6 +31,14 @@ static size_t upload_size;
 static int upgrade_success;
 static failsafe_fw_t fw_type;
 
+#define UPLOAD_HASH_ALGOS	(DATA_HASH_MD5 | \
+	(IS_ENABLED(CONFIG_WEBUI_FAILSAFE_HASH_SHA1) ? DATA_HASH_SHA1 : 0) | \
+	(IS_ENABLED(CONFIG_WEBUI_FAILSAFE_HASH_SHA256) ? DATA_HASH_SHA256 : 0) | \
+	(IS_ENABLED(CONFIG_WEBUI_FAILSAFE_HASH_CRC32) ? DATA_HASH_CRC32 : 0))
+
+static struct data_hash_ctx upload_hash;
+static const struct httpd_form_value *hash_field;
+
 #ifdef CONFIG_MEDIATEK_MULTI_MTD_LAYOUT
 static const char *mtd_layout_label;
 const char *get_mtd_layout_label(void);
@@ -46,6 +55,154 @@ int __weak failsafe_write_image(const void *data, size_t size, failsafe_fw_t fw)
 	return -ENOSYS;
 }
 
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+static bool stream_active, stream_done;
+static failsafe_fw_t stream_fw_type;
+static const struct httpd_form_value *stream_field;
+
+int __weak failsafe_stream_begin(failsafe_fw_t fw)
+{
+	return -ENOSYS;
+}
+
+int __weak failsafe_stream_feed(const void *data, size_t size, bool last)
+{
+	return -ENOSYS;
+}
+
+int __weak failsafe_stream_finish(const void *data, size_t size, bool commit)
+{
+	return -ENOSYS;
+}
+
+static void upload_stream_abort(void)
+{
+	if (!stream_active)
+		return;
+
+	failsafe_stream_finish(NULL, 0, false);
+
+	stream_active = false;
+	stream_done = false;
+	stream_field = NULL;
+}
+
+static void upload_stream_event(enum httpd_form_data_event event,
+				struct httpd_request *request,
+				struct httpd_form_value *field)
+{
+	switch (event) {
+	case HTTP_FORM_FIELD_BEGIN:
+		/* A previous upload was never committed */
+		if (!request->form.count)
+			upload_stream_abort();
+
+		/* Only one image is streamed, later fields are just kept */
+		if (stream_active)
+			return;
+
+		if (!strcmp(field->name, "bl2"))
+			stream_fw_type = FW_TYPE_BL2;
+		else if (!strcmp(field->name, "fip"))
+			stream_fw_type = FW_TYPE_FIP;
+		else
+			return;
+
+		if (failsafe_stream_begin(stream_fw_type))
+			return;
+
+		stream_active = true;
+		stream_field = field;
+		break;
+
+	case HTTP_FORM_FIELD_DATA:
+	case HTTP_FORM_FIELD_END:
+		if (!stream_active || field != stream_field)
+			break;
+
+		/* Data is also saved, and field->data holds all of it */
+		if (failsafe_stream_feed(field->data, field->size,
+					 event == HTTP_FORM_FIELD_END)) {
+			upload_stream_abort();
+			break;
+		}
+
+		if (event == HTTP_FORM_FIELD_END) {
+			stream_done = true;
+			stream_field = NULL;
+		}
+		break;
+
+	case HTTP_FORM_FIELD_ABORT:
+		if (field == stream_field)
+			upload_stream_abort();
+		break;
+	}
+}
+#endif /* CONFIG_WEBUI_FAILSAFE_STREAM_FLASH */
+
+static void upload_hash_event(enum httpd_form_data_event event,
+			      struct httpd_request *request,
+			      struct httpd_form_value *field,
+			      const void *data, size_t size)
+{
+	switch (event) {
+	case HTTP_FORM_FIELD_BEGIN:
+		/*
+		 * Digests of a previous request must not be reused, and the
+		 * upload buffer is about to be overwritten
+		 */
+		if (!request->form.count) {
+			data_hash_unpublish();
+			data_hash_init(&upload_hash, 0);
+			hash_field = NULL;
+		}
+
+		if (!field->filename)
+			break;
+
+		data_hash_init(&upload_hash, UPLOAD_HASH_ALGOS);
+		hash_field = field;
+		break;
+
+	case HTTP_FORM_FIELD_DATA:
+		if (field == hash_field)
+			data_hash_update(&upload_hash, data, size);
+		break;
+
+	case HTTP_FORM_FIELD_END:
+		if (field != hash_field)
+			break;
+
+		data_hash_finish(&upload_hash, field->data, field->size);
+		hash_field = NULL;
+		break;
+
+	case HTTP_FORM_FIELD_ABORT:
+		if (field != hash_field)
+			break;
+
+		data_hash_init(&upload_hash, 0);
+		hash_field = NULL;
+		break;
+	}
+}
+
+static int upload_data_cb(enum httpd_form_data_event event,
+			  struct httpd_request *request,
+			  struct httpd_form_value *field,
+			  const void *data, size_t size)
+{
+	upload_hash_event(event, request, field, data, size);
+
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+	upload_stream_event(event, request, field);
+#endif
+
+	/* Always keep the data for validation and the buffered write path */
+	return 0;
+}
+
 static int output_plain_file(struct httpd_response *response,
 			     const char *filename)
 {
@@ -72,6 +229,51 @@ static int output_plain_file(struct httpd_response *response,
 	return ret;
 }
 
+/*
+ * Same as output_plain_file(), but the gzip-compressed copy is sent if the
+ * client accepts it, and the client may revalidate its cached copy by the
+ * ETag, which is the CRC32 and size of the data sent.
+ */
+static int output_static_file(struct httpd_request *request,
+			      struct httpd_response *response,
+			      const char *filename, const char *content_type)
+{
+	static char etag[24];
+	const struct fs_desc *gz;
+
+	if (output_plain_file(response, filename))
+		return 1;
+
+	response->info.content_type = content_type;
+
+	if (IS_ENABLED(CONFIG_WEBUI_FAILSAFE_GZIP)) {
+		gz = fs_find_file_gz(filename);
+		if (gz) {
+			response->info.vary_encoding = 1;
+
+			if (request->accept_gzip) {
+				response->data = gz->data;
+				response->size = gz->size;
+				response->info.content_encoding = "gzip";
+			}
+		}
+	}
+
+	snprintf(etag, sizeof(etag), "\"%08x-%x\"",
+		 crc32(0, (const u8 *)response->data, response->size),
+		 response->size);
+
+	response->info.etag = etag;
+
+	if (httpd_request_etag_match(request, etag)) {
+		response->info.code = 304;
+		response->data = NULL;
+		response->size = 0;
+	}
+
+	return 0;
+}
+
 static void version_handler(enum httpd_uri_handler_status status,
 	struct httpd_request *request,
 	struct httpd_response *response)
@@ -94,7 +296,8 @@ static void index_handler(enum httpd_uri_handler_status status,
 			  struct httpd_response *response)
 {
 	if (status == HTTP_CB_NEW)
-		output_plain_file(response, "index.html");
+		output_static_file(request, response, "index.html",
+				   "text/html");
 }
 
 
@@ -108,8 +311,8 @@ static void upload_handler(enum httpd_uri_handler_status status,
 #ifdef CONFIG_MEDIATEK_MULTI_MTD_LAYOUT
 	struct httpd_form_value *mtd = NULL;
 #endif
-	u8 md5_sum[16];
-	int i;
+	u8 md5_sum[MD5_SUM_LEN];
+	int i, md5_len;
 
 	static char hexchars[] = "0123456789abcdef";
 
@@ -121,6 +324,9 @@ static void upload_handler(enum httpd_uri_handler_status status,
 	response->info.connection_close = 1;
 	response->info.content_type = "text/plain";
 
+	/* Let validators reuse digests calculated while receiving */
+	data_hash_publish(&upload_hash);
+
 #ifdef CONFIG_MTK_BOOTMENU_MMC
 	fw = httpd_request_find_value(request, "gpt");
 	if (fw) {
@@ -165,16 +371,23 @@ static void upload_handler(enum httpd_uri_handler_status status,
 	}
 
 fail:
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+	upload_stream_abort();
+#endif
 	response->data = "fail";
 	response->size = strlen(response->data);
 	return;
 
 done:
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+	if (stream_active && (!stream_done || stream_fw_type != fw_type))
+		upload_stream_abort();
+#endif
 	upload_data_id = upload_id;
 	upload_data = fw->data;
 	upload_size = fw->size;
 
-	md5_wd((u8 *)fw->data, fw->size, md5_sum, 0);
+	data_hash_calculate(fw->data, fw->size, "md5", md5_sum, &md5_len);
 	for (i = 0; i < 16; i++) {
 		u8 hex = (md5_sum[i] >> 4) & 0xf;
 		md5_str[i * 2] = hexchars[hex];
@@ -260,6 +473,12 @@ static void result_handler(enum httpd_uri_handler_status status,
 #endif
 			if (fw_type == FW_TYPE_INITRD)
 				st->ret = 0;
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+			else if (stream_active && stream_done)
+				st->ret = failsafe_stream_finish(upload_data,
+								 upload_size,
+								 true);
+#endif
 			else
 				st->ret = failsafe_write_image(upload_data,
 							       upload_size, fw_type);
@@ -267,6 +486,11 @@ static void result_handler(enum httpd_uri_handler_status status,
 
 		/* invalidate upload identifier */
 		upload_data_id = rand();
+		data_hash_unpublish();
+#ifdef CONFIG_WEBUI_FAILSAFE_STREAM_FLASH
+		stream_active = false;
+		stream_done = false;
+#endif
 
 		if (!st->ret)
 			response->data = "success";
@@ -296,20 +520,17 @@ static void style_handler(enum httpd_uri_handler_status status,
 			  struct httpd_request *request,
 			  struct httpd_response *response)
 {
-	if (status == HTTP_CB_NEW) {
-		output_plain_file(response, "style.css");
-		response->info.content_type = "text/css";
-	}
+	if (status == HTTP_CB_NEW)
+		output_static_file(request, response, "style.css", "text/css");
 }
 
 static void js_handler(enum httpd_uri_handler_status status,
 	struct httpd_request *request,
 	struct httpd_response *response)
 {
-	if (status == HTTP_CB_NEW) {
-		output_plain_file(response, "main.js");
-		response->info.content_type = "text/javascript";
-	}
+	if (status == HTTP_CB_NEW)
+		output_static_file(request, response, "main.js",
+				   "text/javascript");
 }
 
 static void not_found_handler(enum httpd_uri_handler_status status,
@@ -329,7 +550,8 @@ static void html_handler(enum httpd_uri_handler_status status,
 	if (status != HTTP_CB_NEW)
 		return;
 
-	if (output_plain_file(response, request->urih->uri + 1))
+	if (output_static_file(request, response, request->urih->uri + 1,
+			       "text/html"))
 		not_found_handler(status, request, response);
 }
 
@@ -377,6 +599,7 @@ static void mtd_layout_handler(enum httpd_uri_handler_status status,
 
 int start_web_failsafe(void)
 {
+	struct httpd_uri_handler *urih = NULL;
 	struct httpd_instance *inst;
 
 	inst = httpd_find_instance(80);
@@ -405,12 +628,18 @@ int start_web_failsafe(void)
 	httpd_register_uri_handler(inst, "/result", &result_handler, NULL);
 	httpd_register_uri_handler(inst, "/style.css", &style_handler, NULL);
 	httpd_register_uri_handler(inst, "/uboot.html", &html_handler, NULL);
-	httpd_register_uri_handler(inst, "/upload", &upload_handler, NULL);
+	httpd_register_uri_handler(inst, "/upload", &upload_handler, &urih);
+	httpd_set_form_data_cb(urih, upload_data_cb);
 	httpd_register_uri_handler(inst, "/version", &version_handler, NULL);
 	httpd_register_uri_handler(inst, "", &not_found_handler, NULL);
 
+	data_hash_unpublish();
+
 	net_loop(MTK_TCP);
 
+	/* The upload buffer may be reused once the failsafe UI has ended */
+	data_hash_unpublish();
+
 	return 0;
 }
 
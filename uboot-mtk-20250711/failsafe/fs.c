@@ -24,3 +24,22 @@ const struct fs_desc *fs_find_file(const char *path)
 
 	return NULL;
 }
+
+/* Find the gzip-compressed copy of a file, stored as "<path>.gz" */
+const struct fs_desc *fs_find_file_gz(const char *path)
+{
+	struct fs_desc *start = ll_entry_start(struct fs_desc, fs);
+	int len = ll_entry_count(struct fs_desc, fs);
+	size_t n = strlen(path);
+
+	while (len) {
+		if (!strncmp(start->path, path, n) &&
+		    !strcmp(start->path + n, ".gz"))
+			return start;
+
+		len--;
+		start++;
+	}
+
+	return NULL;
+}
@@ -15,5 +15,6 @@ struct fs_desc {
 };
 
 const struct fs_desc *fs_find_file(const char *path);
+const struct fs_desc *fs_find_file_gz(const char *path);
 
 #endif /* _FAILSAFE_FS_H_ */
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Copyright (C) 2025 MediaTek Inc. All Rights Reserved.
+ *
+ * Keep-alive state of Ethernet controllers between network commands
+ */
+
+#ifndef __NET_ETH_KEEPALIVE_H__
+#define __NET_ETH_KEEPALIVE_H__
+
+#include <linux/types.h>
+
+/*
+ * Every network command starts and stops the Ethernet controller. With
+ * keep-alive, the controller and the link are fully initialized by the first
+ * start only. Following starts only re-arm the DMA, as long as the link is
+ * still up since it was brought up.
+ */
+enum eth_keepalive_state {
+	ETH_KEEPALIVE_DOWN,	/* Not initialized */
+	ETH_KEEPALIVE_IDLE,	/* Initialized, DMA stopped */
+	ETH_KEEPALIVE_RUNNING,	/* Initialized, DMA running */
+};
+
+/**
+ * struct eth_keepalive - keep-alive state of an Ethernet controller
+ *
+ * @enabled: whether keep-alive is used
+ * @state: state of the controller
+ * @link_up: cached link state of the last start
+ * @full_starts: number of starts doing full initialization
+ * @quick_starts: number of starts re-arming the DMA only
+ */
+struct eth_keepalive {
+	bool enabled;
+	enum eth_keepalive_state state;
+	bool link_up;
+	u32 full_starts;
+	u32 quick_starts;
+};
+
+/**
+ * eth_keepalive_quick_start() - Check whether full initialization is avoidable
+ *
+ * @ka: keep-alive state
+ * Return: true if only the DMA needs to be re-armed, provided the driver has
+ *	   confirmed that the link did not go down since the last start
+ */
+static inline bool eth_keepalive_quick_start(const struct eth_keepalive *ka)
+{
+	return ka->enabled && ka->state == ETH_KEEPALIVE_IDLE && ka->link_up;
+}
+
+/**
+ * eth_keepalive_started() - Record a successful start
+ *
+ * @ka: keep-alive state
+ * @full: whether the controller has been fully initialized
+ * @link_up: link state after the start
+ */
+static inline void eth_keepalive_started(struct eth_keepalive *ka, bool full,
+					 bool link_up)
+{
+	ka->state = ETH_KEEPALIVE_RUNNING;
+	ka->link_up = link_up;
+
+	if (full)
+		ka->full_starts++;
+	else
+		ka->quick_starts++;
+}
+
+/**
+ * eth_keepalive_stopped() - Record a stop of the DMA
+ *
+ * @ka: keep-alive state
+ */
+static inline void eth_keepalive_stopped(struct eth_keepalive *ka)
+{
+	if (ka->state == ETH_KEEPALIVE_RUNNING)
+		ka->state = ETH_KEEPALIVE_IDLE;
+}
+
+/**
+ * eth_keepalive_reset() - Require full initialization on next start
+ *
+ * Used on failed starts and when the controller is removed.
+ *
+ * @ka: keep-alive state
+ */
+static inline void eth_keepalive_reset(struct eth_keepalive *ka)
+{
+	ka->state = ETH_KEEPALIVE_DOWN;
+	ka->link_up = false;
+}
+
+#endif /* __NET_ETH_KEEPALIVE_H__ */
@@ -13,6 +13,7 @@
 #include <linux/list.h>
 
 #define MAX_HTTP_FORM_VALUE_ITEMS	5
+#define MAX_HTTP_IF_NONE_MATCH_LEN	128
 
 struct httpd_form_value {
 	const char *name;
@@ -44,6 +45,12 @@ struct httpd_request {
 	enum httpd_request_method method;
 	const struct httpd_uri_handler *urih;
 	struct httpd_form_values form;
+
+	/* Accept-Encoding allows gzip */
+	bool accept_gzip;
+
+	/* If-None-Match, empty if absent or too long */
+	char if_none_match[MAX_HTTP_IF_NONE_MATCH_LEN];
 };
 
 enum httpd_response_status {
@@ -60,6 +67,11 @@ struct http_response_info {
 	int connection_close;
 	int chunked_encoding;
 	int http_1_0;
+
+	/* Responses with an ETag may be cached, but must be revalidated */
+	const char *etag;
+	const char *content_encoding;
+	int vary_encoding;
 };
 
 struct httpd_response {
@@ -75,9 +87,32 @@ typedef void(*httpd_uri_handler_cb)(enum httpd_uri_handler_status status,
 				    struct httpd_request *request,
 				    struct httpd_response *response);
 
+enum httpd_form_data_event {
+	HTTP_FORM_FIELD_BEGIN,
+	HTTP_FORM_FIELD_DATA,
+	HTTP_FORM_FIELD_END,
+	HTTP_FORM_FIELD_ABORT
+};
+
+/*
+ * Called for each multipart/form-data field while the request is still being
+ * received, before the URI handler is called with HTTP_CB_NEW.
+ *
+ * For HTTP_FORM_FIELD_BEGIN, return 0 to have the field data also saved into
+ * the upload buffer, positive to consume the data only in this callback, or
+ * negative to discard the field.
+ * For HTTP_FORM_FIELD_DATA, return negative to discard the field.
+ * HTTP_FORM_FIELD_ABORT is sent if the request ends before the field ends.
+ */
+typedef int (*httpd_form_data_cb)(enum httpd_form_data_event event,
+				  struct httpd_request *request,
+				  struct httpd_form_value *field,
+				  const void *data, size_t size);
+
 struct httpd_uri_handler {
 	const char *uri;
 	httpd_uri_handler_cb cb;
+	httpd_form_data_cb data_cb;
 };
 
 /* Last valid upload identifier */
@@ -105,6 +140,10 @@ int httpd_register_uri_handler(struct httpd_instance *httpd_inst,
 int httpd_unregister_uri_handler(struct httpd_instance *httpd_inst,
 				 struct httpd_uri_handler *urih);
 
+/* Set the streaming form data callback of an URI handler */
+int httpd_set_form_data_cb(struct httpd_uri_handler *urih,
+			   httpd_form_data_cb cb);
+
 /* Find URI handler from a http server instance */
 struct httpd_uri_handler *httpd_find_uri_handler(
 	struct httpd_instance *httpd_inst, const char *uri);
@@ -117,4 +156,8 @@ u32 http_make_response_header(struct http_response_info *info, char *buff,
 struct httpd_form_value *httpd_request_find_value(
 	struct httpd_request *request, const char *name);
 
+/* Check if the client already has the entity with the given ETag */
+bool httpd_request_etag_match(const struct httpd_request *request,
+			      const char *etag);
+
 #endif /* __NET_HTTPD_H__ */
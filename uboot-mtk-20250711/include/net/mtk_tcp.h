@@ -35,6 +35,20 @@ struct mtk_tcp_cb_data {
 
 typedef void (*mtk_tcp_conn_cb)(struct mtk_tcp_cb_data *cbd);
 
+struct mtk_tcp_conn_stats {
+	uint32_t srtt;
+	uint32_t rttvar;
+	uint32_t rto;
+	uint32_t rcv_wnd;
+	uint32_t ooo_segs;
+	uint32_t cwnd;
+	uint32_t fast_rexmits;
+	uint32_t timeouts;
+	uint64_t rx_bytes;
+	uint64_t tx_bytes;
+	unsigned long rx_time;
+};
+
 /* Initialize TCP subsystem */
 void mtk_tcp_start(void);
 
@@ -69,4 +83,10 @@ void mtk_tcp_reset_all_conn(void);
 /* Return 1 if connection is in ESTABLISHED state */
 int mtk_tcp_conn_is_alive(const void *conn);
 
+/* Get RTT/RTO and throughput statistics of a connection */
+int mtk_tcp_conn_get_stats(const void *conn, struct mtk_tcp_conn_stats *st);
+
+/* Print RTT/RTO, throughput and congestion statistics of a connection */
+void mtk_tcp_conn_print_stats(const void *conn);
+
 #endif /* __NET_MTK_MTK_TCP_H__ */
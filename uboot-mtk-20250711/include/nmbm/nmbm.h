@@ -51,6 +51,23 @@ struct nmbm_lower_device {
 	 *    return negative number for other errors
 	 */
 	int (*read_page)(void *arg, uint64_t addr, void *buf, void *oob, enum nmbm_oob_mode mode);
+
+	/*
+	 * read_pages: optional
+	 *    read main data of consecutive pages within one block
+	 *    return values are the same as read_page
+	 */
+	int (*read_pages)(void *arg, uint64_t addr, void *buf, uint32_t count, enum nmbm_oob_mode mode);
+
+	/*
+	 * read_page_list: optional
+	 *    read main data of a list of pages in any order
+	 *    stat of each page is the same as return value of read_page
+	 *    return 0 if stat has been filled, negative number otherwise
+	 */
+	int (*read_page_list)(void *arg, const uint64_t *addrs, uint32_t count, void *buf, int *stat,
+			      enum nmbm_oob_mode mode);
+
 	int (*write_page)(void *arg, uint64_t addr, const void *buf, const void *oob, enum nmbm_oob_mode mode);
 	int (*panic_write_page)(void *arg, uint64_t addr, const void *buf);
 	int (*erase_block)(void *arg, uint64_t addr);
@@ -86,6 +103,9 @@ int nmbm_read_single_page(struct nmbm_instance *ni, uint64_t addr, void *data,
 			  void *oob, enum nmbm_oob_mode mode);
 int nmbm_read_range(struct nmbm_instance *ni, uint64_t addr, size_t size,
 		    void *data, enum nmbm_oob_mode mode, size_t *retlen);
+int nmbm_read_page_list(struct nmbm_instance *ni, const uint64_t *addrs,
+			uint32_t count, void *data, int *stat,
+			enum nmbm_oob_mode mode);
 int nmbm_write_single_page(struct nmbm_instance *ni, uint64_t addr,
 			   const void *data, const void *oob,
 			   enum nmbm_oob_mode mode);
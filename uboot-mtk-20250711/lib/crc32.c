@@ -176,6 +176,61 @@ const uint32_t * ZEXPORT get_crc_table()
 # endif
 
 /* ========================================================================= */
+#ifdef CONFIG_ARM64_CRC32
+/*
+  Large buffers are processed in chunks of three lanes of CRC32_LANE_SIZE
+  bytes each, so that the CRC instructions of the three lanes can be
+  pipelined. The CRCs of the second and third lane start from zero and are
+  merged afterwards, which needs the CRC of the first lane shifted by two
+  lanes, and that of the second by one lane: a multiplication by
+  x^(16 * CRC32_LANE_SIZE) and x^(8 * CRC32_LANE_SIZE) mod p respectively.
+*/
+#define CRC32_LANE_SIZE		8192
+#define CRC32_LANE_WORDS	(CRC32_LANE_SIZE / 8)
+#define CRC32_LANE_SHIFT1	0x83852d0f
+#define CRC32_LANE_SHIFT2	0x30362f1a
+
+/* a(x) * b(x) mod p, in the bit order used above. a must not be zero. */
+static uint32_t __efi_runtime crc32_multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m = 1U << 31, p = 0;
+
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if (!(a & (m - 1)))
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ 0xedb88320 : b >> 1;
+    }
+
+    return p;
+}
+
+static uint32_t __efi_runtime crc32_lanes(uint32_t crc, const uint64_t *p,
+                                          size_t chunks)
+{
+    uint32_t crc1, crc2;
+    size_t i;
+
+    for (; chunks; chunks--, p += 3 * CRC32_LANE_WORDS) {
+        crc1 = 0;
+        crc2 = 0;
+        for (i = 0; i < CRC32_LANE_WORDS; i++) {
+            crc = __builtin_aarch64_crc32x(crc, le64_to_cpu(p[i]));
+            crc1 = __builtin_aarch64_crc32x(crc1,
+                        le64_to_cpu(p[i + CRC32_LANE_WORDS]));
+            crc2 = __builtin_aarch64_crc32x(crc2,
+                        le64_to_cpu(p[i + 2 * CRC32_LANE_WORDS]));
+        }
+        crc = crc32_multmodp(CRC32_LANE_SHIFT2, crc) ^
+              crc32_multmodp(CRC32_LANE_SHIFT1, crc1) ^ crc2;
+    }
+
+    return crc;
+}
+#endif
 
 /* No ones complement version. JFFS2 (and other things ?)
  * don't use ones compliment in their CRC calculations.
@@ -183,9 +238,33 @@ const uint32_t * ZEXPORT get_crc_table()
 uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
 {
 #ifdef CONFIG_ARM64_CRC32
+    const uint64_t *words;
+    size_t chunks, n;
+
     crc = cpu_to_le32(crc);
-    while (len--)
+    /* Align it */
+    while (len && ((uintptr_t)buf & 7)) {
         crc = __builtin_aarch64_crc32b(crc, *buf++);
+        len--;
+    }
+
+    words = (const uint64_t *)buf;
+
+    chunks = len / (3 * CRC32_LANE_SIZE);
+    if (chunks) {
+        crc = crc32_lanes(crc, words, chunks);
+        words += chunks * 3 * CRC32_LANE_WORDS;
+        len -= chunks * 3 * CRC32_LANE_SIZE;
+    }
+
+    for (n = len / 8; n; n--)
+        crc = __builtin_aarch64_crc32x(crc, le64_to_cpu(*words++));
+
+    /* And the last few bytes */
+    buf = (const Bytef *)words;
+    for (len &= 7; len; len--)
+        crc = __builtin_aarch64_crc32b(crc, *buf++);
+
     return le32_to_cpu(crc);
 #else
     const uint32_t *tab = crc_table;
@@ -31,6 +31,46 @@ struct _httpd_uri_handler {
 	struct httpd_uri_handler urih;
 };
 
+#define HTTPD_MP_MAX_BOUNDARY		70
+#define HTTPD_MP_MAX_DELIM		(HTTPD_MP_MAX_BOUNDARY + 4)
+#define HTTPD_MP_MAX_PART_HDR		1024
+#define HTTPD_MP_DATA_ALIGN		4
+
+enum httpd_mp_state {
+	HTTPD_MP_PREAMBLE = 0,
+	HTTPD_MP_DELIM_END,
+	HTTPD_MP_PART_HDR,
+	HTTPD_MP_PART_DATA,
+	HTTPD_MP_EPILOGUE
+};
+
+/* Incremental multipart/form-data parser */
+struct httpd_multipart {
+	enum httpd_mp_state state;
+
+	/* CRLF + "--" + boundary, with its Boyer-Moore-Horspool skip table */
+	u8 delim[HTTPD_MP_MAX_DELIM];
+	u32 delim_len;
+	u8 skip[256];
+
+	/* tail of previous segment which may be the start of a delimiter */
+	u8 carry[HTTPD_MP_MAX_DELIM];
+	u32 carry_len;
+
+	char hdr[HTTPD_MP_MAX_PART_HDR];
+	u32 hdr_len;
+
+	/* field being received */
+	struct httpd_form_value *field;
+	bool field_store;
+	bool field_discard;
+
+	/* buffer for saving field data */
+	char *store;
+	u32 store_pos;
+	bool store_alloced;
+};
+
 enum httpd_session_status {
 	HTTPD_S_NEW = 0,
 	HTTPD_S_HEADER_RECVING,
@@ -50,10 +90,11 @@ struct httpd_mtk_tcp_pdata {
 	char *boundary;
 
 	int is_uploading;
-	char *upload_ptr;
 	u32 payload_size;
 	u32 upload_size;
 
+	struct httpd_multipart mp;
+
 	struct httpd_request request;
 	struct httpd_response response;
 
@@ -68,6 +109,7 @@ struct http_response_code {
 static struct http_response_code http_resp_codes[] = {
 	{ 200, "OK" },
 	{ 302, "Found" },
+	{ 304, "Not Modified" },
 	{ 307, "Temporary Redirect" },
 	{ 400, "Bad Request" },
 	{ 403, "Forbidden" },
@@ -201,6 +243,17 @@ int httpd_register_uri_handler(struct httpd_instance *httpd_inst,
 	return 0;
 }
 
+int httpd_set_form_data_cb(struct httpd_uri_handler *urih,
+			   httpd_form_data_cb cb)
+{
+	if (!urih)
+		return -EINVAL;
+
+	urih->data_cb = cb;
+
+	return 0;
+}
+
 int httpd_unregister_uri_handler(struct httpd_instance *httpd_inst,
 				 struct httpd_uri_handler *urih)
 {
@@ -285,7 +338,26 @@ u32 http_make_response_header(struct http_response_info *info, char *buff,
 	if (p >= buff + size)
 		return size;
 
-	p += snprintf(p, buff + size - p, "Cache-Control: no-store\r\n");
+	if (info->content_encoding)
+		p += snprintf(p, buff + size - p, "Content-Encoding: %s\r\n",
+			      info->content_encoding);
+
+	if (p >= buff + size)
+		return size;
+
+	if (info->etag)
+		p += snprintf(p, buff + size - p,
+			      "ETag: %s\r\nCache-Control: no-cache\r\n",
+			      info->etag);
+	else
+		p += snprintf(p, buff + size - p, "Cache-Control: no-store\r\n");
+
+	if (p >= buff + size)
+		return size;
+
+	if (info->vary_encoding)
+		p += snprintf(p, buff + size - p,
+			      "Vary: Accept-Encoding\r\n");
 
 	if (p >= buff + size)
 		return size;
@@ -315,6 +387,494 @@ u32 http_make_response_header(struct http_response_info *info, char *buff,
 	return p - buff;
 }
 
+static char *name_extract(char *s)
+{
+	char *name, *p;
+
+	if (*s == '\"') {
+		s++;
+		name = s;
+		p = strchr(s, '\"');
+		if (p)
+			*p = 0;
+	} else {
+		name = s;
+		p = strchr(s, '\r');
+		if (p)
+			*p = 0;
+	}
+
+	return name;
+}
+
+/* Copy the value of a header field, without leading and trailing spaces */
+static bool httpd_get_field(const char *fields, const char *name, char *buf,
+			    u32 size)
+{
+	const char *p, *end;
+	u32 len;
+
+	p = strstr(fields, name);
+	if (!p)
+		return false;
+
+	p += strlen(name);
+	while (*p == ' ' || *p == '\t')
+		p++;
+
+	end = strstr(p, "\r\n");
+	if (!end)
+		end = p + strlen(p);
+
+	while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+		end--;
+
+	len = end - p;
+	if (len >= size)
+		return false;
+
+	memcpy(buf, p, len);
+	buf[len] = 0;
+
+	return true;
+}
+
+/* Check if a content coding is listed with a non-zero qvalue */
+static bool httpd_coding_accepted(const char *list, const char *coding)
+{
+	u32 len = strlen(coding);
+	const char *p = list;
+
+	while (p && *p) {
+		while (*p == ' ' || *p == ',')
+			p++;
+
+		if (!strncmp(p, coding, len) &&
+		    (!p[len] || strchr(" ,;", p[len]))) {
+			p += len;
+			while (*p == ' ')
+				p++;
+
+			if (*p != ';')
+				return true;
+
+			p++;
+			while (*p == ' ')
+				p++;
+
+			if (strncmp(p, "q=", 2))
+				return true;
+
+			/* q=0, q=0.0, q=0.00 and q=0.000 refuse the coding */
+			p += 2;
+			if (*p != '0')
+				return true;
+
+			p++;
+			if (*p == '.') {
+				p++;
+				while (*p == '0')
+					p++;
+			}
+
+			return *p >= '1' && *p <= '9';
+		}
+
+		p = strchr(p, ',');
+	}
+
+	return false;
+}
+
+static void httpd_parse_cache_fields(struct httpd_request *req,
+				     const char *fields)
+{
+	char accept_encoding[128];
+
+	static const char accept_encoding_str[] = "Accept-Encoding:";
+	static const char if_none_match_str[] = "If-None-Match:";
+
+	req->accept_gzip = false;
+	if (httpd_get_field(fields, accept_encoding_str, accept_encoding,
+			    sizeof(accept_encoding)))
+		req->accept_gzip = httpd_coding_accepted(accept_encoding,
+							 "gzip");
+
+	if (!httpd_get_field(fields, if_none_match_str, req->if_none_match,
+			     sizeof(req->if_none_match)))
+		req->if_none_match[0] = 0;
+}
+
+static int httpd_mp_init(struct httpd_multipart *mp, const char *boundary)
+{
+	u32 i, len = strlen(boundary);
+
+	if (!len || len > HTTPD_MP_MAX_BOUNDARY)
+		return -EINVAL;
+
+	/*
+	 * The first delimiter has no leading CRLF. The parser is fed with a
+	 * virtual CRLF first so that all delimiters can be matched the same.
+	 */
+	memcpy(mp->delim, "\r\n--", 4);
+	memcpy(mp->delim + 4, boundary, len);
+	mp->delim_len = len + 4;
+
+	for (i = 0; i < ARRAY_SIZE(mp->skip); i++)
+		mp->skip[i] = mp->delim_len;
+
+	for (i = 0; i < mp->delim_len - 1; i++)
+		mp->skip[mp->delim[i]] = mp->delim_len - 1 - i;
+
+	mp->state = HTTPD_MP_PREAMBLE;
+
+	return 0;
+}
+
+/* Boyer-Moore-Horspool search of the delimiter */
+static int httpd_mp_search(const struct httpd_multipart *mp, const u8 *data,
+			   u32 len)
+{
+	u32 last = mp->delim_len - 1, i = 0;
+	u8 c;
+
+	while (i + mp->delim_len <= len) {
+		c = data[i + last];
+		if (c == mp->delim[last] && !memcmp(data + i, mp->delim, last))
+			return i;
+
+		i += mp->skip[c];
+	}
+
+	return -1;
+}
+
+/* Find the start of a partial delimiter at the end of data */
+static u32 httpd_mp_partial(const struct httpd_multipart *mp, const u8 *data,
+			    u32 len)
+{
+	u32 i = 0;
+
+	if (len >= mp->delim_len)
+		i = len - mp->delim_len + 1;
+
+	for (; i < len; i++) {
+		if (data[i] == mp->delim[0] &&
+		    !memcmp(data + i, mp->delim, len - i))
+			return i;
+	}
+
+	return len;
+}
+
+static void httpd_mp_field_abort(struct httpd_mtk_tcp_pdata *pdata)
+{
+	struct httpd_request *req = &pdata->request;
+	struct httpd_multipart *mp = &pdata->mp;
+
+	if (!mp->field)
+		return;
+
+	if (!mp->field_discard && req->urih && req->urih->data_cb)
+		req->urih->data_cb(HTTP_FORM_FIELD_ABORT, req, mp->field,
+				   NULL, 0);
+
+	free((char *)mp->field->name);
+	free((char *)mp->field->filename);
+	memset(mp->field, 0, sizeof(*mp->field));
+
+	mp->field = NULL;
+}
+
+static void httpd_mp_field_begin(struct httpd_mtk_tcp_pdata *pdata)
+{
+	struct httpd_request *req = &pdata->request;
+	struct httpd_multipart *mp = &pdata->mp;
+	struct httpd_form_value *val;
+	char *name_ptr, *filename_ptr;
+	int ret = 0;
+
+	static const char name_str[] = "name=";
+	static const char filename_str[] = "filename=";
+
+	mp->field = NULL;
+
+	if (req->form.count >= MAX_HTTP_FORM_VALUE_ITEMS)
+		return;
+
+	val = &req->form.values[req->form.count];
+	memset(val, 0, sizeof(*val));
+
+	name_ptr = strstr(mp->hdr, name_str);
+	filename_ptr = strstr(mp->hdr, filename_str);
+
+	if (name_ptr) {
+		name_ptr += sizeof(name_str) - 1;
+		val->name = strdup(name_extract(name_ptr));
+	}
+
+	if (filename_ptr) {
+		filename_ptr += sizeof(filename_str) - 1;
+		val->filename = strdup(name_extract(filename_ptr));
+	}
+
+	if (!val->name) {
+		free((char *)val->filename);
+		val->filename = NULL;
+		return;
+	}
+
+	mp->field = val;
+	mp->field_discard = false;
+	mp->field_store = !!mp->store;
+
+	if (req->urih && req->urih->data_cb) {
+		ret = req->urih->data_cb(HTTP_FORM_FIELD_BEGIN, req, val,
+					 NULL, 0);
+		if (ret < 0) {
+			mp->field_discard = true;
+			mp->field_store = false;
+		} else if (ret > 0) {
+			mp->field_store = false;
+		}
+	}
+
+	if (mp->field_store) {
+		mp->store_pos = ALIGN(mp->store_pos, HTTPD_MP_DATA_ALIGN);
+		val->data = mp->store + mp->store_pos;
+	}
+}
+
+static void httpd_mp_field_data(struct httpd_mtk_tcp_pdata *pdata,
+				const u8 *data, u32 len)
+{
+	struct httpd_request *req = &pdata->request;
+	struct httpd_multipart *mp = &pdata->mp;
+
+	if (!len || !mp->field || mp->field_discard)
+		return;
+
+	if (mp->field_store) {
+		memcpy(mp->store + mp->store_pos, data, len);
+		mp->store_pos += len;
+	}
+
+	mp->field->size += len;
+
+	if (req->urih && req->urih->data_cb) {
+		if (req->urih->data_cb(HTTP_FORM_FIELD_DATA, req, mp->field,
+				       data, len) < 0)
+			mp->field_discard = true;
+	}
+}
+
+static void httpd_mp_field_end(struct httpd_mtk_tcp_pdata *pdata)
+{
+	struct httpd_request *req = &pdata->request;
+	struct httpd_multipart *mp = &pdata->mp;
+
+	if (!mp->field)
+		return;
+
+	if (mp->field_discard) {
+		httpd_mp_field_abort(pdata);
+		return;
+	}
+
+	if (mp->field_store)
+		mp->store[mp->store_pos++] = 0;
+
+	if (req->urih && req->urih->data_cb)
+		req->urih->data_cb(HTTP_FORM_FIELD_END, req, mp->field, NULL, 0);
+
+	req->form.count++;
+	mp->field = NULL;
+}
+
+static void httpd_mp_emit(struct httpd_mtk_tcp_pdata *pdata, const u8 *data,
+			  u32 len)
+{
+	if (pdata->mp.state == HTTPD_MP_PART_DATA)
+		httpd_mp_field_data(pdata, data, len);
+}
+
+static void httpd_mp_delim_found(struct httpd_mtk_tcp_pdata *pdata)
+{
+	struct httpd_multipart *mp = &pdata->mp;
+
+	if (mp->state == HTTPD_MP_PART_DATA)
+		httpd_mp_field_end(pdata);
+
+	mp->hdr_len = 0;
+	mp->state = HTTPD_MP_DELIM_END;
+}
+
+/* Search delimiter in data. Return number of bytes consumed. */
+static u32 httpd_mp_scan(struct httpd_mtk_tcp_pdata *pdata, const u8 *data,
+			 u32 len)
+{
+	struct httpd_multipart *mp = &pdata->mp;
+	u8 win[2 * HTTPD_MP_MAX_DELIM];
+	u32 n, wlen, carry_len;
+	int pos;
+
+	if (mp->carry_len) {
+		/*
+		 * A delimiter starting in the carried bytes must end within
+		 * the first (delim_len - 1) bytes of this segment.
+		 */
+		carry_len = mp->carry_len;
+		n = min(len, mp->delim_len - 1);
+		memcpy(win, mp->carry, carry_len);
+		memcpy(win + carry_len, data, n);
+		wlen = carry_len + n;
+		mp->carry_len = 0;
+
+		pos = httpd_mp_search(mp, win, wlen);
+		if (pos >= 0) {
+			httpd_mp_emit(pdata, win, pos);
+			httpd_mp_delim_found(pdata);
+			return pos + mp->delim_len - carry_len;
+		}
+
+		if (n < len) {
+			httpd_mp_emit(pdata, mp->carry, carry_len);
+			return 0;
+		}
+
+		/* The whole segment is in the window */
+		pos = httpd_mp_partial(mp, win, wlen);
+		httpd_mp_emit(pdata, win, pos);
+		mp->carry_len = wlen - pos;
+		memcpy(mp->carry, win + pos, mp->carry_len);
+		return len;
+	}
+
+	pos = httpd_mp_search(mp, data, len);
+	if (pos >= 0) {
+		httpd_mp_emit(pdata, data, pos);
+		httpd_mp_delim_found(pdata);
+		return pos + mp->delim_len;
+	}
+
+	pos = httpd_mp_partial(mp, data, len);
+	httpd_mp_emit(pdata, data, pos);
+	mp->carry_len = len - pos;
+	memcpy(mp->carry, data + pos, mp->carry_len);
+
+	return len;
+}
+
+static void httpd_mp_feed(struct httpd_mtk_tcp_pdata *pdata, const u8 *data,
+			  u32 len)
+{
+	struct httpd_multipart *mp = &pdata->mp;
+	u32 n;
+
+	while (len) {
+		switch (mp->state) {
+		case HTTPD_MP_PREAMBLE:
+		case HTTPD_MP_PART_DATA:
+			n = httpd_mp_scan(pdata, data, len);
+			break;
+
+		case HTTPD_MP_DELIM_END:
+			/* CRLF for next part, or "--" for the last one */
+			mp->hdr[mp->hdr_len++] = *data;
+			n = 1;
+
+			if (mp->hdr_len < 2)
+				break;
+
+			if (!memcmp(mp->hdr, "\r\n", 2)) {
+				mp->hdr_len = 0;
+				mp->state = HTTPD_MP_PART_HDR;
+			} else {
+				mp->state = HTTPD_MP_EPILOGUE;
+			}
+			break;
+
+		case HTTPD_MP_PART_HDR:
+			if (mp->hdr_len >= sizeof(mp->hdr) - 1) {
+				/* part header too large, ignore the rest */
+				mp->state = HTTPD_MP_EPILOGUE;
+				n = 0;
+				break;
+			}
+
+			mp->hdr[mp->hdr_len++] = *data;
+			n = 1;
+
+			if ((mp->hdr_len == 2 && !memcmp(mp->hdr, "\r\n", 2)) ||
+			    (mp->hdr_len >= 4 &&
+			     !memcmp(mp->hdr + mp->hdr_len - 4, "\r\n\r\n", 4))) {
+				mp->hdr[mp->hdr_len] = 0;
+				mp->state = HTTPD_MP_PART_DATA;
+				httpd_mp_field_begin(pdata);
+			}
+			break;
+
+		default:
+			/* discard epilogue */
+			return;
+		}
+
+		data += n;
+		len -= n;
+	}
+}
+
+static void httpd_mp_cleanup(struct httpd_mtk_tcp_pdata *pdata)
+{
+	struct httpd_request *req = &pdata->request;
+	struct httpd_multipart *mp = &pdata->mp;
+	u32 i;
+
+	httpd_mp_field_abort(pdata);
+
+	for (i = 0; i < req->form.count; i++) {
+		free((char *)req->form.values[i].name);
+		free((char *)req->form.values[i].filename);
+	}
+
+	req->form.count = 0;
+
+	if (mp->store_alloced)
+		free(mp->store);
+
+	mp->store = NULL;
+	mp->store_alloced = false;
+}
+
+static void httpd_recv_payload_data(struct mtk_tcp_cb_data *cbd,
+				    const void *data, u32 len)
+{
+	struct httpd_mtk_tcp_pdata *pdata = cbd->pdata;
+	u32 size_recv;
+
+	size_recv = min(pdata->payload_size - pdata->upload_size, len);
+
+	if (size_recv && pdata->boundary)
+		httpd_mp_feed(pdata, data, size_recv);
+
+	pdata->upload_size += size_recv;
+
+	if (pdata->upload_size < pdata->payload_size)
+		return;
+
+	/* fields not terminated by a delimiter are incomplete */
+	httpd_mp_field_abort(pdata);
+
+	pdata->status = HTTPD_S_FULL_RCVD;
+
+	if (pdata->is_uploading) {
+		/* remove uploading mark */
+		pdata->is_uploading = 0;
+		is_uploading = 0;
+		mtk_tcp_conn_print_stats(cbd->conn);
+	}
+}
+
 static int httpd_recv_hdr(struct httpd_instance *inst,
 			  struct mtk_tcp_cb_data *cbd)
 {
@@ -400,6 +960,11 @@ static int httpd_recv_hdr(struct httpd_instance *inst,
 	/* record URI */
 	pdata->uri = uri_ptr;
 
+	pdata->request.method = method;
+
+	/* before fields are cut by parsing below */
+	httpd_parse_cache_fields(&pdata->request, fields_ptr);
+
 	/* find required fields if this is a POST request */
 	if (method == HTTP_POST) {
 		/* Content-Length */
@@ -441,10 +1006,25 @@ static int httpd_recv_hdr(struct httpd_instance *inst,
 			debug("    Content-Type: boundary=\"%s\"\n", b_ptr);
 		}
 
+		/* the handler may consume form data while it's being received */
+		pdata->request.urih = httpd_find_uri_handler(inst, pdata->uri);
+
+		if (pdata->boundary) {
+			if (httpd_mp_init(&pdata->mp, pdata->boundary))
+				goto bad_request;
+
+			httpd_mp_feed(pdata, (const u8 *)"\r\n", 2);
+		}
+
 		if (hdr_size + pdata->payload_size < sizeof(pdata->buf)) {
-			/* upload payload can be put into the cache */
-			pdata->upload_ptr = pdata->buf + hdr_size;
-			pdata->upload_size = pdata->bufsize - hdr_size;
+			/* small form data, saved into a temporary buffer */
+			pdata->mp.store = malloc(pdata->payload_size + 1);
+			if (!pdata->mp.store) {
+				err_code = 500;
+				goto bad_request;
+			}
+
+			pdata->mp.store_alloced = true;
 		} else {
 			/* upload payload must be put into unused ram region */
 			if (is_uploading) {
@@ -457,36 +1037,33 @@ static int httpd_recv_hdr(struct httpd_instance *inst,
 			upload_id = rand();
 
 			/* calculate new cache address */
-			pdata->upload_ptr = httpd_get_upload_buffer_ptr(
+			pdata->mp.store = httpd_get_upload_buffer_ptr(
 				pdata->payload_size);
-			pdata->upload_size = cbd->datalen - hdr_size;
-			/* copy received parts to new cache */
-			memcpy(pdata->upload_ptr, cbd->data + hdr_size,
-			       pdata->upload_size);
-		}
 
-		if (pdata->upload_size == pdata->payload_size) {
-			/* upload completed */
-			pdata->upload_ptr[pdata->payload_size] = 0;
-			pdata->status = HTTPD_S_FULL_RCVD;
-		} else {
-			/* switch status for further receving */
-			pdata->status = HTTPD_S_PAYLOAD_RECVING;
 			/* uploading mark */
 			pdata->is_uploading = 1;
 			is_uploading = 1;
-			/*
-			 * payload of current packet has been fully received,
-			 * stop going to next status.
-			 */
-			ret = 1;
 		}
+
+		pdata->status = HTTPD_S_PAYLOAD_RECVING;
+		pdata->upload_size = 0;
+
+		/* parse payload received along with the header */
+		httpd_recv_payload_data(cbd, pdata->buf + hdr_size,
+					pdata->bufsize - hdr_size);
+		httpd_recv_payload_data(cbd, (u8 *)cbd->data + size_rcvd,
+					cbd->datalen - size_rcvd);
+
+		/*
+		 * if payload of current packet has been fully received,
+		 * stop going to next status.
+		 */
+		if (pdata->status != HTTPD_S_FULL_RCVD)
+			ret = 1;
 	} else {
 		pdata->status = HTTPD_S_FULL_RCVD;
 	}
 
-	pdata->request.method = method;
-
 	return ret;
 
 bad_request:
@@ -498,167 +1075,32 @@ static int httpd_recv_payload(struct httpd_instance *inst,
 			      struct mtk_tcp_cb_data *cbd)
 {
 	struct httpd_mtk_tcp_pdata *pdata = cbd->pdata;
-	u32 size_recv;
 
-	size_recv = min(pdata->payload_size - pdata->upload_size, cbd->datalen);
-	memcpy(pdata->upload_ptr + pdata->upload_size, cbd->data, size_recv);
-	pdata->upload_size += size_recv;
+	httpd_recv_payload_data(cbd, cbd->data, cbd->datalen);
 
-	if (pdata->upload_size == pdata->payload_size) {
-		pdata->upload_ptr[pdata->payload_size] = 0;
-		pdata->status = HTTPD_S_FULL_RCVD;
-		/* remove uploading mark */
-		pdata->is_uploading = 0;
-		is_uploading = 0;
+	if (pdata->status == HTTPD_S_FULL_RCVD)
 		return 0;
-	}
 
 	return 1;
 }
 
-static void *memstr(void *src, size_t limit, const char *str)
-{
-	int l2;
-	char *s1 = src;
-
-	if (!str)
-		return NULL;
-
-	l2 = strlen(str);
-
-	while (limit >= l2) {
-		limit--;
-		if (!memcmp(s1, str, l2))
-			return s1;
-		s1++;
-	}
-	return NULL;
-}
-
-static char *name_extract(char *s)
-{
-	char *name, *p;
-
-	if (*s == '\"') {
-		s++;
-		name = s;
-		p = strchr(s, '\"');
-		if (p)
-			*p = 0;
-	} else {
-		name = s;
-		p = strchr(s, '\r');
-		if (p)
-			*p = 0;
-	}
-
-	return name;
-}
-
 static int httpd_handle_request(struct httpd_instance *inst,
 				 struct mtk_tcp_cb_data *cbd)
 {
 	struct httpd_mtk_tcp_pdata *pdata = cbd->pdata;
 	struct httpd_request *req = &pdata->request;
-	char *formdata[MAX_HTTP_FORM_VALUE_ITEMS];
-	char *formdata_end[MAX_HTTP_FORM_VALUE_ITEMS], *p, *payload_end;
-	char *boundary, *name_ptr, *filename_ptr;
-	u32 i, numformdata = 0, boundarylen;
-	struct httpd_form_value *val;
-
-	static const char name_str[] = "name=";
-	static const char filename_str[] = "filename=";
 
 	schedule();
 
-	req->urih = httpd_find_uri_handler(inst, pdata->uri);
+	if (!req->urih)
+		req->urih = httpd_find_uri_handler(inst, pdata->uri);
+
 	if (!req->urih) {
 		/* TODO: no handler / response 404 */
 		mtk_tcp_close_conn(cbd->conn, 1);
 		return 1;
 	}
 
-	if (req->method == HTTP_POST) {
-		boundarylen = strlen(pdata->boundary);
-		boundary = malloc(boundarylen + 3);
-		if (!boundary) {
-			/* out of memory */
-			mtk_tcp_close_conn(cbd->conn, 1);
-			return 1;
-		}
-
-		/* add prefix -- */
-		boundary[0] = boundary[1] = '-';
-		memcpy(boundary + 2, pdata->boundary, boundarylen + 1);
-		boundarylen += 2;
-
-		/* record and split each formdata */
-		p = pdata->upload_ptr;
-		payload_end = pdata->upload_ptr + pdata->payload_size;
-		do {
-			p += boundarylen;
-			if (strncmp(p, "\r\n", 2))
-				break;
-
-			p += 2;
-
-			formdata[numformdata] = p;
-
-			p = memstr(p, payload_end - p, boundary);
-			if (!p)
-				break;
-
-			if (!strncmp(p - 2, "\r\n", 2))
-				p[-2] = 0;
-			else
-				*p = 0;
-
-			formdata_end[numformdata] = p - 2;
-			numformdata++;
-		} while (numformdata < MAX_HTTP_FORM_VALUE_ITEMS);
-
-		/* process each formdata */
-		for (i = 0; i < numformdata; i++) {
-			val = &req->form.values[req->form.count];
-			p = strstr(formdata[i], "\r\n\r\n");
-			if (!p)
-				continue;
-
-			*p = 0;
-			p += 4;
-
-			/*
-			 * make the data aligned by 4.
-			 * the previous 3 CR/LFs can be used as buffer.
-			 */
-			val->data = (char *)(((uintptr_t)p) & (~(4 - 1)));
-
-			name_ptr = strstr(formdata[i], name_str);
-			filename_ptr = strstr(formdata[i], filename_str);
-
-			if (name_ptr) {
-				name_ptr += sizeof(name_str) - 1;
-				val->name = name_extract(name_ptr);
-			}
-
-			if (filename_ptr) {
-				filename_ptr += sizeof(filename_str) - 1;
-				val->filename = name_extract(filename_ptr);
-			}
-
-			val->size = formdata_end[i] - p;
-			req->form.count++;
-
-			/* move data if not aligned */
-			if (p != val->data) {
-				memmove((char *)val->data, p, val->size);
-				((char *)val->data)[val->size] = 0;
-			}
-		}
-
-		free(boundary);
-	}
-
 	/* call uri handler */
 	assert((size_t)req->urih->cb > gd->ram_base);
 	req->urih->cb(HTTP_CB_NEW, req, &pdata->response);
@@ -672,7 +1114,12 @@ static int httpd_handle_request(struct httpd_instance *inst,
 		/* generate HTTP response header */
 		u32 size;
 
-		pdata->response.info.content_length = pdata->response.size;
+		/* 304 has no body, and must not claim a length of zero */
+		if (pdata->response.info.code == 304)
+			pdata->response.info.content_length = -1;
+		else
+			pdata->response.info.content_length =
+				pdata->response.size;
 
 		size = http_make_response_header(&pdata->response.info,
 						 pdata->buf,
@@ -681,7 +1128,7 @@ static int httpd_handle_request(struct httpd_instance *inst,
 		/* send response header */
 		mtk_tcp_send_data(cbd->conn, pdata->buf, size);
 
-		pdata->resp_std_cnt = 0;
+		pdata->resp_std_cnt = pdata->response.size ? 0 : 1;
 	} else {
 		/* send first response data */
 		mtk_tcp_send_data(cbd->conn, pdata->response.data,
@@ -767,6 +1214,8 @@ static void httpd_cleanup(struct httpd_instance *inst, struct mtk_tcp_cb_data *c
 		req->urih->cb(HTTP_CB_CLOSED, req, resp);
 	}
 
+	httpd_mp_cleanup(pdata);
+
 	free(pdata);
 }
 
@@ -859,3 +1308,16 @@ struct httpd_form_value *httpd_request_find_value(
 
 	return NULL;
 }
+
+bool httpd_request_etag_match(const struct httpd_request *request,
+			      const char *etag)
+{
+	if (!request || !etag || !request->if_none_match[0])
+		return false;
+
+	if (!strcmp(request->if_none_match, "*"))
+		return true;
+
+	/* Weak comparison, a W/ prefix does not matter */
+	return !!strstr(request->if_none_match, etag);
+}
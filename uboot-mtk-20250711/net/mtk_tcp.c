@@ -8,6 +8,7 @@
  */
 
 #include <command.h>
+#include <display_options.h>
 #include <div64.h>
 #include <errno.h>
 #include <malloc.h>
@@ -48,7 +49,14 @@ struct mtk_tcp_conn {
 	int ack_flag;
 
 	int rexmit_mode;
-	int rexmit_wait_ack;
+
+	u32 cwnd;
+	u32 ssthresh;
+	u32 dupacks;
+	u32 recover;
+	bool in_recovery;
+	u32 fast_rexmits;
+	u32 timeouts;
 
 	int zw_mode;
 	u32 peer_wnd;
@@ -60,9 +68,33 @@ struct mtk_tcp_conn {
 	u32 ts_rtt;
 	u32 ack_calc_rtt;
 
+	u32 rcv_wnd;
+	u32 rcv_ws;
+	bool ws_enabled;
+	u32 delack_segs;
+	u32 ts_delack;
+
+	struct list_head ooo_head;
+	u32 ooo_bytes;
+
+	u64 rx_bytes;
+	u64 tx_bytes;
+	u32 ts_rx_start;
+	u32 ts_rx_last;
+	u32 ooo_segs;
+
 	void *pdata;
 };
 
+struct mtk_tcp_ooo_seg {
+	struct list_head node;
+
+	u32 seq;
+	u32 len;
+	bool fin;
+	u8 data[];
+};
+
 struct mtk_tcp_listen {
 	struct list_head node;
 
@@ -155,9 +187,34 @@ static struct mtk_tcp_conn *mtk_tcp_conn_find(__be32 remoteip, __be16 remoteport
 	return NULL;
 }
 
+static bool mtk_tcp_conn_exists(struct mtk_tcp_conn *conn)
+{
+	struct list_head *lh;
+
+	list_for_each(lh, &conn_head) {
+		if (list_entry(lh, struct mtk_tcp_conn, node) == conn)
+			return true;
+	}
+
+	return false;
+}
+
+static void mtk_tcp_ooo_purge(struct mtk_tcp_conn *c)
+{
+	struct mtk_tcp_ooo_seg *seg, *n;
+
+	list_for_each_entry_safe(seg, n, &c->ooo_head, node) {
+		list_del(&seg->node);
+		free(seg);
+	}
+
+	c->ooo_bytes = 0;
+}
+
 static void mtk_tcp_conn_del(struct mtk_tcp_conn *c)
 {
 	list_del(&c->node);
+	mtk_tcp_ooo_purge(c);
 	free(c);
 }
 
@@ -236,16 +293,63 @@ static void rtt_calc(struct mtk_tcp_conn *c)
 	c->rto = c->srtt + max((u32)MTK_TCP_RTT_G, MTK_TCP_RTT_K * c->rttvar);
 }
 
-static void mtk_tcp_set_mss_opt(u8 *opt, u16 mss)
+static u32 mtk_tcp_rcv_ws(void)
+{
+	u32 ws = 0;
+
+	while ((MTK_TCP_RCV_WND >> ws) > 0xffff && ws < MTK_TCP_MAX_WS)
+		ws++;
+
+	return ws;
+}
+
+/* Receive window currently available, in bytes */
+static u32 mtk_tcp_rcv_wnd_avail(struct mtk_tcp_conn *c)
+{
+	u32 wnd = min(c->rcv_wnd, (u32)0xffff << c->rcv_ws);
+
+	if (c->ooo_bytes >= wnd)
+		return 0;
+
+	return wnd - c->ooo_bytes;
+}
+
+/* Window field to be filled into the TCP header */
+static u16 mtk_tcp_wnd_field(struct mtk_tcp_conn *c, u16 flags)
+{
+	u32 wnd = mtk_tcp_rcv_wnd_avail(c);
+
+	/* Window field of SYN segments is never scaled (RFC 7323) */
+	if (!(flags & MTK_TCP_SYN))
+		wnd >>= c->rcv_ws;
+
+	return min(wnd, (u32)0xffff);
+}
+
+static int mtk_tcp_set_mss_opt(u8 *opt, u16 mss, int ws)
 {
 	opt[0] = MTK_TCP_OPT_MSS;
 	opt[1] = 4;
 	opt[2] = (mss >> 8) & 0xff;
 	opt[3] = mss & 0xff;
-	opt[4] = MTK_TCP_OPT_WS;
-	opt[5] = 3;
-	opt[6] = 0;
-	opt[7] = MTK_TCP_OPT_EOL;
+
+	/* Window scale must not be sent if the peer's SYN didn't have it */
+	if (ws < 0)
+		return 4;
+
+	opt[4] = MTK_TCP_OPT_NOP;
+	opt[5] = MTK_TCP_OPT_WS;
+	opt[6] = 3;
+	opt[7] = ws;
+
+	return 8;
+}
+
+static void mtk_tcp_rcv_init(struct mtk_tcp_conn *c)
+{
+	INIT_LIST_HEAD(&c->ooo_head);
+	c->rcv_wnd = MTK_TCP_RCV_WND;
+	c->rcv_ws = mtk_tcp_rcv_ws();
 }
 
 static struct mtk_tcp_conn *mtk_tcp_conn_create(__be32 remoteip, struct mtk_tcp_hdr *tcp,
@@ -253,6 +357,8 @@ static struct mtk_tcp_conn *mtk_tcp_conn_create(__be32 remoteip, struct mtk_tcp_
 					mtk_tcp_conn_cb cb)
 {
 	struct mtk_tcp_conn *c, tmp_c;
+	bool ws_rcvd = false;
+	int opt_size;
 	u8 *optend;
 	u8 opt[8];
 	u16 mss;
@@ -267,6 +373,7 @@ static struct mtk_tcp_conn *mtk_tcp_conn_create(__be32 remoteip, struct mtk_tcp_
 	memset(c, 0, sizeof(struct mtk_tcp_conn));
 
 	list_add_tail(&c->node, &conn_head);
+	mtk_tcp_rcv_init(c);
 
 	c->status = SYN_RCVD;
 	memcpy(c->ethaddr, ethaddr, 6);
@@ -309,6 +416,7 @@ static struct mtk_tcp_conn *mtk_tcp_conn_create(__be32 remoteip, struct mtk_tcp_
 				break;
 			case MTK_TCP_OPT_WS:
 				c->peer_ws = min((u32)o[2], 14U);
+				ws_rcvd = true;
 				break;
 			}
 
@@ -316,16 +424,25 @@ static struct mtk_tcp_conn *mtk_tcp_conn_create(__be32 remoteip, struct mtk_tcp_
 		}
 	}
 
+	/* window scaling is only in effect if both sides sent the option */
+	c->ws_enabled = ws_rcvd;
+	if (!ws_rcvd)
+		c->rcv_ws = 0;
+
 	/* send first SYN ACK packet */
-	mtk_tcp_set_mss_opt(opt, c->mss);
+	opt_size = mtk_tcp_set_mss_opt(opt, c->mss,
+				       c->ws_enabled ? c->rcv_ws : -1);
 
 	mtk_tcp_send_packet_opt(c, MTK_TCP_SYN | MTK_TCP_ACK, c->local_seq, c->peer_seq + 1,
-			    opt, sizeof(opt), NULL, 0);
+			    opt, opt_size, NULL, 0);
 	c->ts_rtt = get_timer(0);
 	c->ts = get_timer(0);
 	c->ts_rexmit = get_timer(0);
 	c->num_rexmit = 0;
 
+	/* RTO of SYN ACK before the first RTT sample */
+	c->rto = MTK_TCP_CONNECT_INIT_DELAY;
+
 	return c;
 }
 
@@ -342,6 +459,7 @@ int mtk_tcp_connect(__be32 destip, __be16 port, mtk_tcp_conn_cb cb, void *pdata)
 		return -ENOMEM;
 
 	list_add_tail(&c->node, &conn_head);
+	mtk_tcp_rcv_init(c);
 
 	if (mtk_tcp_port_seq >= 65535)
 		mtk_tcp_port_seq = 50000;
@@ -372,6 +490,7 @@ int mtk_tcp_connect(__be32 destip, __be16 port, mtk_tcp_conn_cb cb, void *pdata)
 static void mtk_tcp_conn_fill(struct mtk_tcp_conn *c, struct mtk_tcp_hdr *tcp,
 			      u32 tcphdr_len, u8 *ethaddr)
 {
+	bool ws_rcvd = false;
 	u8 *optend;
 	u16 mss;
 	u8 *o;
@@ -401,6 +520,7 @@ static void mtk_tcp_conn_fill(struct mtk_tcp_conn *c, struct mtk_tcp_hdr *tcp,
 				break;
 			case MTK_TCP_OPT_WS:
 				c->peer_ws = min((u32)o[2], 14U);
+				ws_rcvd = true;
 				break;
 			}
 
@@ -408,12 +528,202 @@ static void mtk_tcp_conn_fill(struct mtk_tcp_conn *c, struct mtk_tcp_hdr *tcp,
 		}
 	}
 
+	c->ws_enabled = ws_rcvd;
+	if (!ws_rcvd)
+		c->rcv_ws = 0;
+
 	c->ts_rtt = get_timer(0);
 	c->ts = get_timer(0);
 	c->ts_rexmit = get_timer(0);
 	c->num_rexmit = 0;
 }
 
+static void mtk_tcp_rx_stats(struct mtk_tcp_conn *c, u32 len)
+{
+	if (!c->rx_bytes)
+		c->ts_rx_start = get_timer(0);
+
+	c->rx_bytes += len;
+	c->ts_rx_last = get_timer(0);
+}
+
+static void mtk_tcp_ack_delayed(struct mtk_tcp_conn *c)
+{
+	if (!c->delack_segs)
+		c->ts_delack = get_timer(0);
+
+	/* ACK at least every second full-sized segment (RFC 5681) */
+	if (++c->delack_segs >= MTK_TCP_DELACK_SEGS)
+		c->ack_flag++;
+}
+
+static void mtk_tcp_ooo_queue(struct mtk_tcp_conn *c, u32 seq, const u8 *data,
+			      u32 len, bool fin)
+{
+	u32 wnd = min(c->rcv_wnd, (u32)0xffff << c->rcv_ws);
+	struct mtk_tcp_ooo_seg *seg, *pos;
+
+	/* Drop segments beyond the window we've advertised */
+	if (mtk_tcp_seq_sub(seq + len, c->peer_seq) > wnd ||
+	    c->ooo_bytes + len > wnd)
+		return;
+
+	/* Keep the queue sorted by sequence number */
+	list_for_each_entry(pos, &c->ooo_head, node) {
+		if (pos->seq == seq && pos->len >= len && pos->fin >= fin)
+			return;
+
+		if (mtk_tcp_seq_sub(pos->seq, seq) > 0)
+			break;
+	}
+
+	seg = malloc(sizeof(*seg) + len);
+	if (!seg)
+		return;
+
+	seg->seq = seq;
+	seg->len = len;
+	seg->fin = fin;
+	memcpy(seg->data, data, len);
+
+	list_add_tail(&seg->node, &pos->node);
+	c->ooo_bytes += len;
+	c->ooo_segs++;
+}
+
+/*
+ * Deliver queued segments which have become in-order.
+ * Return false if the connection has been removed by the callback.
+ */
+static bool mtk_tcp_ooo_deliver(struct mtk_tcp_conn *c,
+				struct mtk_tcp_cb_data *cbd, u16 *flags)
+{
+	struct mtk_tcp_ooo_seg *seg;
+	u32 skip;
+
+	while (!list_empty(&c->ooo_head)) {
+		seg = list_first_entry(&c->ooo_head, struct mtk_tcp_ooo_seg,
+				       node);
+
+		if (mtk_tcp_seq_sub(seg->seq, c->peer_seq) > 0)
+			break;
+
+		list_del(&seg->node);
+		c->ooo_bytes -= seg->len;
+
+		if (seg->fin)
+			*flags |= MTK_TCP_FIN;
+
+		skip = c->peer_seq - seg->seq;
+		if (skip >= seg->len) {
+			/* Already covered by a retransmitted segment */
+			free(seg);
+			continue;
+		}
+
+		c->peer_seq += seg->len - skip;
+		mtk_tcp_rx_stats(c, seg->len - skip);
+
+		cbd->status = MTK_TCP_CB_DATA_RCVD;
+		cbd->data = seg->data + skip;
+		cbd->datalen = seg->len - skip;
+		assert((size_t)c->cb > gd->ram_base);
+		c->cb(cbd);
+
+		free(seg);
+
+		if (!mtk_tcp_conn_exists(c))
+			return false;
+	}
+
+	return true;
+}
+
+static void mtk_tcp_rexmit_init(struct mtk_tcp_conn *c)
+{
+	c->ts_rexmit = get_timer(0);
+	c->ts = get_timer(0);
+	c->num_rexmit = 0;
+}
+
+static void mtk_tcp_rexmit_reset(struct mtk_tcp_conn *c)
+{
+	c->ts = get_timer(0);
+	c->num_rexmit++;
+}
+
+static void mtk_tcp_cwnd_init(struct mtk_tcp_conn *c)
+{
+	c->cwnd = MTK_TCP_INIT_CWND * c->mss;
+	c->ssthresh = MTK_TCP_MAX_CWND;
+	c->dupacks = 0;
+	c->in_recovery = false;
+}
+
+/* Congestion detected, set new slow start threshold and window */
+static void mtk_tcp_cwnd_loss(struct mtk_tcp_conn *c, u32 cwnd)
+{
+	u32 inflight = mtk_tcp_seq_sub(c->local_seq, c->local_seq_acked);
+
+	c->ssthresh = max(inflight / 2, 2 * (u32)c->mss);
+	c->cwnd = cwnd;
+	c->dupacks = 0;
+	c->in_recovery = false;
+	c->ack_calc_rtt = 0;
+}
+
+static void mtk_tcp_cwnd_ack(struct mtk_tcp_conn *c, u32 ack, u32 acked)
+{
+	c->dupacks = 0;
+
+	if (c->in_recovery) {
+		if (mtk_tcp_seq_sub(ack, c->recover) >= 0) {
+			/* Full ACK, deflate the window */
+			c->in_recovery = false;
+			c->cwnd = c->ssthresh;
+			return;
+		}
+
+		/*
+		 * Partial ACK, retransmit the next unACKed segment and
+		 * deflate the window by the amount of new data ACKed
+		 */
+		c->cwnd -= min(c->cwnd, acked);
+		c->cwnd += c->mss;
+		c->rexmit_mode = 1;
+		return;
+	}
+
+	if (c->cwnd < c->ssthresh)
+		c->cwnd += min(acked, (u32)c->mss);
+	else
+		c->cwnd += max((u32)c->mss * c->mss / c->cwnd, 1U);
+
+	c->cwnd = min(c->cwnd, (u32)MTK_TCP_MAX_CWND);
+}
+
+static void mtk_tcp_cwnd_dupack(struct mtk_tcp_conn *c)
+{
+	c->dupacks++;
+
+	if (c->in_recovery) {
+		/* Each duplicated ACK means a segment has left the network */
+		c->cwnd = min(c->cwnd + c->mss, (u32)MTK_TCP_MAX_CWND);
+		return;
+	}
+
+	if (c->dupacks != MTK_TCP_DUPACK_THRESH)
+		return;
+
+	/* Fast retransmit, then enter fast recovery */
+	mtk_tcp_cwnd_loss(c, 0);
+	c->cwnd = c->ssthresh + MTK_TCP_DUPACK_THRESH * c->mss;
+	c->recover = c->local_seq;
+	c->in_recovery = true;
+	c->rexmit_mode = 1;
+	c->fast_rexmits++;
+}
+
 bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 {
 	struct mtk_tcp_hdr *tcp;
@@ -423,6 +733,7 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 	u8 *data;
 	u32 seq, ack, tmp;
 	u16 flags, chksum;
+	bool pure_ack, wnd_update;
 	struct mtk_tcp_cb_data cbd = {};
 
 	iphdr_len = (ip->ip_hl_v & 0x0f) * 4;
@@ -530,17 +841,29 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 
 		/* fall through */
 	case SYN_RCVD:
-		/* Calculate first RTO */
-		c->srtt = get_timer(c->ts_rtt);
-		c->rttvar = c->srtt / 2;
-		c->rto = c->srtt + max((u32)MTK_TCP_RTT_G,
-			MTK_TCP_RTT_K * c->rttvar);
+		/*
+		 * Calculate first RTO. The RTT can not be measured if SYN or
+		 * SYN ACK has been retransmitted, use the initial RTO then.
+		 */
+		if (!c->num_rexmit) {
+			c->srtt = get_timer(c->ts_rtt);
+			c->rttvar = c->srtt / 2;
+			c->rto = c->srtt + max((u32)MTK_TCP_RTT_G,
+				MTK_TCP_RTT_K * c->rttvar);
+		} else {
+			c->rto = MTK_TCP_CONNECT_INIT_DELAY;
+		}
 
 		c->peer_seq++;
 		c->local_seq++;
 		c->local_seq_last = c->local_seq;
 		c->local_seq_acked = c->local_seq;
 
+		mtk_tcp_cwnd_init(c);
+
+		/* Backoff of SYN (ACK) retransmissions must not be kept */
+		mtk_tcp_rexmit_init(c);
+
 		if (c->status == SYN_SENT) {
 			mtk_tcp_send_packet(c, MTK_TCP_ACK, c->local_seq,
 					    c->peer_seq, NULL, 0);
@@ -557,8 +880,11 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 
 		/* If there is incoming data, fall through */
 	case ESTABLISHED:
+		pure_ack = !data_size && !(flags & MTK_TCP_FIN);
+
 		/* Update window */
 		tmp = ntohs(tcp->wnd) << c->peer_ws;
+		wnd_update = tmp != c->peer_wnd;
 		if (tmp > c->mss && tmp > c->peer_wnd)
 			c->zw_mode = 0;
 		c->peer_wnd = tmp;
@@ -585,21 +911,31 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 		} else if (mtk_tcp_seq_sub(seq, c->peer_seq) > 0) {
 			/*
 			 * Incoming packet loss.
-			 * Discard the payload and send an ACK to request
-			 * retransmission.
+			 * Queue the payload and send a duplicated ACK
+			 * immediately to request retransmission.
 			 */
+			if (data_size || (flags & MTK_TCP_FIN))
+				mtk_tcp_ooo_queue(c, seq, data, data_size,
+						  flags & MTK_TCP_FIN);
 			data_size = 0;
+			flags &= ~MTK_TCP_FIN;
 			c->ack_flag++;
 		}
 
 		if (mtk_tcp_seq_sub(ack, c->local_seq_acked) > 0) {
-			/* clear retransmission state */
-			c->rexmit_mode = 0;
-			c->rexmit_wait_ack = 0;
-
 			/* The peer has ACKed new data */
+			tmp = mtk_tcp_seq_sub(ack, c->local_seq_acked);
 			c->local_seq_acked = ack;
 
+			/* Data sent before going back may be ACKed */
+			if (mtk_tcp_seq_sub(ack, c->local_seq) > 0)
+				c->local_seq = ack;
+
+			mtk_tcp_cwnd_ack(c, ack, tmp);
+
+			/* Restart retransmission timer for remaining data */
+			mtk_tcp_rexmit_init(c);
+
 			if (mtk_tcp_seq_sub(ack, c->ack_calc_rtt) >= 0 &&
 				c->ack_calc_rtt) {
 				/* Calculate new RTO */
@@ -629,11 +965,12 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 				goto check_new_data;
 
 			/*
-			 * Record the transmission position the peer required,
-			 * and enter the retransmission mode
+			 * Duplicated ACK carries neither data nor FIN, and
+			 * does not change the window (RFC 5681)
 			 */
-			c->local_seq_acked = ack;
-			c->rexmit_mode = 1;
+			if (pure_ack && !wnd_update &&
+			    ack == c->local_seq_acked)
+				mtk_tcp_cwnd_dupack(c);
 		}
 
 	check_new_data:
@@ -641,16 +978,28 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 			/*
 			 * We have new data received
 			 * Increase the next expected peer SEQ number
-			 * Send an ACK to acknowledge the peer
+			 * Send an ACK to acknowledge the peer. ACK
+			 * immediately if this may fill a hole.
 			 */
 			c->peer_seq += data_size;
-			c->ack_flag++;
+			mtk_tcp_rx_stats(c, data_size);
+
+			if (list_empty(&c->ooo_head))
+				mtk_tcp_ack_delayed(c);
+			else
+				c->ack_flag++;
 
 			cbd.status = MTK_TCP_CB_DATA_RCVD;
 			cbd.data = data;
 			cbd.datalen = data_size;
 			assert((size_t)c->cb > gd->ram_base);
 			c->cb(&cbd);
+
+			if (!mtk_tcp_conn_exists(c))
+				return true;
+
+			if (!mtk_tcp_ooo_deliver(c, &cbd, &flags))
+				return true;
 		}
 
 		if (flags & MTK_TCP_FIN) {
@@ -706,19 +1055,6 @@ bool mtk_receive_tcp(struct ip_hdr *ip, int len, struct ethernet_hdr *et)
 	return true;
 }
 
-static void mtk_tcp_rexmit_init(struct mtk_tcp_conn *c)
-{
-	c->ts_rexmit = get_timer(0);
-	c->ts = get_timer(0);
-	c->num_rexmit = 0;
-}
-
-static void mtk_tcp_rexmit_reset(struct mtk_tcp_conn *c)
-{
-	c->ts = get_timer(0);
-	c->num_rexmit++;
-}
-
 static int mtk_tcp_rexmit_check(struct mtk_tcp_conn *c, struct mtk_tcp_cb_data *cbd)
 {
 	ulong curts, timeout;
@@ -811,7 +1147,8 @@ static void mtk_tcp_conn_check(struct mtk_tcp_conn *c)
 	u32 datalen = 0;
 	u8 flags = MTK_TCP_ACK;
 	u32 sendseq;
-	u32 datalen_sent, datalen_acked;
+	u32 datalen_sent, datalen_acked, inflight, wnd;
+	int opt_size;
 	u8 opt[8];
 	struct mtk_tcp_cb_data cbd = {};
 
@@ -827,10 +1164,10 @@ static void mtk_tcp_conn_check(struct mtk_tcp_conn *c)
 	switch (c->status) {
 	case CONNECT:
 		/* send first SYN packet */
-		mtk_tcp_set_mss_opt(opt, c->mss);
+		opt_size = mtk_tcp_set_mss_opt(opt, c->mss, c->rcv_ws);
 
 		mtk_tcp_send_packet_opt(c, MTK_TCP_SYN, c->local_seq,
-					c->peer_seq, opt, sizeof(opt), NULL, 0);
+					c->peer_seq, opt, opt_size, NULL, 0);
 
 		c->ts = get_timer(0);
 		c->ts_rexmit = get_timer(0);
@@ -844,9 +1181,9 @@ static void mtk_tcp_conn_check(struct mtk_tcp_conn *c)
 		case -1:
 			return;
 		case 1:
-			mtk_tcp_set_mss_opt(opt, c->mss);
+			opt_size = mtk_tcp_set_mss_opt(opt, c->mss, c->rcv_ws);
 			mtk_tcp_send_packet_opt(c, MTK_TCP_SYN, c->local_seq,
-						c->peer_seq, opt, sizeof(opt),
+						c->peer_seq, opt, opt_size,
 						NULL, 0);
 			mtk_tcp_connect_rexmit_reset(c);
 		}
@@ -858,99 +1195,101 @@ static void mtk_tcp_conn_check(struct mtk_tcp_conn *c)
 		case -1:
 			return;
 		case 1:
-			mtk_tcp_set_mss_opt(opt, c->mss);
+			opt_size = mtk_tcp_set_mss_opt(opt, c->mss,
+					c->ws_enabled ? c->rcv_ws : -1);
 			mtk_tcp_send_packet_opt(c, MTK_TCP_SYN | MTK_TCP_ACK,
 					    c->local_seq, c->peer_seq + 1,
-					    opt, sizeof(opt), NULL, 0);
+					    opt, opt_size, NULL, 0);
 			mtk_tcp_rexmit_reset(c);
 		}
 
 		break;
 	case ESTABLISHED:
-		sendseq = c->local_seq;
-
 		datalen_sent = mtk_tcp_seq_sub(c->local_seq, c->local_seq_last);
 		datalen_acked = mtk_tcp_seq_sub(c->local_seq_acked,
 					    c->local_seq_last);
 
-		if (!c->rexmit_mode) {
-			if (c->txlen > datalen_sent) {
-				/* There is still data to be sent */
-				data = c->tx + datalen_sent;
-				datalen = min(c->txlen - datalen_sent,
-					      (u32)c->mss);
+		if (datalen_sent > datalen_acked && !c->zw_mode) {
+			/* There is data to be ACKed */
+			switch (mtk_tcp_rexmit_check(c, &cbd)) {
+			case -1:
+				return;
+			case 1:
+				/*
+				 * Timed out waiting for ACK. Collapse the
+				 * congestion window and go back to the first
+				 * unACKed byte.
+				 */
+				mtk_tcp_cwnd_loss(c, c->mss);
+				c->local_seq = c->local_seq_acked;
+				c->timeouts++;
+				datalen_sent = datalen_acked;
+				mtk_tcp_rexmit_reset(c);
+			}
+		}
+
+		if (c->rexmit_mode && c->txlen > datalen_acked) {
+			/* Fast retransmission of the first unACKed segment */
+			c->rexmit_mode = 0;
+			c->ack_calc_rtt = 0;
+
+			mtk_tcp_send_packet(c, flags, c->local_seq_acked,
+					    c->peer_seq, c->tx + datalen_acked,
+					    min(c->txlen - datalen_acked,
+						(u32)c->mss));
+		}
+
+		/* Send as much new data as the windows allow */
+		while (!c->zw_mode && c->txlen > datalen_sent) {
+			inflight = datalen_sent - datalen_acked;
+			wnd = min(c->cwnd, c->peer_wnd);
+			datalen = min(c->txlen - datalen_sent, (u32)c->mss);
 
-				if (datalen >= c->peer_wnd) {
+			if (inflight + datalen > wnd) {
+				if (!inflight && datalen > c->peer_wnd) {
 					/* The peer may be zero-window */
-					if (!c->zw_mode)
-						mtk_tcp_rexmit_init(c);
-					/* Enter zero-window mode */
-					c->zw_mode = 1;
-					/* And send no data */
-					datalen = 0;
-				} else {
-					c->local_seq += datalen;
-					c->peer_wnd -= datalen;
-					c->ack_flag++;
-					if (datalen == c->txlen - datalen_sent)
-						flags |= MTK_TCP_PSH;
 					mtk_tcp_rexmit_init(c);
+					c->zw_mode = 1;
 				}
-			} else if (c->txlen > datalen_acked) {
-				/* There is data to be ACKed */
-				switch (mtk_tcp_rexmit_check(c, &cbd)) {
-				case -1:
-					return;
-				case 1:
-					/*
-					 * Timed out waiting for ACK, entering
-					 * retransmission mode
-					 */
-					c->rexmit_mode = 1;
-					c->rexmit_wait_ack = 0;
-				}
+
+				break;
 			}
-		}
 
-		if (c->rexmit_mode) {
-			if (c->rexmit_wait_ack) {
-				switch (mtk_tcp_rexmit_check(c, &cbd)) {
-				case -1:
-					return;
-				case 1:
-					/*
-					 * Timed out waiting for ACK of
-					 * retransmitted segment, start for
-					 * the next trial
-					 */
-					c->rexmit_wait_ack = 0;
-				}
+			/*
+			 * Start retransmission timer for a new flight. Going
+			 * back after a timeout keeps the timer and its backoff
+			 */
+			if (!inflight && !c->num_rexmit)
+				mtk_tcp_rexmit_init(c);
+
+			if (!c->ack_calc_rtt) {
+				/* Start calculating RTO */
+				c->ack_calc_rtt = c->local_seq + datalen;
+				c->ts_rtt = get_timer(0);
 			}
 
-			if (!c->rexmit_wait_ack) {
-				sendseq = c->local_seq_acked;
+			flags = MTK_TCP_ACK;
+			if (datalen == c->txlen - datalen_sent)
+				flags |= MTK_TCP_PSH;
 
-				if (!c->zw_mode) {
-					/*
-					 * Send data if not in zero-window mode
-					 */
-					data = c->tx + datalen_acked;
-					datalen = min(c->txlen - datalen_acked,
-						      (u32)c->mss);
-					c->ack_flag++;
-					c->rexmit_wait_ack = 1;
-					mtk_tcp_rexmit_reset(c);
-				}
+			mtk_tcp_send_packet(c, flags, c->local_seq,
+					    c->peer_seq, c->tx + datalen_sent,
+					    datalen);
 
-				if (get_timer(c->ts_rtt) > MTK_TCP_RTT_INTERVAL) {
-					/* Start calculating RTO */
-					c->ack_calc_rtt = c->local_seq_acked +
-							  datalen;
-					c->ts_rtt = get_timer(0);
-				}
-			}
+			c->local_seq += datalen;
+			c->tx_bytes += datalen;
+			datalen_sent += datalen;
+			c->ack_flag = 0;
+
+			/* Only one packet can wait for ARP resolution */
+			if (!memcmp(c->ethaddr, net_null_ethaddr, 6))
+				break;
 		}
 
+		datalen = 0;
+		flags = MTK_TCP_ACK;
+		sendseq = c->local_seq;
+
 		if (!c->peer_wnd || c->zw_mode) {
 			if (!c->zw_mode) {
 				/* Enter zero-window mode */
@@ -979,6 +1318,11 @@ static void mtk_tcp_conn_check(struct mtk_tcp_conn *c)
 			}
 		}
 
+		/* Delayed ACK timed out */
+		if (c->delack_segs &&
+		    get_timer(c->ts_delack) >= MTK_TCP_DELACK_TIMEOUT)
+			c->ack_flag++;
+
 		if (c->ack_flag) {
 			c->ack_flag = 0;
 			mtk_tcp_send_packet(c, flags, sendseq, c->peer_seq,
@@ -1091,7 +1435,7 @@ static int mtk_tcp_send_packet_opt(struct mtk_tcp_conn *c, u16 flags, u32 seq, u
 		MTK_TCP_HDR_LEN_SHIFT) | (flags & MTK_TCP_FLAG_MASK));
 	memcpy(&tcp->seq, &seq, 4);
 	memcpy(&tcp->ack, &ack, 4);
-	tcp->wnd = htons(c->mss);
+	tcp->wnd = htons(mtk_tcp_wnd_field(c, flags));
 	/* avoid compiler's optimization leading to an unaligned access */
 	memset(&tcp->urg, 0, sizeof(tcp->urg));
 	tcp->chksum = 0;
@@ -1110,6 +1454,10 @@ static int mtk_tcp_send_packet_opt(struct mtk_tcp_conn *c, u16 flags, u32 seq, u
 
 	pkt_hdr_size = eth_hdr_size + IP_HDR_SIZE + MTK_TCP_HDR_SIZE + opt_size;
 
+	/* Any segment carrying ACK acknowledges all data received so far */
+	if (flags & MTK_TCP_ACK)
+		c->delack_segs = 0;
+
 	/* if MAC address was not discovered yet, do an ARP request */
 	if (memcmp(c->ethaddr, net_null_ethaddr, 6) == 0) {
 		/* save the ip and eth addr for the packet to send after arp */
@@ -1230,3 +1578,46 @@ int mtk_tcp_conn_is_alive(const void *conn)
 
 	return c->status == ESTABLISHED;
 }
+
+int mtk_tcp_conn_get_stats(const void *conn, struct mtk_tcp_conn_stats *st)
+{
+	struct mtk_tcp_conn *c = (struct mtk_tcp_conn *)conn;
+
+	if (!c || !st)
+		return -EINVAL;
+
+	st->srtt = c->srtt;
+	st->rttvar = c->rttvar;
+	st->rto = c->rto;
+	st->rcv_wnd = min(c->rcv_wnd, (u32)0xffff << c->rcv_ws);
+	st->ooo_segs = c->ooo_segs;
+	st->cwnd = c->cwnd;
+	st->fast_rexmits = c->fast_rexmits;
+	st->timeouts = c->timeouts;
+	st->rx_bytes = c->rx_bytes;
+	st->tx_bytes = c->tx_bytes;
+	st->rx_time = c->ts_rx_last - c->ts_rx_start;
+
+	return 0;
+}
+
+void mtk_tcp_conn_print_stats(const void *conn)
+{
+	struct mtk_tcp_conn_stats st;
+	u64 rate;
+
+	if (mtk_tcp_conn_get_stats(conn, &st))
+		return;
+
+	rate = st.rx_bytes * 1000;
+	do_div(rate, st.rx_time ? st.rx_time : 1);
+
+	printf("    %llu bytes received in %lu ms (", st.rx_bytes, st.rx_time);
+	print_size(rate, "/s");
+	printf("), srtt %u ms, rto %u ms, rwnd %u, ooo %u\n", st.srtt, st.rto,
+	       st.rcv_wnd, st.ooo_segs);
+
+	if (st.tx_bytes)
+		printf("    %llu bytes sent, cwnd %u, fast rexmit %u, timeout %u\n",
+		       st.tx_bytes, st.cwnd, st.fast_rexmits, st.timeouts);
+}
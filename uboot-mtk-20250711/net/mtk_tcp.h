@@ -51,7 +51,17 @@ struct mtk_tcp_hdr {
 #define MTK_TCP_RTT_K			4
 #define MTK_TCP_RTT_ALPHA			3
 #define MTK_TCP_RTT_BETA			2
-#define MTK_TCP_RTT_INTERVAL		3000
+
+/* TCP receive window options */
+#define MTK_TCP_RCV_WND			CONFIG_MTK_TCP_RCV_WND
+#define MTK_TCP_MAX_WS			14
+#define MTK_TCP_DELACK_SEGS		2
+#define MTK_TCP_DELACK_TIMEOUT		20
+
+/* TCP congestion control options */
+#define MTK_TCP_INIT_CWND		10
+#define MTK_TCP_MAX_CWND		(1 << 20)
+#define MTK_TCP_DUPACK_THRESH		3
 
 /* TCP retransmission options */
 #define MTK_TCP_CONNECT_INIT_DELAY	500
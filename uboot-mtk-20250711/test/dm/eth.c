@@ -234,6 +234,44 @@ static int dm_test_eth_prime(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_eth_prime, UTF_SCAN_FDT);
 
+static int dm_test_eth_keepalive(struct unit_test_state *uts)
+{
+	char *argv[] = { "ping", "1.1.2.2" };
+	const struct eth_keepalive *ka;
+
+	env_set("ethact", "eth@10002000");
+	sandbox_eth_set_keepalive(0, true);
+	ka = sandbox_eth_get_keepalive(0);
+	ut_assertnonnull(ka);
+
+	/* Only the first command initializes the controller fully */
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_asserteq(1, ka->full_starts);
+	ut_asserteq(2, ka->quick_starts);
+	ut_asserteq(ETH_KEEPALIVE_IDLE, ka->state);
+
+	/* Link loss between commands requires full initialization again */
+	sandbox_eth_link_flap(0);
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_asserteq(2, ka->full_starts);
+	ut_asserteq(3, ka->quick_starts);
+
+	/* Without keep-alive every command initializes it fully */
+	sandbox_eth_set_keepalive(0, false);
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_assertok(do_ping(NULL, 0, ARRAY_SIZE(argv), argv));
+	ut_asserteq(2, ka->full_starts);
+	ut_asserteq(0, ka->quick_starts);
+
+	env_set("ethact", NULL);
+
+	return 0;
+}
+DM_TEST(dm_test_eth_keepalive, UTF_SCAN_FDT);
+
 /**
  * This test case is trying to test the following scenario:
  *	- All ethernet devices are not probed
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Tests for the MediaTek SD/MMC DMA descriptor helpers
+ *
+ * The descriptors are consumed by a small model of the MSDC DMA engine which
+ * walks the GPD/BD chain the way the controller does and fills the buffers
+ * with a known pattern.
+ */
+
+#include <malloc.h>
+#include <dm/test.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+#include <test/ut.h>
+
+#include "../../drivers/mmc/mtk-sd-dma.h"
+
+#define MODEL_BUS_BASE		0x40000000ULL
+#define MODEL_MEM_SIZE		SZ_256K
+#define MODEL_MAX_BD		8
+#define MODEL_BUF_OFFSET	SZ_4K
+
+struct msdc_dma_model {
+	u8 *mem;
+	u64 base;
+	u32 size;
+};
+
+static void *model_ptr(struct msdc_dma_model *m, u64 addr, u32 len)
+{
+	if (addr < m->base || addr + len > m->base + m->size)
+		return NULL;
+
+	return m->mem + (addr - m->base);
+}
+
+static u8 model_pattern(u32 offset)
+{
+	return (offset * 7 + 1) & 0xff;
+}
+
+static void model_fill(u8 *p, u32 offset, u32 len)
+{
+	u32 i;
+
+	for (i = 0; i < len; i++)
+		p[i] = model_pattern(offset + i);
+}
+
+/* Run one read transfer, returns the number of bytes transferred */
+static int model_run(struct msdc_dma_model *m,
+		     const struct msdc_dma_regs *regs)
+{
+	struct msdc_gpd *gpd, *null_gpd;
+	struct msdc_bd *bd;
+	u32 total = 0, nbd = 0, len;
+	u64 addr;
+	u8 *p;
+
+	addr = ((u64)regs->sa_high4bit << 32) | regs->sa;
+
+	if (!(regs->ctrl & MSDC_DMA_CTRL_MODE)) {
+		/* Basic DMA: a single buffer of dma_length bytes */
+		if (!(regs->ctrl & MSDC_DMA_CTRL_LASTBUF))
+			return -EINVAL;
+
+		p = model_ptr(m, addr, regs->length);
+		if (!p)
+			return -EFAULT;
+
+		model_fill(p, 0, regs->length);
+		return regs->length;
+	}
+
+	gpd = model_ptr(m, addr, sizeof(*gpd));
+	if (!gpd)
+		return -EFAULT;
+
+	if (!(gpd->gpd_info & GPDMA_DESC_HWO) ||
+	    !(gpd->gpd_info & GPDMA_DESC_BDP))
+		return -EPERM;
+
+	if ((regs->cfg & MSDC_DMA_CFG_DECSEN) &&
+	    msdc_dma_checksum(gpd, MSDC_DESC_CHECKSUM_LEN))
+		return -EBADMSG;
+
+	addr = ((u64)((gpd->gpd_info & GPDMA_DESC_PTR_H4_M) >>
+		      GPDMA_DESC_PTR_H4_S) << 32) | gpd->ptr;
+
+	while (1) {
+		if (++nbd > MODEL_MAX_BD)
+			return -ELOOP;
+
+		bd = model_ptr(m, addr, sizeof(*bd));
+		if (!bd)
+			return -EFAULT;
+
+		if ((regs->cfg & MSDC_DMA_CFG_DECSEN) &&
+		    msdc_dma_checksum(bd, MSDC_DESC_CHECKSUM_LEN))
+			return -EBADMSG;
+
+		len = bd->bd_data_len & BDMA_DESC_BUFLEN_M;
+		addr = ((u64)((bd->bd_info & BDMA_DESC_PTR_H4_M) >>
+			      BDMA_DESC_PTR_H4_S) << 32) | bd->ptr;
+
+		p = model_ptr(m, addr, len);
+		if (!p)
+			return -EFAULT;
+
+		model_fill(p, total, len);
+		total += len;
+
+		if (bd->bd_info & BDMA_DESC_EOL)
+			break;
+
+		addr = ((u64)((bd->bd_info & BDMA_DESC_NEXT_H4_M) >>
+			      BDMA_DESC_NEXT_H4_S) << 32) | bd->next;
+	}
+
+	/* Give the GPD back and make sure the chain ends at the null GPD */
+	gpd->gpd_info &= ~GPDMA_DESC_HWO;
+
+	addr = ((u64)((gpd->gpd_info & GPDMA_DESC_NEXT_H4_M) >>
+		      GPDMA_DESC_NEXT_H4_S) << 32) | gpd->next;
+	null_gpd = model_ptr(m, addr, sizeof(*null_gpd));
+	if (!null_gpd || (null_gpd->gpd_info & GPDMA_DESC_HWO))
+		return -EFAULT;
+
+	return total;
+}
+
+static int model_check(struct unit_test_state *uts, const u8 *p, u32 len)
+{
+	u32 i;
+
+	for (i = 0; i < len; i++)
+		ut_asserteq(model_pattern(i), p[i]);
+
+	return 0;
+}
+
+static int model_init(struct msdc_dma_model *m, struct msdc_dma *dma)
+{
+	m->mem = malloc(MODEL_MEM_SIZE);
+	if (!m->mem)
+		return -ENOMEM;
+
+	m->base = MODEL_BUS_BASE;
+	m->size = MODEL_MEM_SIZE;
+
+	msdc_dma_init_desc(dma, m->mem, m->base, MODEL_MAX_BD);
+
+	return 0;
+}
+
+/* Test that a multi-BD transfer is described and consumed correctly */
+static int dm_test_mtk_sd_dma_desc(struct unit_test_state *uts)
+{
+	u32 size = 3 * MSDC_BD_MAX_LEN + 512;
+	u64 buf = MODEL_BUS_BASE + MODEL_BUF_OFFSET;
+	struct msdc_dma_regs regs;
+	struct msdc_dma_model m;
+	struct msdc_dma dma;
+	u32 i;
+
+	ut_assertok(model_init(&m, &dma));
+	ut_assert(msdc_dma_desc_size(MODEL_MAX_BD) <= MODEL_BUF_OFFSET);
+
+	ut_assertok(msdc_dma_build_desc(&dma, buf, size, &regs));
+
+	ut_asserteq(lower_32_bits(dma.gpd_addr), regs.sa);
+	ut_asserteq(0, regs.sa_high4bit);
+	ut_asserteq(MSDC_DMA_CTRL_MODE |
+		    (MSDC_BURST_64B << MSDC_DMA_CTRL_BURSTSZ_S), regs.ctrl);
+	ut_asserteq(MSDC_DMA_CFG_DECSEN, regs.cfg);
+
+	ut_asserteq(0, msdc_dma_checksum(&dma.gpd[0], MSDC_DESC_CHECKSUM_LEN));
+
+	for (i = 0; i < 4; i++) {
+		ut_asserteq(0, msdc_dma_checksum(&dma.bd[i],
+						 MSDC_DESC_CHECKSUM_LEN));
+		ut_asserteq(lower_32_bits(buf + i * MSDC_BD_MAX_LEN),
+			    dma.bd[i].ptr);
+		ut_asserteq(i < 3 ? MSDC_BD_MAX_LEN : 512,
+			    dma.bd[i].bd_data_len);
+		ut_asserteq(i == 3, dma.bd[i].bd_info & BDMA_DESC_EOL);
+	}
+
+	ut_asserteq(size, model_run(&m, &regs));
+	ut_assertok(model_check(uts, model_ptr(&m, buf, size), size));
+
+	/* A shorter transfer reuses the table and moves EOL forward */
+	memset(model_ptr(&m, buf, size), 0, size);
+	ut_assertok(msdc_dma_build_desc(&dma, buf, 1024, &regs));
+	ut_asserteq(BDMA_DESC_EOL, dma.bd[0].bd_info & BDMA_DESC_EOL);
+	ut_asserteq(1024, model_run(&m, &regs));
+	ut_assertok(model_check(uts, model_ptr(&m, buf, 1024), 1024));
+	ut_asserteq(0, *(u8 *)model_ptr(&m, buf + 1024, 1));
+
+	/* The engine rejects a descriptor with a stale checksum */
+	ut_assertok(msdc_dma_build_desc(&dma, buf, 2 * MSDC_BD_MAX_LEN, &regs));
+	dma.bd[1].bd_data_len = 512;
+	ut_asserteq(-EBADMSG, model_run(&m, &regs));
+
+	free(m.mem);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_sd_dma_desc, 0);
+
+/* Test basic DMA register values */
+static int dm_test_mtk_sd_dma_basic(struct unit_test_state *uts)
+{
+	u64 buf = MODEL_BUS_BASE + MODEL_BUF_OFFSET;
+	struct msdc_dma_regs regs;
+	struct msdc_dma_model m;
+	struct msdc_dma dma;
+
+	ut_assertok(model_init(&m, &dma));
+
+	ut_assertok(msdc_dma_build_basic(buf, 8192, &regs));
+	ut_asserteq(lower_32_bits(buf), regs.sa);
+	ut_asserteq(8192, regs.length);
+	ut_asserteq(0, regs.ctrl & MSDC_DMA_CTRL_MODE);
+	ut_asserteq(MSDC_DMA_CTRL_LASTBUF, regs.ctrl & MSDC_DMA_CTRL_LASTBUF);
+
+	ut_asserteq(8192, model_run(&m, &regs));
+	ut_assertok(model_check(uts, model_ptr(&m, buf, 8192), 8192));
+
+	/* Bits 35:32 of the address go to DMA_SA_HIGH4BIT */
+	ut_assertok(msdc_dma_build_basic(0x812345000ULL, 512, &regs));
+	ut_asserteq(0x8, regs.sa_high4bit);
+	ut_asserteq(0x12345000, regs.sa);
+
+	free(m.mem);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_sd_dma_basic, 0);
+
+/* Test the conditions under which the driver falls back to PIO */
+static int dm_test_mtk_sd_dma_fallback(struct unit_test_state *uts)
+{
+	struct msdc_dma_regs regs;
+	struct msdc_dma_model m;
+	struct msdc_dma dma;
+
+	ut_assert(msdc_dma_capable(0x40001000, 512, 64));
+	ut_assert(!msdc_dma_capable(0x40001004, 512, 64));
+	ut_assert(!msdc_dma_capable(0x40001000, 520, 64));
+	ut_assert(!msdc_dma_capable(0x40001000, 0, 64));
+	ut_assert(msdc_dma_capable(MSDC_DMA_ADDR_LIMIT - 512, 512, 64));
+	ut_assert(!msdc_dma_capable(MSDC_DMA_ADDR_LIMIT - 512, 1024, 64));
+
+	ut_assertok(model_init(&m, &dma));
+
+	ut_asserteq(-EINVAL, msdc_dma_build_desc(&dma, MODEL_BUS_BASE, 0,
+						 &regs));
+	ut_asserteq(-EINVAL, msdc_dma_build_desc(&dma, MSDC_DMA_ADDR_LIMIT,
+						 512, &regs));
+	ut_asserteq(-E2BIG,
+		    msdc_dma_build_desc(&dma, MODEL_BUS_BASE,
+					MODEL_MAX_BD * MSDC_BD_MAX_LEN + 512,
+					&regs));
+	ut_assertok(msdc_dma_build_desc(&dma, MODEL_BUS_BASE,
+					MODEL_MAX_BD * MSDC_BD_MAX_LEN,
+					&regs));
+	ut_asserteq(-EINVAL, msdc_dma_build_basic(MSDC_DMA_ADDR_LIMIT, 512,
+						  &regs));
+	ut_assertok(msdc_dma_build_basic(0, MSDC_DMA_BASIC_MAX_LEN, &regs));
+	ut_asserteq(MSDC_DMA_BASIC_MAX_LEN, regs.length);
+	ut_asserteq(-EINVAL,
+		    msdc_dma_build_basic(0, MSDC_DMA_BASIC_MAX_LEN + 64,
+					 &regs));
+
+	free(m.mem);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_sd_dma_fallback, 0);
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Tests for the MediaTek SPI-NAND page read DMA destination selection
+ *
+ * Page reads are served by a small model of the NFI DMA engine in auto
+ * format mode: the main data is transferred to the DMA destination while the
+ * FDM bytes land in the spare area of the page cache, as mtk_snand_read_fdm()
+ * does. Like on the real flash, the bad block marker position of the main
+ * data and the first FDM byte of the last sector are swapped on the media.
+ */
+
+#include <malloc.h>
+#include <dm/test.h>
+#include <linux/kernel.h>
+#include <test/ut.h>
+
+#include "../../drivers/mtd/mtk-snand/mtk-snand-def.h"
+
+#define MODEL_SECTOR_SIZE	512
+#define MODEL_ECC_STEPS		4
+#define MODEL_FDM_SIZE		8
+#define MODEL_SPARE_SIZE	16
+#define MODEL_PAGE_SIZE		(MODEL_SECTOR_SIZE * MODEL_ECC_STEPS)
+#define MODEL_OOB_SIZE		(MODEL_SPARE_SIZE * MODEL_ECC_STEPS)
+#define MODEL_GUARD		64
+#define MODEL_POISON		0xa5
+
+struct snand_dma_model {
+	struct mtk_snand_soc_data soc;
+	struct mtk_snand snf;
+
+	/* Page and FDM as written by the host */
+	u8 data[MODEL_PAGE_SIZE];
+	u8 fdm[MODEL_FDM_SIZE * MODEL_ECC_STEPS];
+
+	/* Number of DMA transfers */
+	u32 xfers;
+};
+
+static u32 model_buf_bbm_pos(void)
+{
+	return MODEL_PAGE_SIZE - (MODEL_ECC_STEPS - 1) * MODEL_SPARE_SIZE;
+}
+
+static u32 model_fdm_bbm_pos(void)
+{
+	return (MODEL_ECC_STEPS - 1) * MODEL_FDM_SIZE;
+}
+
+static int model_init(struct snand_dma_model *m)
+{
+	u32 i;
+
+	memset(m, 0, sizeof(*m));
+
+	m->soc.sector_size = MODEL_SECTOR_SIZE;
+	m->soc.fdm_size = MODEL_FDM_SIZE;
+	m->soc.bbm_swap = true;
+
+	m->snf.nfi_soc = &m->soc;
+	m->snf.writesize = MODEL_PAGE_SIZE;
+	m->snf.oobsize = MODEL_OOB_SIZE;
+	m->snf.ecc_steps = MODEL_ECC_STEPS;
+	m->snf.spare_per_sector = MODEL_SPARE_SIZE;
+
+	m->snf.page_cache = memalign(ARCH_DMA_MINALIGN,
+				     MODEL_PAGE_SIZE + MODEL_OOB_SIZE);
+	if (!m->snf.page_cache)
+		return -ENOMEM;
+
+	for (i = 0; i < MODEL_PAGE_SIZE; i++)
+		m->data[i] = (i * 7 + 1) & 0xff;
+
+	for (i = 0; i < sizeof(m->fdm); i++)
+		m->fdm[i] = 0x80 | i;
+
+	return 0;
+}
+
+/* Transfer the page in auto format to @dest, and the FDM to the page cache */
+static void model_dma(struct snand_dma_model *m, u8 *dest)
+{
+	u8 *oob = m->snf.page_cache + MODEL_PAGE_SIZE;
+
+	memcpy(dest, m->data, MODEL_PAGE_SIZE);
+	memcpy(oob, m->fdm, sizeof(m->fdm));
+
+	dest[model_buf_bbm_pos()] = m->fdm[model_fdm_bbm_pos()];
+	oob[model_fdm_bbm_pos()] = m->data[model_buf_bbm_pos()];
+
+	m->xfers++;
+}
+
+/* Read a page the way mtk_snand_do_read_page() does */
+static u8 *model_read(struct snand_dma_model *m, u8 *buf)
+{
+	u8 *data = mtk_snand_rx_buf(&m->snf, buf, false);
+
+	model_dma(m, data);
+	mtk_snand_bm_swap(&m->snf, data);
+
+	if (buf != data)
+		memcpy(buf, data, MODEL_PAGE_SIZE);
+
+	return data;
+}
+
+static int model_check(struct unit_test_state *uts, struct snand_dma_model *m,
+		       const u8 *buf)
+{
+	const u8 *oob = m->snf.page_cache + MODEL_PAGE_SIZE;
+
+	ut_asserteq_mem(m->data, buf, MODEL_PAGE_SIZE);
+	ut_asserteq_mem(m->fdm, oob, sizeof(m->fdm));
+
+	return 0;
+}
+
+/* Test the alignment and address rules of DMA destinations */
+static int dm_test_mtk_snand_dma_capable(struct unit_test_state *uts)
+{
+	ut_assert(mtk_snand_dma_capable(0x40001000, 2048));
+	ut_assert(!mtk_snand_dma_capable(0x40001004, 2048));
+	ut_assert(!mtk_snand_dma_capable(0x40001000, 2047));
+	ut_assert(!mtk_snand_dma_capable(0x40001000, 0));
+	ut_assert(mtk_snand_dma_capable(SNFI_DMA_ADDR_LIMIT - 2048, 2048));
+	ut_assert(!mtk_snand_dma_capable(SNFI_DMA_ADDR_LIMIT - 1024, 2048));
+	ut_assert(!mtk_snand_dma_capable(SNFI_DMA_ADDR_LIMIT, 2048));
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_dma_capable, 0);
+
+/* Test that an aligned buffer is the DMA destination itself */
+static int dm_test_mtk_snand_dma_direct(struct unit_test_state *uts)
+{
+	struct snand_dma_model m;
+	u8 *buf;
+	u32 i;
+
+	ut_assertok(model_init(&m));
+
+	buf = memalign(ARCH_DMA_MINALIGN, MODEL_PAGE_SIZE + MODEL_GUARD);
+	ut_assertnonnull(buf);
+
+	/* The sandbox RAM is normally mapped below the 32-bit DMA limit */
+	if (!mtk_snand_dma_capable((uintptr_t)buf, MODEL_PAGE_SIZE)) {
+		free(buf);
+		free(m.snf.page_cache);
+		return -EAGAIN;
+	}
+
+	memset(buf, MODEL_POISON, MODEL_PAGE_SIZE + MODEL_GUARD);
+	memset(m.snf.page_cache, MODEL_POISON, MODEL_PAGE_SIZE);
+
+	ut_asserteq_ptr(buf, model_read(&m, buf));
+	ut_asserteq(1, m.xfers);
+	ut_assertok(model_check(uts, &m, buf));
+
+	/* Nothing beyond the page is written, the page cache is not used */
+	for (i = 0; i < MODEL_GUARD; i++)
+		ut_asserteq(MODEL_POISON, buf[MODEL_PAGE_SIZE + i]);
+
+	for (i = 0; i < MODEL_PAGE_SIZE; i++)
+		ut_asserteq(MODEL_POISON, m.snf.page_cache[i]);
+
+	/* Without bad block marker swapping the data is taken as is */
+	m.soc.bbm_swap = false;
+	model_dma(&m, buf);
+	mtk_snand_bm_swap(&m.snf, buf);
+	ut_asserteq(m.fdm[model_fdm_bbm_pos()], buf[model_buf_bbm_pos()]);
+
+	free(buf);
+	free(m.snf.page_cache);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_dma_direct, 0);
+
+/* Test the cases in which the page cache is used as bounce buffer */
+static int dm_test_mtk_snand_dma_bounce(struct unit_test_state *uts)
+{
+	struct snand_dma_model m;
+	u8 *buf, *unaligned;
+
+	ut_assertok(model_init(&m));
+
+	buf = memalign(ARCH_DMA_MINALIGN, MODEL_PAGE_SIZE + MODEL_GUARD);
+	ut_assertnonnull(buf);
+
+	/* Raw reads need the spare area interleaved with the data */
+	ut_asserteq_ptr(m.snf.page_cache, mtk_snand_rx_buf(&m.snf, buf, true));
+
+	/* Reading only the OOB */
+	ut_asserteq_ptr(m.snf.page_cache, mtk_snand_rx_buf(&m.snf, NULL, false));
+
+	/* An unaligned buffer gets the same data through the page cache */
+	unaligned = buf + 4;
+	memset(buf, MODEL_POISON, MODEL_PAGE_SIZE + MODEL_GUARD);
+
+	ut_asserteq_ptr(m.snf.page_cache, model_read(&m, unaligned));
+	ut_asserteq(1, m.xfers);
+	ut_assertok(model_check(uts, &m, unaligned));
+	ut_asserteq(MODEL_POISON, buf[0]);
+	ut_asserteq(MODEL_POISON, unaligned[MODEL_PAGE_SIZE]);
+
+	/* A page size which is not a multiple of the cache line */
+	m.snf.writesize = MODEL_PAGE_SIZE - 1;
+	ut_asserteq_ptr(m.snf.page_cache, mtk_snand_rx_buf(&m.snf, buf, false));
+
+	free(buf);
+	free(m.snf.page_cache);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_dma_bounce, 0);
@@ -0,0 +1,365 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Tests for the MediaTek SPI-NAND multi-page read sequencing
+ *
+ * The commands are issued to a small model of a SPI-NAND chip which tracks
+ * the page held by the data register and the cache, and whether the chip is
+ * busy or in cache read mode. Every command issued out of order is counted
+ * as a violation.
+ */
+
+#include <dm/test.h>
+#include <linux/kernel.h>
+#include <test/ut.h>
+
+#include "../../drivers/mtd/mtk-snand/mtk-snand-def.h"
+
+#define MODEL_PAGES_PER_BLOCK	64
+#define MODEL_MAX_CMDS		80
+#define MODEL_MAX_PAGES		64
+#define MODEL_NO_PAGE		(-1)
+
+struct snand_model {
+	/* Chip state */
+	int data_reg;
+	int cache;
+	bool busy;
+	bool cache_mode;
+
+	/* Command trace */
+	u8 cmds[MODEL_MAX_CMDS];
+	u32 ncmds;
+	u32 violations;
+
+	/* Pages transferred out of the cache, by index */
+	int out[MODEL_MAX_PAGES];
+
+	/* Injected results */
+	int ecc_page;
+	int bitflip_page;
+	int io_err_page;
+};
+
+static void model_init(struct snand_model *m)
+{
+	u32 i;
+
+	memset(m, 0, sizeof(*m));
+
+	m->data_reg = MODEL_NO_PAGE;
+	m->cache = MODEL_NO_PAGE;
+	m->ecc_page = MODEL_NO_PAGE;
+	m->bitflip_page = MODEL_NO_PAGE;
+	m->io_err_page = MODEL_NO_PAGE;
+
+	for (i = 0; i < MODEL_MAX_PAGES; i++)
+		m->out[i] = MODEL_NO_PAGE;
+}
+
+static void model_trace(struct snand_model *m, u8 cmd)
+{
+	if (m->ncmds < MODEL_MAX_CMDS)
+		m->cmds[m->ncmds++] = cmd;
+}
+
+static int model_page_op(void *priv, u32 page, u8 cmd)
+{
+	struct snand_model *m = priv;
+
+	model_trace(m, cmd);
+
+	if (m->busy) {
+		m->violations++;
+		return 0;
+	}
+
+	switch (cmd) {
+	case SNAND_CMD_READ_TO_CACHE:
+		/* Never while caching */
+		if (m->cache_mode) {
+			m->violations++;
+			return 0;
+		}
+
+		m->data_reg = page;
+		m->cache = page;
+		break;
+
+	case SNAND_CMD_READ_CACHE_RANDOM:
+		/* A page must have been loaded */
+		if (m->data_reg == MODEL_NO_PAGE) {
+			m->violations++;
+			return 0;
+		}
+
+		/* Cache takes the data register, the array loads the page */
+		m->cache = m->data_reg;
+		m->data_reg = page;
+		m->cache_mode = true;
+		break;
+
+	default:
+		m->violations++;
+		return 0;
+	}
+
+	m->busy = true;
+
+	return 0;
+}
+
+static int model_cmd(void *priv, u8 cmd)
+{
+	struct snand_model *m = priv;
+
+	model_trace(m, cmd);
+
+	if (m->busy || m->data_reg == MODEL_NO_PAGE) {
+		m->violations++;
+		return 0;
+	}
+
+	switch (cmd) {
+	case SNAND_CMD_READ_CACHE_SEQ:
+		/* The next page must be in the same block */
+		if (!((m->data_reg + 1) % MODEL_PAGES_PER_BLOCK))
+			m->violations++;
+
+		/* Cache takes the data register, the array loads the next */
+		m->cache = m->data_reg;
+		m->data_reg++;
+		m->cache_mode = true;
+		break;
+
+	case SNAND_CMD_READ_CACHE_END:
+		if (!m->cache_mode)
+			m->violations++;
+
+		m->cache = m->data_reg;
+		m->cache_mode = false;
+		break;
+
+	default:
+		m->violations++;
+		return 0;
+	}
+
+	m->busy = true;
+
+	return 0;
+}
+
+static int model_wait_ready(void *priv)
+{
+	struct snand_model *m = priv;
+
+	m->busy = false;
+
+	return 0;
+}
+
+static int model_read_cache(void *priv, u32 page, u32 idx)
+{
+	struct snand_model *m = priv;
+
+	/* The cache must be ready and hold the page asked for */
+	if (m->busy || m->cache != page || idx >= MODEL_MAX_PAGES) {
+		m->violations++;
+		return -EIO;
+	}
+
+	if (m->io_err_page == page)
+		return -EIO;
+
+	m->out[idx] = m->cache;
+
+	if (m->ecc_page == page)
+		return -EBADMSG;
+
+	if (m->bitflip_page == page)
+		return 3;
+
+	return 0;
+}
+
+static const struct mtk_snand_seq_ops model_ops = {
+	.page_op = model_page_op,
+	.cmd = model_cmd,
+	.wait_ready = model_wait_ready,
+	.read_cache = model_read_cache,
+};
+
+static int model_check_out(struct unit_test_state *uts, struct snand_model *m,
+			   u32 page, u32 count)
+{
+	u32 i;
+
+	for (i = 0; i < count; i++)
+		ut_asserteq(page + i, m->out[i]);
+
+	return 0;
+}
+
+/* Test the command sequence of a cache read */
+static int dm_test_mtk_snand_seq_cache(struct unit_test_state *uts)
+{
+	static const u8 expected[] = {
+		SNAND_CMD_READ_TO_CACHE,
+		SNAND_CMD_READ_CACHE_SEQ,
+		SNAND_CMD_READ_CACHE_SEQ,
+		SNAND_CMD_READ_CACHE_SEQ,
+		SNAND_CMD_READ_CACHE_SEQ,
+		SNAND_CMD_READ_CACHE_END,
+	};
+	struct snand_model m;
+
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read(&model_ops, &m, 130, 5, true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(ARRAY_SIZE(expected), m.ncmds);
+	ut_asserteq_mem(expected, m.cmds, sizeof(expected));
+	ut_assertok(model_check_out(uts, &m, 130, 5));
+	ut_assert(!m.cache_mode);
+
+	/* Up to the last page of a block */
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read(&model_ops, &m, 64, 64, true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(65, m.ncmds);
+	ut_assert(!m.cache_mode);
+
+	/* A single page needs no cache read */
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read(&model_ops, &m, 7, 1, true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(1, m.ncmds);
+	ut_asserteq(SNAND_CMD_READ_TO_CACHE, m.cmds[0]);
+	ut_assertok(model_check_out(uts, &m, 7, 1));
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_seq_cache, 0);
+
+/* Test that chips without cache read get one READ TO CACHE per page */
+static int dm_test_mtk_snand_seq_plain(struct unit_test_state *uts)
+{
+	struct snand_model m;
+	u32 i;
+
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read(&model_ops, &m, 20, 4, false));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(4, m.ncmds);
+
+	for (i = 0; i < 4; i++)
+		ut_asserteq(SNAND_CMD_READ_TO_CACHE, m.cmds[i]);
+
+	ut_assertok(model_check_out(uts, &m, 20, 4));
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_seq_plain, 0);
+
+/* Test ECC results and aborting a cache read */
+static int dm_test_mtk_snand_seq_errors(struct unit_test_state *uts)
+{
+	struct snand_model m;
+
+	/* Bitflips are reported as the maximum of all pages */
+	model_init(&m);
+	m.bitflip_page = 11;
+
+	ut_asserteq(3, mtk_snand_seq_read(&model_ops, &m, 10, 4, true));
+	ut_asserteq(0, m.violations);
+	ut_assertok(model_check_out(uts, &m, 10, 4));
+
+	/* Reading goes on after uncorrectable pages */
+	model_init(&m);
+	m.ecc_page = 11;
+	m.bitflip_page = 12;
+
+	ut_asserteq(-EBADMSG, mtk_snand_seq_read(&model_ops, &m, 10, 4, true));
+	ut_asserteq(0, m.violations);
+	ut_assertok(model_check_out(uts, &m, 10, 4));
+	ut_assert(!m.cache_mode);
+
+	/* Other errors abort, and the chip is taken out of cache read */
+	model_init(&m);
+	m.io_err_page = 11;
+
+	ut_asserteq(-EIO, mtk_snand_seq_read(&model_ops, &m, 10, 4, true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(10, m.out[0]);
+	ut_asserteq(MODEL_NO_PAGE, m.out[2]);
+	ut_asserteq(SNAND_CMD_READ_CACHE_END, m.cmds[m.ncmds - 1]);
+	ut_assert(!m.cache_mode);
+	ut_assert(!m.busy);
+
+	/* A fresh sequence can be started afterwards */
+	ut_assertok(mtk_snand_seq_read(&model_ops, &m, 40, 2, true));
+	ut_asserteq(0, m.violations);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_seq_errors, 0);
+
+/* Test the command sequence of a cache read of a page list */
+static int dm_test_mtk_snand_seq_list(struct unit_test_state *uts)
+{
+	static const u32 pages[] = { 64, 3, 200, 201, 1000 };
+	static const u8 expected[] = {
+		SNAND_CMD_READ_TO_CACHE,
+		SNAND_CMD_READ_CACHE_RANDOM,
+		SNAND_CMD_READ_CACHE_RANDOM,
+		SNAND_CMD_READ_CACHE_RANDOM,
+		SNAND_CMD_READ_CACHE_RANDOM,
+		SNAND_CMD_READ_CACHE_END,
+	};
+	struct snand_model m;
+	u32 i;
+
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read_list(&model_ops, &m, pages,
+					    ARRAY_SIZE(pages), true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(ARRAY_SIZE(expected), m.ncmds);
+	ut_asserteq_mem(expected, m.cmds, sizeof(expected));
+	ut_assert(!m.cache_mode);
+
+	for (i = 0; i < ARRAY_SIZE(pages); i++)
+		ut_asserteq(pages[i], m.out[i]);
+
+	/* Without cache read every page is loaded on its own */
+	model_init(&m);
+
+	ut_assertok(mtk_snand_seq_read_list(&model_ops, &m, pages,
+					    ARRAY_SIZE(pages), false));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(ARRAY_SIZE(pages), m.ncmds);
+
+	for (i = 0; i < ARRAY_SIZE(pages); i++) {
+		ut_asserteq(SNAND_CMD_READ_TO_CACHE, m.cmds[i]);
+		ut_asserteq(pages[i], m.out[i]);
+	}
+
+	/* Errors abort, and the chip is taken out of cache read */
+	model_init(&m);
+	m.io_err_page = 200;
+
+	ut_asserteq(-EIO, mtk_snand_seq_read_list(&model_ops, &m, pages,
+						  ARRAY_SIZE(pages), true));
+	ut_asserteq(0, m.violations);
+	ut_asserteq(3, m.out[1]);
+	ut_asserteq(MODEL_NO_PAGE, m.out[2]);
+	ut_asserteq(SNAND_CMD_READ_CACHE_END, m.cmds[m.ncmds - 1]);
+	ut_assert(!m.cache_mode);
+	ut_assert(!m.busy);
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_snand_seq_list, 0);
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Tests for retransmission and congestion control of the MediaTek TCP stack
+ *
+ * A fake peer injects segments directly into the stack, and segments sent by
+ * the stack are captured from the sandbox Ethernet device. Time is advanced
+ * with the sandbox timer offset.
+ */
+
+#include <dm.h>
+#include <env.h>
+#include <net.h>
+#include <time.h>
+#include <asm/eth.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+#include "../../net/mtk_tcp.h"
+
+#define PEER_PORT		40000
+#define LOCAL_PORT		80
+#define PEER_ISS		1000
+#define PEER_WND		65535
+/* MSS used by the stack if the peer does not send the option */
+#define PEER_MSS		1460
+#define TX_DATA_SIZE		(4 * PEER_MSS)
+#define MAX_SEGS		64
+
+struct tcp_seg_log {
+	u16 flags;
+	u32 seq;
+	u32 len;
+	ulong ts;
+};
+
+static const u8 peer_mac[ARP_HLEN] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 };
+static struct in_addr peer_ip;
+
+static struct tcp_seg_log segs[MAX_SEGS];
+static u32 num_segs;
+
+static u8 tx_data[TX_DATA_SIZE];
+static const void *test_conn;
+static bool conn_closed, conn_timedout;
+
+static int tcp_tx_handler(struct udevice *dev, void *packet, unsigned int len)
+{
+	struct ip_hdr *ip = packet + ETHER_HDR_SIZE;
+	struct mtk_tcp_hdr *tcp;
+	u32 iphdr_len, tcphdr_len;
+	u16 flags;
+
+	if (ip->ip_p != IPPROTO_TCP || num_segs >= MAX_SEGS)
+		return 0;
+
+	iphdr_len = (ip->ip_hl_v & 0x0f) * 4;
+	tcp = (void *)ip + iphdr_len;
+	flags = ntohs(tcp->flags);
+	tcphdr_len = ((flags >> MTK_TCP_HDR_LEN_SHIFT) &
+		      MTK_TCP_HDR_LEN_MASK) * 4;
+
+	segs[num_segs].flags = flags & MTK_TCP_FLAG_MASK;
+	segs[num_segs].seq = ntohl(net_read_u32(&tcp->seq));
+	segs[num_segs].len = ntohs(ip->ip_len) - iphdr_len - tcphdr_len;
+	segs[num_segs].ts = get_timer(0);
+	num_segs++;
+
+	return 0;
+}
+
+static void tcp_conn_cb(struct mtk_tcp_cb_data *cbd)
+{
+	switch (cbd->status) {
+	case MTK_TCP_CB_NEW_CONN:
+		test_conn = cbd->conn;
+		mtk_tcp_send_data(cbd->conn, tx_data, sizeof(tx_data));
+		break;
+	case MTK_TCP_CB_REMOTE_CLOSED:
+	case MTK_TCP_CB_CLOSED:
+		conn_closed = true;
+		conn_timedout = cbd->timedout;
+		test_conn = NULL;
+		break;
+	default:
+		break;
+	}
+}
+
+static u16 tcp_checksum(const void *data, u32 len)
+{
+	struct {
+		__be32 sip;
+		__be32 dip;
+		u8 zero;
+		u8 prot;
+		__be16 len;
+	} phdr = { peer_ip.s_addr, net_ip.s_addr, 0, IPPROTO_TCP, htons(len) };
+	const u16 *p;
+	u32 sum = 0, i;
+
+	for (p = (const u16 *)&phdr, i = 0; i < sizeof(phdr) / 2; i++)
+		sum += p[i];
+
+	for (p = data, i = 0; i < len / 2; i++)
+		sum += p[i];
+
+	if (len & 1)
+		sum += ((const u8 *)data)[len - 1];
+
+	sum = (sum >> 16) + (sum & 0xffff);
+	sum += sum >> 16;
+
+	return ~sum & 0xffff;
+}
+
+/* Inject a segment without payload from the peer */
+static void peer_send(u16 flags, u32 seq, u32 ack, u16 wnd)
+{
+	uchar pkt[ETHER_HDR_SIZE + IP_HDR_SIZE + MTK_TCP_HDR_SIZE];
+	struct ethernet_hdr *et = (void *)pkt;
+	struct ip_hdr *ip = (void *)pkt + ETHER_HDR_SIZE;
+	struct mtk_tcp_hdr *tcp = (void *)ip + IP_HDR_SIZE;
+
+	seq = htonl(seq);
+	ack = htonl(ack);
+
+	memset(pkt, 0, sizeof(pkt));
+	memcpy(et->et_src, peer_mac, ARP_HLEN);
+
+	net_set_ip_header((uchar *)ip, net_ip, peer_ip,
+			  IP_HDR_SIZE + MTK_TCP_HDR_SIZE, IPPROTO_TCP);
+
+	tcp->src = htons(PEER_PORT);
+	tcp->dst = htons(LOCAL_PORT);
+	memcpy(&tcp->seq, &seq, 4);
+	memcpy(&tcp->ack, &ack, 4);
+	tcp->flags = htons(((MTK_TCP_HDR_SIZE / 4) << MTK_TCP_HDR_LEN_SHIFT) |
+			   flags);
+	tcp->wnd = htons(wnd);
+	tcp->chksum = tcp_checksum(tcp, MTK_TCP_HDR_SIZE);
+
+	mtk_receive_tcp(ip, IP_HDR_SIZE + MTK_TCP_HDR_SIZE, et);
+}
+
+static void tcp_test_tick(ulong ms)
+{
+	timer_test_add_offset(ms);
+	mtk_tcp_periodic_check();
+}
+
+/*
+ * Set up the connection and send the first flight, returns local ISS + 1.
+ * The peer completes the handshake only after @synack_rexmits retransmissions
+ * of SYN ACK.
+ */
+static int tcp_test_start(struct unit_test_state *uts, u32 *snd_una,
+			  u32 synack_rexmits)
+{
+	u32 i;
+
+	num_segs = 0;
+	test_conn = NULL;
+	conn_closed = false;
+	conn_timedout = false;
+
+	peer_ip = string_to_ip("1.1.2.4");
+	net_ip = string_to_ip("1.1.2.2");
+
+	sandbox_eth_set_tx_handler(0, tcp_tx_handler);
+	env_set("ethact", "eth@10002000");
+	ut_assertok(net_init());
+	ut_assertok(eth_init());
+
+	mtk_tcp_start();
+	ut_assertok(mtk_tcp_listen(htons(LOCAL_PORT), tcp_conn_cb));
+
+	peer_send(MTK_TCP_SYN, PEER_ISS, 0, PEER_WND);
+	ut_asserteq(1, num_segs);
+	ut_asserteq(MTK_TCP_SYN | MTK_TCP_ACK, segs[0].flags);
+
+	*snd_una = segs[0].seq + 1;
+
+	for (i = 0; i < 100 && num_segs <= synack_rexmits; i++)
+		tcp_test_tick(100);
+
+	ut_asserteq(1 + synack_rexmits, num_segs);
+	ut_asserteq(MTK_TCP_SYN | MTK_TCP_ACK, segs[num_segs - 1].flags);
+
+	peer_send(MTK_TCP_ACK, PEER_ISS + 1, *snd_una, PEER_WND);
+	ut_assertnonnull(test_conn);
+
+	/* The whole buffer fits in the initial windows */
+	tcp_test_tick(1);
+	ut_asserteq(1 + synack_rexmits + TX_DATA_SIZE / PEER_MSS, num_segs);
+
+	return 0;
+}
+
+static void tcp_test_end(void)
+{
+	if (test_conn)
+		mtk_tcp_close_conn(test_conn, 1);
+
+	mtk_tcp_listen_stop(htons(LOCAL_PORT));
+	sandbox_eth_set_tx_handler(0, NULL);
+	eth_halt();
+}
+
+/* A peer which never ACKs must get backed-off retransmissions, then a reset */
+static int dm_test_mtk_tcp_rexmit_backoff(struct unit_test_state *uts)
+{
+	ulong last_ts = 0, interval, last_interval = 0;
+	u32 snd_una, first, i, rexmits = 0;
+	bool rst = false;
+
+	ut_assertok(tcp_test_start(uts, &snd_una, 0));
+	first = num_segs;
+
+	for (i = 0; i < 10000 && !conn_closed; i++)
+		tcp_test_tick(100);
+
+	ut_assert(conn_closed);
+	ut_assert(conn_timedout);
+
+	/* Reset once MTK_TCP_REXMIT_MAX_CONN_DELAY has passed */
+	ut_assert(i <= (MTK_TCP_REXMIT_MAX_CONN_DELAY + 1000) / 100);
+
+	last_ts = segs[first - 1].ts;
+
+	for (i = first; i < num_segs; i++) {
+		if (segs[i].flags & MTK_TCP_RST) {
+			rst = true;
+			continue;
+		}
+
+		/* Only the first unACKed segment is sent again */
+		ut_asserteq(snd_una, segs[i].seq);
+		ut_asserteq(PEER_MSS, segs[i].len);
+
+		/* RTO is doubled on each timeout */
+		interval = segs[i].ts - last_ts;
+		ut_assert(interval >= last_interval);
+
+		last_interval = interval;
+		last_ts = segs[i].ts;
+		rexmits++;
+	}
+
+	ut_assert(rst);
+	ut_assert(last_interval >= MTK_TCP_REXMIT_MAX_SEG_DELAY);
+	ut_assert(rexmits > 5);
+	ut_assert(rexmits < 20);
+
+	tcp_test_end();
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_tcp_rexmit_backoff, UTF_SCAN_FDT);
+
+/* Window updates must not be taken as duplicated ACKs */
+static int dm_test_mtk_tcp_dupack_wnd_update(struct unit_test_state *uts)
+{
+	struct mtk_tcp_conn_stats st;
+	u32 snd_una, first, i;
+
+	ut_assertok(tcp_test_start(uts, &snd_una, 0));
+	first = num_segs;
+
+	for (i = 0; i < MTK_TCP_DUPACK_THRESH; i++)
+		peer_send(MTK_TCP_ACK, PEER_ISS + 1, snd_una,
+			  PEER_WND - 1000 * (i + 1));
+
+	tcp_test_tick(1);
+
+	ut_assertok(mtk_tcp_conn_get_stats(test_conn, &st));
+	ut_asserteq(0, st.fast_rexmits);
+	ut_asserteq(first, num_segs);
+
+	for (i = 0; i < MTK_TCP_DUPACK_THRESH; i++)
+		peer_send(MTK_TCP_ACK, PEER_ISS + 1, snd_una,
+			  PEER_WND - 1000 * MTK_TCP_DUPACK_THRESH);
+
+	tcp_test_tick(1);
+
+	ut_assertok(mtk_tcp_conn_get_stats(test_conn, &st));
+	ut_asserteq(1, st.fast_rexmits);
+	ut_asserteq(first + 1, num_segs);
+	ut_asserteq(snd_una, segs[first].seq);
+
+	tcp_test_end();
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_tcp_dupack_wnd_update, UTF_SCAN_FDT);
+
+/* Backoff of SYN ACK retransmissions must not delay the first data RTO */
+static int dm_test_mtk_tcp_synack_rexmit(struct unit_test_state *uts)
+{
+	u32 snd_una, first, i;
+	ulong flight_ts;
+
+	ut_assertok(tcp_test_start(uts, &snd_una, 2));
+	first = num_segs;
+
+	/* SYN ACK is retransmitted with the initial RTO, then backed off */
+	ut_assert(segs[1].ts - segs[0].ts >= MTK_TCP_CONNECT_INIT_DELAY);
+	ut_assert(segs[2].ts - segs[1].ts >= 2 * MTK_TCP_CONNECT_INIT_DELAY);
+	flight_ts = segs[first - 1].ts;
+
+	for (i = 0; i < 100 && num_segs == first; i++)
+		tcp_test_tick(100);
+
+	ut_asserteq(first + 1, num_segs);
+	ut_asserteq(snd_una, segs[first].seq);
+	ut_assert(segs[first].ts - flight_ts >= MTK_TCP_CONNECT_INIT_DELAY);
+	ut_assert(segs[first].ts - flight_ts <=
+		  MTK_TCP_CONNECT_INIT_DELAY + 100);
+
+	tcp_test_end();
+
+	return 0;
+}
+DM_TEST(dm_test_mtk_tcp_synack_rexmit, UTF_SCAN_FDT);